@@ -43,6 +43,19 @@ class LibWebRTC {
   LIB_WEBRTC_API static scoped_refptr<RTCPeerConnectionFactory>
   CreateRTCPeerConnectionFactory();
 
+  /**
+   * @brief Creates a new WebRTC PeerConnectionFactory with |options|.
+   *
+   * Same as CreateRTCPeerConnectionFactory(), but lets the caller choose the
+   * audio device, e.g. RTCAudioDeviceType::kVirtual for headless servers.
+   *
+   * @return A scoped_refptr object that points to the newly created
+   * RTCPeerConnectionFactory.
+   */
+  LIB_WEBRTC_API static scoped_refptr<RTCPeerConnectionFactory>
+  CreateRTCPeerConnectionFactory(
+      const RTCPeerConnectionFactoryOptions& options);
+
   /**
    * @brief Terminates the WebRTC PeerConnectionFactory and threads.
    *
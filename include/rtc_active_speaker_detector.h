@@ -0,0 +1,66 @@
+#ifndef LIB_WEBRTC_RTC_ACTIVE_SPEAKER_DETECTOR_HXX
+#define LIB_WEBRTC_RTC_ACTIVE_SPEAKER_DETECTOR_HXX
+
+#include "rtc_rtp_receiver.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+/**
+ * Receives ranking changes of an RTCActiveSpeakerDetector. Events are posted
+ * like other observer callbacks, to the factory's RTCEventExecutor or
+ * signaling thread.
+ */
+class RTCActiveSpeakerObserver {
+ public:
+  /**
+   * |speakers| are the receivers that are currently speaking, loudest first,
+   * at most |max_speakers| of them. Empty when everybody is quiet. Wrappers
+   * are new objects; compare receivers by id().
+   */
+  virtual void OnActiveSpeakersChanged(
+      vector<scoped_refptr<RTCRtpReceiver>> speakers) = 0;
+
+ protected:
+  virtual ~RTCActiveSpeakerObserver() {}
+};
+
+/**
+ * Ranks audio receivers by the levels their senders put in the RFC 6464
+ * ssrc-audio-level header extension (see RTCRtpReceiver::audio_level()), so
+ * the ranking itself measures no audio. It does not save decoding: webrtc
+ * records the levels when it plays the packets out, after decoding, so every
+ * ranked receiver is still decoded.
+ *
+ * Levels are polled every |interval_ms|, smoothed with a fast attack and a
+ * slow release, and a receiver has to be about 3 dB louder than a ranked one
+ * to take its place. A receiver whose level stops updating counts as silent.
+ * The observer is only called when the ranking changes.
+ *
+ * Created by RTCPeerConnectionFactory::CreateActiveSpeakerDetector().
+ */
+class RTCActiveSpeakerDetector : public RefCountInterface {
+ public:
+  /**
+   * Starts ranking |receiver|.
+   * @return false if it is not an audio receiver or is already added.
+   */
+  virtual bool AddReceiver(scoped_refptr<RTCRtpReceiver> receiver) = 0;
+
+  /**
+   * Stops ranking |receiver|. The next ranking no longer includes it.
+   */
+  virtual void RemoveReceiver(scoped_refptr<RTCRtpReceiver> receiver) = 0;
+
+  /**
+   * The current ranking, as last sent to the observer.
+   */
+  virtual vector<scoped_refptr<RTCRtpReceiver>> active_speakers() const = 0;
+
+ protected:
+  virtual ~RTCActiveSpeakerDetector() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_ACTIVE_SPEAKER_DETECTOR_HXX
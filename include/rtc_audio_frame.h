@@ -1,108 +1,78 @@
-#ifndef AUDIO_FRAME_HXX
-#define AUDIO_FRAME_HXX
+#ifndef LIB_WEBRTC_RTC_AUDIO_FRAME_HXX
+#define LIB_WEBRTC_RTC_AUDIO_FRAME_HXX
 
-#include "media_manager_types.h"
+#include "rtc_types.h"
 
-namespace b2bua {
+namespace libwebrtc {
 
-class AudioFrame {
+/**
+ * A chunk of interleaved 16-bit PCM audio, normally 10 ms long.
+ *
+ * Frames are recycled through an internal pool: releasing the last reference
+ * returns the frame's storage for the next Create() instead of freeing it, so
+ * pushing audio every 10 ms does not allocate.
+ */
+class RTCAudioFrame : public RefCountInterface {
  public:
   /**
-   * @brief Creates a new instance of AudioFrame.
-   * @return AudioFrame*: a pointer to the newly created AudioFrame.
+   * @brief Returns an empty frame from the pool.
    */
-  MEDIA_MANAGER_API static AudioFrame* Create();
+  LIB_WEBRTC_API static scoped_refptr<RTCAudioFrame> Create();
 
   /**
-   * @brief Creates a new instance of AudioFrame with specified parameters.
-   * @param id: the unique identifier of the frame.
-   * @param timestamp: the timestamp of the frame.
-   * @param data: a pointer to the audio data buffer.
-   * @param samples_per_channel: the number of samples per channel.
+   * @brief Returns a frame from the pool holding a copy of |data|.
+   * @param timestamp: RTP-style timestamp of the first sample.
+   * @param data: interleaved samples, samples_per_channel * num_channels.
+   * @param samples_per_channel: samples per channel, sample_rate_hz / 100
+   *        for a 10 ms frame.
    * @param sample_rate_hz: the sample rate in Hz.
    * @param num_channels: the number of audio channels.
-   * @return AudioFrame*: a pointer to the newly created AudioFrame.
    */
-  MEDIA_MANAGER_API static AudioFrame* Create(int id, uint32_t timestamp,
-                                              const int16_t* data,
-                                              size_t samples_per_channel,
-                                              int sample_rate_hz,
-                                              size_t num_channels = 1);
+  LIB_WEBRTC_API static scoped_refptr<RTCAudioFrame> Create(
+      uint32_t timestamp, const int16_t* data, size_t samples_per_channel,
+      int sample_rate_hz, size_t num_channels = 1);
 
   /**
-   * @brief Releases the memory of this AudioFrame.
+   * @brief Replaces the contents of the frame. Passing a null |data| fills
+   *        the frame with silence.
+   * @return false if the frame is larger than the frame storage.
    */
-  virtual void Release() = 0;
-
- public:
-  /**
-   * @brief Updates the audio frame with specified parameters.
-   * @param id: the unique identifier of the frame.
-   * @param timestamp: the timestamp of the frame.
-   * @param data: a pointer to the audio data buffer.
-   * @param samples_per_channel: the number of samples per channel.
-   * @param sample_rate_hz: the sample rate in Hz.
-   * @param num_channels: the number of audio channels.
-   */
-  virtual void UpdateFrame(int id, uint32_t timestamp, const int16_t* data,
+  virtual bool UpdateFrame(uint32_t timestamp, const int16_t* data,
                            size_t samples_per_channel, int sample_rate_hz,
                            size_t num_channels = 1) = 0;
 
   /**
-   * @brief Copies the contents of another AudioFrame.
-   * @param src: the source AudioFrame to copy from.
+   * @brief Copies the samples and format of |src|.
    */
-  virtual void CopyFrom(const AudioFrame& src) = 0;
+  virtual void CopyFrom(scoped_refptr<RTCAudioFrame> src) = 0;
 
   /**
-   * @brief Adds another AudioFrame to this one.
-   * @param frame_to_add: the AudioFrame to add.
+   * @brief Mixes |frame_to_add| into this frame with saturation. Both frames
+   *        must have the same format.
    */
-  virtual void Add(const AudioFrame& frame_to_add) = 0;
+  virtual void Add(scoped_refptr<RTCAudioFrame> frame_to_add) = 0;
 
   /**
-   * @brief Mutes the audio data in this AudioFrame.
+   * @brief Fills the frame with silence.
    */
   virtual void Mute() = 0;
 
-  /**
-   * @brief Returns a pointer to the audio data buffer.
-   * @return const int16_t*: a pointer to the audio data buffer.
-   */
-  virtual const int16_t* data() = 0;
+  virtual const int16_t* data() const = 0;
 
-  /**
-   * @brief Returns the number of samples per channel.
-   * @return size_t: the number of samples per channel.
-   */
-  virtual size_t samples_per_channel() = 0;
+  virtual int16_t* mutable_data() = 0;
 
-  /**
-   * @brief Returns the sample rate in Hz.
-   * @return int: the sample rate in Hz.
-   */
-  virtual int sample_rate_hz() = 0;
+  virtual size_t samples_per_channel() const = 0;
 
-  /**
-   * @brief Returns the number of audio channels.
-   * @return size_t: the number of audio channels.
-   */
-  virtual size_t num_channels() = 0;
+  virtual int sample_rate_hz() const = 0;
 
-  /**
-   * @brief Returns the timestamp of the AudioFrame.
-   * @return uint32_t: the timestamp of the AudioFrame.
-   */
-  virtual uint32_t timestamp() = 0;
+  virtual size_t num_channels() const = 0;
 
-  /**
-   * @brief Returns the unique identifier of the AudioFrame.
-   * @return int: the unique identifier of the AudioFrame.
-   */
+  virtual uint32_t timestamp() const = 0;
 
-  virtual int id() = 0;
+ protected:
+  virtual ~RTCAudioFrame() {}
 };
 
-};  // namespace b2bua
+}  // namespace libwebrtc
 
-#endif
+#endif  // LIB_WEBRTC_RTC_AUDIO_FRAME_HXX
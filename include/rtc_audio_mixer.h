@@ -0,0 +1,54 @@
+#ifndef LIB_WEBRTC_RTC_AUDIO_MIXER_HXX
+#define LIB_WEBRTC_RTC_AUDIO_MIXER_HXX
+
+#include "rtc_audio_track.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+/**
+ * Mixes the audio of several RTCAudioTrack into one stream.
+ *
+ * Every 10 ms the mixer takes the next frame of each track, keeps the
+ * |max_mixed_sources| loudest ones and adds them with their gains, using
+ * saturating SIMD adds. Tracks are converted to the output format before
+ * mixing. Frames are queued per track, and a track that runs ahead of the
+ * mixer clock has its oldest frames dropped so the tracks stay aligned.
+ *
+ * Created by RTCPeerConnectionFactory::CreateAudioMixer().
+ */
+class RTCAudioMixer : public RefCountInterface {
+ public:
+  /**
+   * Starts mixing |track| with |gain| (linear, up to 2.0).
+   * @return false if the track is already mixed.
+   */
+  virtual bool AddTrack(scoped_refptr<RTCAudioTrack> track,
+                        float gain = 1.0f) = 0;
+
+  /**
+   * Stops mixing |track|.
+   */
+  virtual void RemoveTrack(scoped_refptr<RTCAudioTrack> track) = 0;
+
+  /**
+   * Changes the gain of a mixed track.
+   */
+  virtual void SetGain(scoped_refptr<RTCAudioTrack> track, float gain) = 0;
+
+  /**
+   * Changes how many of the loudest tracks are mixed, 0 mixes all of them.
+   */
+  virtual void SetMaxMixedSources(size_t max_mixed_sources) = 0;
+
+  virtual int sample_rate_hz() const = 0;
+
+  virtual size_t num_channels() const = 0;
+
+ protected:
+  virtual ~RTCAudioMixer() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_AUDIO_MIXER_HXX
@@ -1,10 +1,30 @@
 #ifndef LIB_WEBRTC_RTC_AUDIO_SOURCE_HXX
 #define LIB_WEBRTC_RTC_AUDIO_SOURCE_HXX
 
+#include "rtc_audio_frame.h"
 #include "rtc_types.h"
 
 namespace libwebrtc {
 
+/**
+ * Audio processing (APM) settings for microphone audio.
+ *
+ * Set on RTCPeerConnectionFactoryOptions it chooses whether the factory has
+ * an audio processing module at all and gives the default for new sources;
+ * passed to CreateAudioSource() it overrides the default for one source.
+ * Custom audio sources never go through audio processing.
+ */
+struct RTCAudioProcessingConfig {
+  // false skips audio processing entirely: on the factory no APM is created
+  // (no echo cancellation, noise suppression, gain control or far-end
+  // analysis of received audio); on a source every submodule is switched off.
+  bool enabled = true;
+  bool echo_cancellation = true;
+  bool noise_suppression = true;
+  bool auto_gain_control = true;
+  bool high_pass_filter = true;
+};
+
 /**
  * The RTCAudioSource class is a base class for audio sources in WebRTC.
  * Audio sources represent the source of audio data in WebRTC, such as a
@@ -13,6 +33,26 @@ namespace libwebrtc {
  * processing and transmission mechanisms.
  */
 class RTCAudioSource : public RefCountInterface {
+ public:
+  enum SourceType {
+    kMicrophone,
+    kCustom,
+  };
+
+  /**
+   * Returns kCustom for sources made with
+   * RTCPeerConnectionFactory::CreateCustomAudioSource().
+   */
+  virtual SourceType GetSourceType() const = 0;
+
+  /**
+   * Pushes PCM into a custom source. The frame is handed to the tracks'
+   * senders on the calling thread without going through the audio device;
+   * the call never waits on the library threads. Frames should be 10 ms
+   * long; other lengths are re-chunked. Ignored for microphone sources.
+   */
+  virtual void OnData(scoped_refptr<RTCAudioFrame> frame) = 0;
+
  protected:
   /**
    * The destructor for the RTCAudioSource class.
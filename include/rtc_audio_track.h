@@ -1,11 +1,55 @@
 #ifndef LIB_WEBRTC_RTC_AUDIO_TRACK_HXX
 #define LIB_WEBRTC_RTC_AUDIO_TRACK_HXX
 
+#include "rtc_audio_frame.h"
 #include "rtc_media_track.h"
 #include "rtc_types.h"
 
 namespace libwebrtc {
 
+/**
+ * Receives the PCM of an RTCAudioTrack in 10 ms frames, on the audio thread.
+ * The frame is shared with other sinks of the same format and must not be
+ * modified; keep a reference to hold on to it.
+ */
+class RTCAudioTrackSink {
+ public:
+  virtual void OnData(scoped_refptr<RTCAudioFrame> frame) = 0;
+
+ protected:
+  virtual ~RTCAudioTrackSink() {}
+};
+
+/**
+ * The level of an RTCAudioTrack over the last 10 ms.
+ */
+struct RTCAudioLevel {
+  // Root mean square and peak amplitude, 0 (silence) to 1 (full scale).
+  float rms = 0.0f;
+  float peak = 0.0f;
+  // Voice activity, held for 200 ms after the last voiced frame.
+  bool voice_active = false;
+};
+
+/**
+ * Receives level meter events of an RTCAudioTrack. Events are posted like
+ * other observer callbacks, to the factory's RTCEventExecutor or signaling
+ * thread, never on the audio thread.
+ */
+class RTCAudioLevelObserver {
+ public:
+  /**
+   * The RMS level rose to the threshold (|above| true) or fell about 3 dB
+   * below it (|above| false).
+   */
+  virtual void OnLevelThresholdCrossed(bool above, RTCAudioLevel level) = 0;
+
+  virtual void OnVoiceActivityChanged(bool voice_active) {}
+
+ protected:
+  virtual ~RTCAudioLevelObserver() {}
+};
+
 /**
  * The RTCAudioTrack class represents an audio track in WebRTC.
  * Audio tracks are used to transmit audio data over a WebRTC peer connection.
@@ -17,6 +61,49 @@ class RTCAudioTrack : public RTCMediaTrack {
   // volume in [0-10]
   virtual void SetVolume(double volume) = 0;
 
+  /**
+   * Starts delivering the track's audio to |sink|, converted to
+   * |sample_rate_hz| and |num_channels| (0 keeps the track's own rate or
+   * channel count). Conversion runs once per track for each distinct
+   * format, however many sinks request it.
+   *
+   * Remote tracks and tracks of custom audio sources deliver audio; tracks of
+   * the audio device's microphone do not.
+   */
+  virtual void AddSink(RTCAudioTrackSink* sink, int sample_rate_hz = 0,
+                       size_t num_channels = 0) = 0;
+
+  /**
+   * Stops delivery to |sink|. After this returns |sink| is not called again.
+   * Sinks may call it, and AddSink(), from OnData(), for themselves or any
+   * other sink; from another thread it waits for a running OnData() call.
+   */
+  virtual void RemoveSink(RTCAudioTrackSink* sink) = 0;
+
+  /**
+   * Starts or stops measuring the level and voice activity of the track
+   * every 10 ms on the audio thread. Tracks deliver levels under the same
+   * conditions as AddSink().
+   */
+  virtual void EnableLevelMeter(bool enable) = 0;
+
+  /**
+   * Returns the latest measurement. It is read from atomics and never waits
+   * on the audio thread, so it is cheap enough to poll at any rate. All zero
+   * while the meter is off.
+   */
+  virtual RTCAudioLevel GetAudioLevel() const = 0;
+
+  /**
+   * Sends threshold and voice activity events to |observer|, which also
+   * turns the meter on. |rms_threshold| is a linear level in (0, 1]. Pass
+   * nullptr to stop the events. Events are delivered through the event
+   * executor of the factory that created the track, or of the peer
+   * connection that received it, and stop when that factory terminates.
+   */
+  virtual void SetLevelObserver(RTCAudioLevelObserver* observer,
+                                float rms_threshold = 0.01f) = 0;
+
  protected:
   /**
    * The destructor for the RTCAudioTrack class.
@@ -14,6 +14,19 @@ namespace libwebrtc {
 
 class DesktopCapturerObserver;
 
+/**
+ * @brief Cursor image reported when the cursor is not drawn into frames.
+ */
+struct DesktopCursorShape {
+  int width = 0;
+  int height = 0;
+  /** Hotspot offset from the top-left of the image. */
+  int hotspot_x = 0;
+  int hotspot_y = 0;
+  /** 32-bit BGRA pixels, row-major, width * height * 4 bytes. */
+  vector<uint8_t> data;
+};
+
 /**
  * @brief The interface for capturing desktop media.
  *
@@ -66,6 +79,18 @@ class RTCDesktopCapturer : public RefCountInterface {
   virtual CaptureState Start(uint32_t fps, uint32_t x, uint32_t y, uint32_t w,
                              uint32_t h) = 0;
 
+  /**
+   * @brief Scales captured frames to the given size before delivery.
+   *
+   * Capturers of the same source share one capture loop; the crop, scale and
+   * frame rate set here only apply to this capturer's output. Pass 0 for
+   * either dimension to deliver frames at the captured (or cropped) size.
+   *
+   * @param width The output width in pixels.
+   * @param height The output height in pixels.
+   */
+  virtual void SetOutputSize(uint32_t width, uint32_t height) = 0;
+
   /**
    * @brief Stops desktop capture.
    */
@@ -129,6 +154,33 @@ class DesktopCapturerObserver {
    */
   virtual void OnError(scoped_refptr<RTCDesktopCapturer> capturer) = 0;
 
+  /**
+   * @brief Called when the cursor image changes.
+   *
+   * Only used by capturers created with show_cursor set to false. Called
+   * once after capture starts and again whenever the shape changes.
+   *
+   * @param capturer A reference to the capturer tracking the cursor.
+   * @param shape The new cursor image.
+   */
+  virtual void OnCursorShapeChanged(scoped_refptr<RTCDesktopCapturer> capturer,
+                                    const DesktopCursorShape& shape) {}
+
+  /**
+   * @brief Called when the cursor moves.
+   *
+   * Only used by capturers created with show_cursor set to false. The
+   * position is in the coordinates of the delivered frames, after crop and
+   * scale, and is only reported when it changes.
+   *
+   * @param capturer A reference to the capturer tracking the cursor.
+   * @param x The horizontal position of the cursor hotspot.
+   * @param y The vertical position of the cursor hotspot.
+   * @param visible False when the cursor is outside the captured region.
+   */
+  virtual void OnCursorPositionChanged(
+      scoped_refptr<RTCDesktopCapturer> capturer, int x, int y, bool visible) {}
+
  protected:
   ~DesktopCapturerObserver() {}
 };
@@ -9,13 +9,35 @@ class MediaSource;
 class RTCDesktopCapturer;
 class RTCDesktopMediaList;
 
+// Timing of one job on the shared desktop capture threads: a capturer's
+// capture loop, or a media list's thumbnails and source monitoring.
+struct DesktopCaptureJobStats {
+  string name;
+  uint64_t runs = 0;
+  int64_t total_run_time_us = 0;
+  int64_t max_run_time_us = 0;
+  // How late runs started relative to their deadline.
+  int64_t total_delay_us = 0;
+  int64_t max_delay_us = 0;
+};
+
 class RTCDesktopDevice : public RefCountInterface {
  public:
   virtual scoped_refptr<RTCDesktopCapturer> CreateDesktopCapturer(
       scoped_refptr<MediaSource> source) = 0;
+  // With |show_cursor| false the cursor is not drawn into the frames; its
+  // shape and position are reported to the DesktopCapturerObserver instead.
+  virtual scoped_refptr<RTCDesktopCapturer> CreateDesktopCapturer(
+      scoped_refptr<MediaSource> source, bool show_cursor) = 0;
   virtual scoped_refptr<RTCDesktopMediaList> GetDesktopMediaList(
       DesktopType type) = 0;
 
+  // Desktop capturers and media lists share a small pool of capture threads.
+  // Changing the size only affects capturers and lists created afterwards.
+  virtual void SetCaptureThreadPoolSize(uint32_t threads) = 0;
+
+  virtual vector<DesktopCaptureJobStats> GetCaptureJobStats() = 0;
+
  protected:
   virtual ~RTCDesktopDevice() {}
 };
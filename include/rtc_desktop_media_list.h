@@ -35,6 +35,13 @@ class MediaListObserver {
   virtual void OnMediaSourceThumbnailChanged(
       scoped_refptr<MediaSource> source) = 0;
 
+  // Called once per refresh with every change found in that pass, after the
+  // per-source callbacks above. Only invoked when something changed.
+  virtual void OnMediaSourcesChanged(
+      vector<scoped_refptr<MediaSource>> added,
+      vector<scoped_refptr<MediaSource>> removed,
+      vector<scoped_refptr<MediaSource>> name_changed) {}
+
  protected:
   virtual ~MediaListObserver() {}
 };
@@ -57,6 +64,16 @@ class RTCDesktopMediaList : public RefCountInterface {
   virtual bool GetThumbnail(scoped_refptr<MediaSource> source,
                             bool notify = false) = 0;
 
+  // Refreshes the source list every |interval_ms| on the media list thread
+  // and notifies the observer without blocking the caller. Replaces polling
+  // UpdateSourceList().
+  virtual bool StartMonitoring(uint32_t interval_ms,
+                               bool get_thumbnail = false) = 0;
+
+  virtual void StopMonitoring() = 0;
+
+  virtual bool IsMonitoring() const = 0;
+
  protected:
   ~RTCDesktopMediaList() {}
 };
@@ -0,0 +1,67 @@
+#ifndef LIB_WEBRTC_RTC_ENCODED_VIDEO_SOURCE_HXX
+#define LIB_WEBRTC_RTC_ENCODED_VIDEO_SOURCE_HXX
+
+#include "rtc_types.h"
+#include "rtc_video_source.h"
+
+namespace libwebrtc {
+
+class RTCEncodedVideoSourceObserver {
+ public:
+  /**
+   * A receiver lost frames or asked for a key frame (PLI/FIR). Push a key
+   * frame as soon as possible; until then delta frames that follow a lost
+   * one are not sent. Called on the encoder thread, must not block.
+   * Requests are folded until a key frame is pushed, and repeated after a
+   * second if none arrives.
+   */
+  virtual void OnKeyFrameRequested() = 0;
+
+ protected:
+  virtual ~RTCEncodedVideoSourceObserver() {}
+};
+
+/**
+ * A video source fed with already encoded VP8 or H.264 access units. A
+ * sender whose track uses it packetizes the access units as they are, with
+ * no decoding or encoding, provided the negotiated codec matches. Tracks of
+ * other sources keep using the regular encoder on the same connection.
+ *
+ * H.264 access units are Annex B byte streams; key frames must carry their
+ * SPS and PPS. Since H.264 may be missing from the decoders, use a
+ * send-only transceiver so that it can be negotiated. The bitrate follows
+ * the pushed stream, not webrtc's estimate. Local renderers of the track
+ * show black frames.
+ *
+ * Created by RTCPeerConnectionFactory::CreateEncodedVideoSource().
+ */
+class RTCEncodedVideoSource : public RefCountInterface {
+ public:
+  /**
+   * The source to create video tracks from.
+   */
+  virtual scoped_refptr<RTCVideoSource> video_source() = 0;
+
+  virtual RTCVideoCodecType codec() const = 0;
+
+  /**
+   * Sends one access unit. Push in real time; |capture_time_us| (in the
+   * rtc::TimeMicros() clock, 0 for now) sets the RTP timestamp. The data is
+   * copied once.
+   */
+  virtual bool PushFrame(const uint8_t* data, size_t size, bool key_frame,
+                         int width, int height,
+                         int64_t capture_time_us = 0) = 0;
+
+  /**
+   * |observer| must stay valid until it is replaced or the source is gone.
+   */
+  virtual void SetObserver(RTCEncodedVideoSourceObserver* observer) = 0;
+
+ protected:
+  virtual ~RTCEncodedVideoSource() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_ENCODED_VIDEO_SOURCE_HXX
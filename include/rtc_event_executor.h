@@ -0,0 +1,34 @@
+#ifndef LIB_WEBRTC_RTC_EVENT_EXECUTOR_HXX
+#define LIB_WEBRTC_RTC_EVENT_EXECUTOR_HXX
+
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+/**
+ * An application-provided executor for the library's event callbacks; see
+ * RTCPeerConnectionFactory::SetEventExecutor() for which ones.
+ *
+ * The threads that raise these events never wait for observer code. Each
+ * event is packaged as a small copyable task and handed to Post(); the
+ * observer is called when the application runs it. Without an executor,
+ * tasks run on the factory's signaling thread.
+ */
+class RTCEventExecutor {
+ public:
+  typedef fixed_size_function<void()> Task;
+
+  /**
+   * Queues |task| to run later. Called from library threads, so it must not
+   * block or run the task inline. Tasks must run in the order they were
+   * posted.
+   */
+  virtual void Post(Task task) = 0;
+
+ protected:
+  virtual ~RTCEventExecutor() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_EVENT_EXECUTOR_HXX
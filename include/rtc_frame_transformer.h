@@ -0,0 +1,86 @@
+#ifndef LIB_WEBRTC_RTC_FRAME_TRANSFORMER_HXX
+#define LIB_WEBRTC_RTC_FRAME_TRANSFORMER_HXX
+
+#include "base/refcount.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+/**
+ * An encoded audio or video frame on its way from the encoder to the
+ * packetizer (senders) or from the depacketizer to the decoder (receivers).
+ *
+ * The frame wraps webrtc's own buffer without copying. It is only valid
+ * during RTCFrameTransformer::OnFrame(); afterwards data() returns nullptr
+ * and size() 0, so copy the payload to keep it.
+ */
+class RTCEncodedFrame : public RefCountInterface {
+ public:
+  virtual RTCMediaType media_type() const = 0;
+
+  /**
+   * The encoded payload. The view stays valid until OnFrame() returns or
+   * SetData() is called.
+   */
+  virtual const uint8_t* data() const = 0;
+
+  virtual size_t size() const = 0;
+
+  /**
+   * Replaces the payload, for example to append a tag. Copies |data|.
+   */
+  virtual void SetData(const uint8_t* data, size_t size) = 0;
+
+  /**
+   * True for video key frames. Every audio frame is decodable on its own
+   * and reports true.
+   */
+  virtual bool is_key_frame() const = 0;
+
+  // RTP timestamp, SSRC and payload type the frame is sent or received with.
+  virtual uint32_t timestamp() const = 0;
+
+  virtual uint32_t ssrc() const = 0;
+
+  virtual uint8_t payload_type() const = 0;
+
+  /**
+   * False for audio, and for video in a codec RTCVideoCodecType has no
+   * name for (such as the generic packetization). video_codec() is
+   * meaningless then.
+   */
+  virtual bool has_video_codec() const = 0;
+
+  // Video only: the codec and the encoded size, which delta frames may
+  // report as 0.
+  virtual RTCVideoCodecType video_codec() const = 0;
+
+  virtual int width() const = 0;
+
+  virtual int height() const = 0;
+
+ protected:
+  virtual ~RTCEncodedFrame() {}
+};
+
+/**
+ * Inspects or rewrites the encoded frames of an RTCRtpSender or
+ * RTCRtpReceiver. Set with SetFrameTransformer(); the sender or receiver
+ * keeps a reference for as long as it uses it.
+ */
+class RTCFrameTransformer : public RefCountInterface {
+ public:
+  /**
+   * Called for every frame, synchronously on a webrtc media thread (the
+   * encoder queue for senders, the worker or decoder thread for receivers),
+   * so it must not block. Return false to drop the frame.
+   */
+  virtual bool OnFrame(scoped_refptr<RTCEncodedFrame> frame) = 0;
+
+ protected:
+  virtual ~RTCFrameTransformer() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_FRAME_TRANSFORMER_HXX
@@ -169,6 +169,46 @@ class RTCPeerConnectionObserver {
   virtual ~RTCPeerConnectionObserver() {}
 };
 
+enum class RTCQualityLimitationReason {
+  kNone,
+  kCpu,
+  kBandwidth,
+  kOther,
+};
+
+/**
+ * What a video sender is currently sending, from its outbound-rtp stats.
+ * With simulcast the highest resolution layer is reported.
+ */
+struct RTCVideoAdaptationState {
+  RTCQualityLimitationReason reason = RTCQualityLimitationReason::kNone;
+  int width = 0;
+  int height = 0;
+  double framerate = 0.0;
+  // Resolution changes caused by CPU or bandwidth limits so far.
+  uint32_t resolution_changes = 0;
+};
+
+/**
+ * Receives adaptation changes of the video senders of a peer connection.
+ * Events are posted like other observer callbacks, to the factory's
+ * RTCEventExecutor or signaling thread.
+ */
+class RTCVideoAdaptationObserver {
+ public:
+  /**
+   * Called when the quality limitation reason or the resolution of
+   * |sender| changes, or its frame rate moves by a quarter or more since
+   * the last call. The wrapper is a new object; compare senders by id().
+   */
+  virtual void OnVideoAdaptationChanged(
+      scoped_refptr<RTCRtpSender> sender,
+      const RTCVideoAdaptationState& state) = 0;
+
+ protected:
+  virtual ~RTCVideoAdaptationObserver() {}
+};
+
 class RTCPeerConnection : public RefCountInterface {
  public:
   virtual int AddStream(scoped_refptr<RTCMediaStream> stream) = 0;
@@ -264,6 +304,15 @@ class RTCPeerConnection : public RefCountInterface {
 
   virtual RTCIceGatheringState ice_gathering_state() = 0;
 
+  /**
+   * Polls the stats of the video senders every |interval_ms| and reports
+   * their adaptation changes to |observer|. Replaces an earlier observer;
+   * nullptr stops polling. The earlier observer gets no calls once this
+   * returns; a call running on another thread is waited for.
+   */
+  virtual void SetVideoAdaptationObserver(RTCVideoAdaptationObserver* observer,
+                                          int interval_ms) = 0;
+
  protected:
   virtual ~RTCPeerConnection() {}
 };
@@ -1,15 +1,22 @@
 #ifndef LIB_WEBRTC_RTC_PEERCONNECTION_FACTORY_HXX
 #define LIB_WEBRTC_RTC_PEERCONNECTION_FACTORY_HXX
 
+#include "rtc_active_speaker_detector.h"
+#include "rtc_audio_mixer.h"
 #include "rtc_audio_source.h"
 #include "rtc_audio_track.h"
+#include "rtc_encoded_video_source.h"
+#include "rtc_event_executor.h"
 #include "rtc_types.h"
+#include "rtc_video_codec.h"
 #ifdef RTC_DESKTOP_DEVICE
 #include "rtc_desktop_device.h"
 #endif
 #include "rtc_media_stream.h"
 #include "rtc_mediaconstraints.h"
+#include "rtc_rtp_sender.h"
 #include "rtc_video_device.h"
+#include "rtc_video_relay.h"
 #include "rtc_video_source.h"
 
 namespace libwebrtc {
@@ -19,12 +26,61 @@ class RTCAudioDevice;
 class RTCVideoDevice;
 class RTCRtpCapabilities;
 
+enum class RTCAudioDeviceType {
+  // The operating system's audio input and output devices.
+  kPlatform,
+  // No audio hardware: a 10 ms timer pulls received audio and the platform
+  // audio threads are never started. Suited to servers and bots.
+  kVirtual,
+};
+
+struct RTCPeerConnectionFactoryOptions {
+  RTCAudioDeviceType audio_device = RTCAudioDeviceType::kPlatform;
+
+  // kVirtual only. Receives the mixed audio of all remote tracks every 10 ms
+  // on the virtual device's clock thread. Without a sink the mix is dropped.
+  // Must outlive the factory.
+  RTCAudioTrackSink* playout_sink = nullptr;
+  int playout_sample_rate_hz = 48000;
+  size_t playout_channels = 2;
+
+  // kVirtual only. When true the device reports a microphone that records
+  // silence, so microphone audio sources still produce (silent) frames. When
+  // false there is no recording device at all and only custom audio sources
+  // feed the send streams.
+  bool virtual_record_silence = false;
+
+  // Audio processing of the factory and default for CreateAudioSource().
+  // Servers and relays that never capture a microphone can set
+  // |audio_processing.enabled| to false to drop the APM's per-stream cost.
+  RTCAudioProcessingConfig audio_processing;
+
+  // Replace the built-in video encoders and decoders when set. Sources
+  // from CreateEncodedVideoSource() are still sent as they are, so VP8 and
+  // H264 are always offered for sending.
+  scoped_refptr<RTCVideoEncoderFactory> video_encoder_factory;
+  scoped_refptr<RTCVideoDecoderFactory> video_decoder_factory;
+
+  // Default CPU limits of all video encoders, for hosts that run many
+  // outgoing streams. See RTCRtpSender::set_video_encoder_cpu_settings().
+  RTCVideoEncoderCpuSettings video_encoder_cpu;
+};
+
 class RTCPeerConnectionFactory : public RefCountInterface {
  public:
   virtual bool Initialize() = 0;
 
   virtual bool Terminate() = 0;
 
+  // Routes the event callbacks of desktop capturers and media lists, active
+  // speaker detectors, video adaptation observers and audio level observers
+  // to |executor| instead of the signaling thread. Peer connection, data
+  // channel, SDP and stats callbacks still come from webrtc's signaling
+  // thread, and audio and video sinks are called on the media thread that
+  // produced the data. Pass nullptr to go back to the signaling thread.
+  // |executor| must stay valid until it is replaced.
+  virtual void SetEventExecutor(RTCEventExecutor* executor) = 0;
+
   virtual scoped_refptr<RTCPeerConnection> Create(
       const RTCConfiguration& configuration,
       scoped_refptr<RTCMediaConstraints> constraints) = 0;
@@ -40,9 +96,56 @@ class RTCPeerConnectionFactory : public RefCountInterface {
   virtual scoped_refptr<RTCAudioSource> CreateAudioSource(
       const string audio_source_label) = 0;
 
+  // Creates a microphone source processed with |config| instead of the
+  // factory default. The factory has one APM shared by all microphone
+  // sources, so the settings of the source that last started sending apply.
+  virtual scoped_refptr<RTCAudioSource> CreateAudioSource(
+      const string audio_source_label,
+      const RTCAudioProcessingConfig& config) = 0;
+
+  // Creates an audio source that is fed with RTCAudioSource::OnData()
+  // instead of the audio device.
+  virtual scoped_refptr<RTCAudioSource> CreateCustomAudioSource(
+      const string audio_source_label) = 0;
+
+  // Creates a custom audio source that plays a 16-bit PCM WAV file in real
+  // time, 10 ms at a time, optionally looping. The file is memory mapped and
+  // no audio device is involved. Returns null if the file cannot be used.
+  virtual scoped_refptr<RTCAudioSource> CreateWavFileAudioSource(
+      const string audio_source_label, const string wav_path,
+      bool loop = true) = 0;
+
   virtual scoped_refptr<RTCVideoSource> CreateVideoSource(
       scoped_refptr<RTCVideoCapturer> capturer, const string video_source_label,
       scoped_refptr<RTCMediaConstraints> constraints) = 0;
+
+  // Creates a source for already encoded VP8 or H.264 video, sent without
+  // transcoding. Returns null for other codecs.
+  virtual scoped_refptr<RTCEncodedVideoSource> CreateEncodedVideoSource(
+      RTCVideoCodecType codec, const string video_source_label) = 0;
+
+  // Creates a relay that forwards the encoded video of |receiver|, in
+  // |codec|, to senders added to it. Returns null for audio receivers.
+  virtual scoped_refptr<RTCVideoRelay> CreateVideoRelay(
+      scoped_refptr<RTCRtpReceiver> receiver, RTCVideoCodecType codec,
+      int min_key_frame_request_interval_ms = 300) = 0;
+
+  // Creates a mixer that delivers the mix of its tracks to |output| every
+  // 10 ms, at |sample_rate_hz| with |num_channels| (1 or 2). Only the
+  // |max_mixed_sources| loudest tracks are mixed, 0 mixes all of them.
+  // |output| is called on the mixer's thread and must outlive the mixer.
+  virtual scoped_refptr<RTCAudioMixer> CreateAudioMixer(
+      RTCAudioTrackSink* output, int sample_rate_hz = 48000,
+      size_t num_channels = 1, size_t max_mixed_sources = 3) = 0;
+
+  // Creates a detector that ranks audio receivers by their RFC 6464 header
+  // levels every |interval_ms| and tells |observer| about the
+  // |max_speakers| loudest ones (0 for all speaking receivers) whenever the
+  // ranking changes. |observer| may be null to only poll active_speakers();
+  // otherwise it must outlive the detector.
+  virtual scoped_refptr<RTCActiveSpeakerDetector> CreateActiveSpeakerDetector(
+      RTCActiveSpeakerObserver* observer, size_t max_speakers = 3,
+      int interval_ms = 100) = 0;
 #ifdef RTC_DESKTOP_DEVICE
   virtual scoped_refptr<RTCVideoSource> CreateDesktopSource(
       scoped_refptr<RTCDesktopCapturer> capturer,
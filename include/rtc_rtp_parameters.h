@@ -163,10 +163,36 @@ enum class RTCPriority {
   kHigh,
 };
 
+enum class RTCVideoLayerPreset {
+  // One encoding with three temporal layers (L1T3).
+  kSingleLayer,
+  // Up to three L1T3 simulcast encodings at 1/4, 1/2 and full resolution,
+  // rids "q", "h" and "f".
+  kSimulcastL1T3,
+  // One encoding with up to three spatial and three temporal layers
+  // (L3T3). VP9 and AV1 only.
+  kSvcL3T3,
+};
+
 class RTCRtpEncodingParameters : public RefCountInterface {
  public:
   LIB_WEBRTC_API static scoped_refptr<RTCRtpEncodingParameters> Create();
 
+  /**
+   * The encodings for |preset| when sending |width|x|height| video, lowest
+   * resolution first, for RTCRtpTransceiverInit::Create() or
+   * RTCRtpParameters::set_encodings().
+   *
+   * The short side of the source picks the number of layers: three from
+   * 720, two from 360, one below. Each layer gets the max bitrate webrtc
+   * uses for its resolution. With |max_bitrate_bps| set, the top layers are
+   * left out (simulcast: inactive) until the rest fit, and a single
+   * remaining layer is capped to it.
+   */
+  LIB_WEBRTC_API static vector<scoped_refptr<RTCRtpEncodingParameters>>
+  CreatePreset(RTCVideoLayerPreset preset, int width, int height,
+               int max_bitrate_bps = 0);
+
   virtual uint32_t ssrc() = 0;
   virtual void set_ssrc(uint32_t value) = 0;
 
@@ -3,6 +3,7 @@
 
 #include "base/refcount.h"
 #include "base/scoped_ref_ptr.h"
+#include "rtc_frame_transformer.h"
 #include "rtc_rtp_parameters.h"
 #include "rtc_types.h"
 
@@ -45,6 +46,51 @@ class RTCRtpReceiver : public RefCountInterface {
 
   virtual void SetJitterBufferMinimumDelay(double delay_seconds) = 0;
 
+  /**
+   * Applies |profile| to this audio receiver. webrtc only lets the minimum
+   * delay change on a running stream, so only |min_delay_ms| takes effect.
+   * The packet limit and fast accelerate are fixed when the stream is
+   * created, from RTCConfiguration::audio_latency. Returns false for video
+   * receivers.
+   */
+  virtual bool SetAudioLatencyProfile(
+      const RTCAudioLatencyProfile& profile) = 0;
+
+  /**
+   * The audio level of the last packet played out, as sent by the remote
+   * side in the RFC 6464 ssrc-audio-level header extension: 0 (loudest) to
+   * 127 (silence) in -dBov. Read from the header, no audio is inspected,
+   * but webrtc records it when the packet is played out, so the receiver
+   * still decodes its audio. Returns -1 for video receivers, before the
+   * first packet, and when the sender does not use the extension.
+   */
+  virtual int audio_level() const = 0;
+
+  /**
+   * Passes every received frame through |transformer| before it is decoded.
+   * Replaces a frame cryptor or an earlier transformer; nullptr installs a
+   * pass-through.
+   */
+  virtual void SetFrameTransformer(
+      scoped_refptr<RTCFrameTransformer> transformer) = 0;
+
+  /**
+   * Asks the remote sender of a video receiver for a key frame (PLI), e.g.
+   * after switching renderers or splicing streams. Rate limited like
+   * RTCRtpSender::RequestKeyFrame(). The PLIs sent and key frames received
+   * show up as pliCount and keyFramesDecoded in the inbound-rtp stats.
+   * @return false if the request was dropped, or for audio receivers.
+   */
+  virtual bool RequestKeyFrame() = 0;
+
+  // 300 ms unless set; 0 passes every request on.
+  virtual void set_min_key_frame_request_interval_ms(int interval_ms) = 0;
+
+  virtual int min_key_frame_request_interval_ms() const = 0;
+
+  // Requests that were passed on.
+  virtual uint64_t key_frame_requests() const = 0;
+
   // virtual Vector<RtpSource> GetSources() const = 0;
 
   // virtual void SetFrameDecryptor(
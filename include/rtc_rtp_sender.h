@@ -3,6 +3,7 @@
 
 #include "base/refcount.h"
 #include "base/scoped_ref_ptr.h"
+#include "rtc_frame_transformer.h"
 #include "rtc_rtp_parameters.h"
 #include "rtc_types.h"
 
@@ -12,6 +13,40 @@ class RTCMediaTrack;
 class RTCDtlsTransport;
 class RTCDtmfSender;
 
+/**
+ * Opus encoder settings of an audio sender. Integer fields set to -1 keep
+ * the library default.
+ */
+struct RTCOpusSettings {
+  // Encoder CPU effort, 0 (cheapest) to 10 (best quality).
+  int complexity = -1;
+  // Packet duration in ms: 10, 20, 40, 60 or 120.
+  int ptime_ms = -1;
+  // Cap on the average bitrate, 6000 to 510000 bps.
+  int max_average_bitrate_bps = -1;
+  // Discontinuous transmission: near-empty packets during silence.
+  bool dtx = false;
+  // Opus in-band forward error correction.
+  bool inband_fec = true;
+  // Redundant audio (RFC 2198), sent only if the remote peer offers RED.
+  bool red = false;
+};
+
+/**
+ * CPU limits of a video sender's encoder. Fields set to -1 keep the
+ * factory's default (RTCPeerConnectionFactoryOptions::video_encoder_cpu),
+ * or the library default if that is -1 too.
+ */
+struct RTCVideoEncoderCpuSettings {
+  // Encoder effort, 0 (fastest) to 4 (best quality); webrtc uses 1. Honoured
+  // by the VP8 (libvpx) and AV1 (libaom) encoders and passed on to
+  // application encoders; others ignore it.
+  int complexity = -1;
+  // Cap on the CPU cores the encoder is told it has, which is what libvpx,
+  // libaom and OpenH264 size their thread pools by.
+  int max_threads = -1;
+};
+
 class RTCRtpSender : public RefCountInterface {
  public:
   virtual bool set_track(scoped_refptr<RTCMediaTrack> track) = 0;
@@ -39,6 +74,69 @@ class RTCRtpSender : public RefCountInterface {
       const scoped_refptr<RTCRtpParameters> parameters) = 0;
 
   virtual scoped_refptr<RTCDtmfSender> dtmf_sender() const = 0;
+
+  /**
+   * What a video sender gives up first when CPU or bandwidth runs short.
+   * Shortcut for the degradation preference of parameters().
+   */
+  virtual bool set_degradation_preference(
+      RTCDegradationPreference preference) = 0;
+
+  virtual RTCDegradationPreference degradation_preference() const = 0;
+
+  /**
+   * Tunes the Opus encoder of an audio sender. The settings are applied to
+   * the sender's m-section of every remote description set afterwards, so
+   * they take effect with the next negotiation. The settings are dropped
+   * when the sender is removed from its peer connection.
+   * @return false for video senders, and for senders not obtained from an
+   * RTCPeerConnection or its transceivers.
+   */
+  virtual bool set_opus_settings(const RTCOpusSettings& settings) = 0;
+
+  virtual RTCOpusSettings opus_settings() const = 0;
+
+  /**
+   * Limits the CPU the video encoder of a video sender may use. Applied
+   * like set_opus_settings(); the encoder is recreated with the new limits
+   * when the next negotiation completes. The effective values show up in
+   * the encoderImplementation of the sender's outbound-rtp stats, e.g.
+   * "libvpx (complexity 0, 2 cores)".
+   * @return false for audio senders, and like set_opus_settings().
+   */
+  virtual bool set_video_encoder_cpu_settings(
+      const RTCVideoEncoderCpuSettings& settings) = 0;
+
+  virtual RTCVideoEncoderCpuSettings video_encoder_cpu_settings() const = 0;
+
+  /**
+   * Makes the encoder of a video sender produce a key frame on all its
+   * layers, e.g. after the receiving side switched renderers. Requests less
+   * than the minimum interval after the last one that was passed on are
+   * dropped, so bursts do not cause key frame storms. The key frames show
+   * up as keyFramesEncoded in the outbound-rtp stats. The interval and
+   * count are kept by the peer connection, for senders obtained from it or
+   * its transceivers, until the sender is removed.
+   * @return false if the request was dropped, or for audio senders and
+   * senders that are not sending.
+   */
+  virtual bool RequestKeyFrame() = 0;
+
+  // 300 ms unless set; 0 passes every request on.
+  virtual void set_min_key_frame_request_interval_ms(int interval_ms) = 0;
+
+  virtual int min_key_frame_request_interval_ms() const = 0;
+
+  // Requests that were passed on.
+  virtual uint64_t key_frame_requests() const = 0;
+
+  /**
+   * Passes every encoded frame through |transformer| before it is
+   * packetized. Replaces a frame cryptor or an earlier transformer; nullptr
+   * installs a pass-through.
+   */
+  virtual void SetFrameTransformer(
+      scoped_refptr<RTCFrameTransformer> transformer) = 0;
 };
 
 }  // namespace libwebrtc
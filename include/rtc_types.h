@@ -30,6 +30,8 @@ enum class MediaSecurityType { kSRTP_None = 0, kSDES_SRTP, kDTLS_SRTP };
 
 enum class RTCMediaType { AUDIO, VIDEO, DATA, UNSUPPORTED };
 
+enum class RTCVideoCodecType { kVP8, kVP9, kH264, kAV1 };
+
 using string = portable::string;
 
 // template <typename Key, typename T>
@@ -69,6 +71,36 @@ enum BundlePolicy {
 
 enum class SdpSemantics { kPlanB, kUnifiedPlan };
 
+// Receive side buffering of audio (NetEq). The defaults are webrtc's, which
+// favour smooth playout over latency. For interactive use set
+// |fast_accelerate| and keep |min_delay_ms| low, and accept more
+// concealment on jittery networks.
+struct RTCAudioLatencyProfile {
+  // Overflow limit of the packet buffer: once it holds this many packets
+  // NetEq flushes all of them. It is not a delay cap, and a small value
+  // drops audio on every burst. 0 keeps webrtc's default of 200.
+  int max_packets = 0;
+  // Lower bound of the target delay, raised to absorb expected jitter.
+  int min_delay_ms = 0;
+  // Time-compress audio more aggressively when the buffer is behind.
+  bool fast_accelerate = false;
+};
+
+// A CPU overuse detector with configurable thresholds, added next to
+// webrtc's own, whose thresholds are fixed (85% / 42% of the time between
+// frames spent encoding). It samples the CPU time of the whole process, as
+// a share of all cores, every |interval_ms|. Video senders are degraded,
+// each by its degradation preference, while the usage is above
+// |high_threshold_percent| for two samples in a row, and restored once it
+// stays below |low_threshold_percent| for three.
+struct RTCCpuOveruseSettings {
+  // 0 leaves only webrtc's detector.
+  int high_threshold_percent = 0;
+  // 0 uses half of |high_threshold_percent|.
+  int low_threshold_percent = 0;
+  int interval_ms = 1000;
+};
+
 struct RTCConfiguration {
   IceServer ice_servers[kMaxIceServerSize];
   IceTransportsType type = IceTransportsType::kAll;
@@ -92,6 +124,13 @@ struct RTCConfiguration {
   bool disable_link_local_networks = false;
   int screencast_min_bitrate = -1;
 
+  // Buffering of all audio receivers of the connection. Receivers can
+  // raise their minimum delay later, see RTCRtpReceiver.
+  RTCAudioLatencyProfile audio_latency;
+
+  // Additional CPU overuse detection for the video senders.
+  RTCCpuOveruseSettings cpu_overuse;
+
   // private
   bool use_rtp_mux = true;
   uint32_t local_audio_bandwidth = 128;
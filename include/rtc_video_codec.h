@@ -0,0 +1,168 @@
+#ifndef LIB_WEBRTC_RTC_VIDEO_CODEC_HXX
+#define LIB_WEBRTC_RTC_VIDEO_CODEC_HXX
+
+#include "rtc_types.h"
+#include "rtc_video_frame.h"
+
+namespace libwebrtc {
+
+struct RTCVideoEncoderSettings {
+  RTCVideoCodecType codec = RTCVideoCodecType::kVP8;
+  int width = 0;
+  int height = 0;
+  int max_framerate = 30;
+  int start_bitrate_kbps = 0;
+  int max_bitrate_kbps = 0;
+  // CPU cores webrtc considers available to this encoder, after
+  // RTCVideoEncoderCpuSettings::max_threads.
+  int number_of_cores = 1;
+  // RTCVideoEncoderCpuSettings::complexity, 1 unless set.
+  int complexity = 1;
+};
+
+/**
+ * Receives the output of an RTCVideoEncoder. Implemented by the library;
+ * may be called on any thread.
+ */
+class RTCVideoEncoderCallback {
+ public:
+  /**
+   * Hands over one encoded access unit. |timestamp| is the value passed to
+   * the Encode() call the frame belongs to. The data is copied.
+   */
+  virtual void OnEncodedFrame(const uint8_t* data, size_t size, bool key_frame,
+                              int width, int height, uint32_t timestamp) = 0;
+
+ protected:
+  virtual ~RTCVideoEncoderCallback() {}
+};
+
+/**
+ * An application video encoder. Calls come from webrtc's encoder queue,
+ * one at a time.
+ *
+ * Only VP8 and H264 (packetization mode 1) can be produced: the other
+ * codecs need layer information the packetizers cannot get from here.
+ */
+class RTCVideoEncoder : public RefCountInterface {
+ public:
+  /**
+   * (Re)configures the encoder. Called before the first frame and whenever
+   * the resolution or codec settings change.
+   */
+  virtual bool InitEncode(const RTCVideoEncoderSettings& settings,
+                          RTCVideoEncoderCallback* callback) = 0;
+
+  /**
+   * Encodes |frame|, an I420 frame, and passes the result to the callback,
+   * synchronously or later. Skipping the callback drops the frame.
+   * |key_frame| is set when a receiver asked for a key frame.
+   */
+  virtual bool Encode(scoped_refptr<RTCVideoFrame> frame, bool key_frame,
+                      uint32_t timestamp) = 0;
+
+  /**
+   * The rate the encoder should target from now on. 0 bps pauses the
+   * stream.
+   */
+  virtual void SetRates(uint32_t bitrate_bps, double framerate) = 0;
+
+  /**
+   * Stops encoding; InitEncode() may follow. Output still pending must be
+   * delivered or dropped before returning: the callback is invalid after.
+   */
+  virtual void Release() = 0;
+
+  // Shows up as the encoder implementation in stats.
+  virtual const string implementation_name() const = 0;
+
+ protected:
+  virtual ~RTCVideoEncoder() {}
+};
+
+class RTCVideoEncoderFactory : public RefCountInterface {
+ public:
+  /**
+   * A factory whose encoders produce VP8-framed frames of filler bytes at
+   * the target bitrate, without looking at the pixels. Paired with
+   * RTCVideoDecoderFactory::CreateNull() on the receiving side it benchmarks
+   * capture, packetization, transport and rendering without codec cost.
+   */
+  LIB_WEBRTC_API static scoped_refptr<RTCVideoEncoderFactory> CreateNull();
+
+  // The codecs offered in SDP, in order of preference.
+  virtual vector<RTCVideoCodecType> supported_codecs() const = 0;
+
+  virtual scoped_refptr<RTCVideoEncoder> Create(RTCVideoCodecType codec) = 0;
+
+ protected:
+  virtual ~RTCVideoEncoderFactory() {}
+};
+
+/**
+ * Receives the output of an RTCVideoDecoder. Implemented by the library;
+ * may be called on any thread.
+ */
+class RTCVideoDecoderCallback {
+ public:
+  /**
+   * Hands over one decoded frame. |timestamp| is the value passed to the
+   * Decode() call the frame belongs to. The frame may be any RTCVideoFrame;
+   * its planes are copied. Must not be called once the decoder's Release()
+   * has returned.
+   */
+  virtual void OnDecodedFrame(scoped_refptr<RTCVideoFrame> frame,
+                              uint32_t timestamp) = 0;
+
+ protected:
+  virtual ~RTCVideoDecoderCallback() {}
+};
+
+/**
+ * An application video decoder. Calls come from webrtc's decoder thread,
+ * one at a time.
+ */
+class RTCVideoDecoder : public RefCountInterface {
+ public:
+  virtual bool Configure(RTCVideoCodecType codec, int number_of_cores,
+                         RTCVideoDecoderCallback* callback) = 0;
+
+  /**
+   * Decodes one access unit and passes the frame to the callback,
+   * synchronously or later. Returning false makes the receiver ask for a
+   * key frame.
+   */
+  virtual bool Decode(const uint8_t* data, size_t size, bool key_frame,
+                      uint32_t timestamp) = 0;
+
+  /**
+   * Stops decoding; Configure() may follow. Frames still pending must be
+   * delivered or dropped before returning: the callback is invalid after.
+   */
+  virtual void Release() = 0;
+
+  virtual const string implementation_name() const = 0;
+
+ protected:
+  virtual ~RTCVideoDecoder() {}
+};
+
+class RTCVideoDecoderFactory : public RefCountInterface {
+ public:
+  /**
+   * A factory whose VP8 decoders output black frames of the encoded size
+   * without decoding. See RTCVideoEncoderFactory::CreateNull().
+   */
+  LIB_WEBRTC_API static scoped_refptr<RTCVideoDecoderFactory> CreateNull();
+
+  virtual vector<RTCVideoCodecType> supported_codecs() const = 0;
+
+  virtual scoped_refptr<RTCVideoDecoder> Create(RTCVideoCodecType codec) = 0;
+
+ protected:
+  virtual ~RTCVideoDecoderFactory() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_VIDEO_CODEC_HXX
@@ -0,0 +1,77 @@
+#ifndef LIB_WEBRTC_RTC_VIDEO_RECORDER_HXX
+#define LIB_WEBRTC_RTC_VIDEO_RECORDER_HXX
+
+#include "rtc_rtp_receiver.h"
+#include "rtc_rtp_sender.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+struct RTCVideoRecorderOptions {
+  /**
+   * Start a new file at the next key frame once the current one holds this
+   * many bytes or this much time. 0 means no limit. Rotated files are named
+   * after the first with a counter before the extension: rec.ivf, rec.1.ivf,
+   * rec.2.ivf, ...
+   */
+  uint64_t max_file_bytes = 0;
+  int max_file_duration_ms = 0;
+
+  /**
+   * Encoded bytes the writer thread may fall behind before new frames are
+   * dropped. After a drop the recording resumes at the next key frame.
+   */
+  size_t max_buffered_bytes = 8 * 1024 * 1024;
+};
+
+/**
+ * Records the encoded video of an RTCRtpReceiver or RTCRtpSender to IVF
+ * files, as it is received or sent, without decoding or re-encoding.
+ *
+ * The media thread only queues the frame; a writer thread does the file
+ * I/O. Each file starts with a key frame and is playable on its own. The
+ * frame timestamps are in milliseconds.
+ */
+class RTCVideoRecorder : public RefCountInterface {
+ public:
+  /**
+   * Records the frames |receiver| hands to its decoder. The receiver asks
+   * the remote sender for a key frame to start with.
+   * @return null for audio receivers or if |path| cannot be created.
+   */
+  LIB_WEBRTC_API static scoped_refptr<RTCVideoRecorder> Create(
+      scoped_refptr<RTCRtpReceiver> receiver, const string path,
+      const RTCVideoRecorderOptions& options = RTCVideoRecorderOptions());
+
+  /**
+   * Records the frames |sender| gets from its encoder. This takes the
+   * sender's frame transformer slot, so it replaces a frame transformer or
+   * frame cryptor set on it, and copies each frame once.
+   * @return null for audio senders or if |path| cannot be created.
+   */
+  LIB_WEBRTC_API static scoped_refptr<RTCVideoRecorder> Create(
+      scoped_refptr<RTCRtpSender> sender, const string path,
+      const RTCVideoRecorderOptions& options = RTCVideoRecorderOptions());
+
+  /**
+   * Stops taking frames, writes the queued ones, finishes the file and stops
+   * the writer thread. Also done on destruction.
+   */
+  virtual void Close() = 0;
+
+  virtual uint64_t frames_written() const = 0;
+
+  // Frames dropped because the queue was full, or while waiting for a key
+  // frame after such a drop or at the start.
+  virtual uint64_t frames_dropped() const = 0;
+
+  // Files created so far, 1 + the number of rotations.
+  virtual int files_written() const = 0;
+
+ protected:
+  virtual ~RTCVideoRecorder() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_VIDEO_RECORDER_HXX
@@ -0,0 +1,54 @@
+#ifndef LIB_WEBRTC_RTC_VIDEO_RELAY_HXX
+#define LIB_WEBRTC_RTC_VIDEO_RELAY_HXX
+
+#include "rtc_rtp_receiver.h"
+#include "rtc_rtp_sender.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+/**
+ * Forwards the encoded video of one RTCRtpReceiver to any number of
+ * RTCRtpSenders, typically of other peer connections in the same process,
+ * without transcoding. Frames are shared between the senders, not copied.
+ *
+ * Each sender gets a track of its own. A new sender starts right away with
+ * the last received key frame, which its remote peer shows as a still
+ * picture, and asks upstream for a fresh one. Delta frames are only
+ * forwarded to it from that fresh key frame on, since the deltas after the
+ * cached one reference frames it never got. Key frame requests (PLI/FIR)
+ * of the senders' remote peers are sent upstream, at most once per
+ * |min_key_frame_request_interval_ms|.
+ *
+ * The senders must negotiate the relay's codec; see RTCEncodedVideoSource
+ * for the other restrictions of sending encoded video.
+ *
+ * Created by RTCPeerConnectionFactory::CreateVideoRelay().
+ */
+class RTCVideoRelay : public RefCountInterface {
+ public:
+  /**
+   * Replaces the track of |sender| with a relayed track.
+   * @return false for audio senders or a sender that is already added.
+   */
+  virtual bool AddSender(scoped_refptr<RTCRtpSender> sender) = 0;
+
+  /**
+   * Stops relaying to |sender| and removes its track.
+   */
+  virtual void RemoveSender(scoped_refptr<RTCRtpSender> sender) = 0;
+
+  virtual size_t num_senders() const = 0;
+
+  // Frames received from the receiver and key frames requested upstream.
+  virtual uint64_t frames_received() const = 0;
+
+  virtual uint64_t key_frame_requests() const = 0;
+
+ protected:
+  virtual ~RTCVideoRelay() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_VIDEO_RELAY_HXX
@@ -8,6 +8,23 @@
 
 namespace libwebrtc {
 
+/**
+ * What the encoder should preserve for a video track, in the order of
+ * webrtc::VideoTrackInterface::ContentHint.
+ */
+enum class RTCVideoContentHint {
+  // Decided by the source: screen sources are detailed, cameras fluid.
+  kNone,
+  // Motion: camera encoding, frame rate kept over resolution, even for
+  // screen shares of video.
+  kFluid,
+  // Detail: screen content encoding with the screencast minimum bitrate,
+  // resolution kept over frame rate.
+  kDetailed,
+  // Text: like kDetailed, for content where sharpness matters most.
+  kText,
+};
+
 class RTCVideoTrack : public RTCMediaTrack {
  public:
   virtual void AddRenderer(
@@ -16,6 +33,14 @@ class RTCVideoTrack : public RTCMediaTrack {
   virtual void RemoveRenderer(
       RTCVideoRenderer<scoped_refptr<RTCVideoFrame>>* renderer) = 0;
 
+  /**
+   * Changes how senders of this track encode it; takes effect on the
+   * senders' next frames.
+   */
+  virtual void set_content_hint(RTCVideoContentHint hint) = 0;
+
+  virtual RTCVideoContentHint content_hint() const = 0;
+
  protected:
   ~RTCVideoTrack() {}
 };
@@ -0,0 +1,53 @@
+#ifndef LIB_WEBRTC_RTC_WAV_FILE_SINK_HXX
+#define LIB_WEBRTC_RTC_WAV_FILE_SINK_HXX
+
+#include "rtc_audio_track.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+/**
+ * An RTCAudioTrackSink that records to a 16-bit PCM WAV file.
+ *
+ * The audio thread only copies each frame into a bounded queue; a writer
+ * thread does the file I/O. When the writer falls more than
+ * |max_buffered_ms| behind, new frames are dropped and counted instead of
+ * blocking the audio thread.
+ *
+ * Attach it with the format it was created for, e.g.
+ * track->AddSink(sink.get(), sink->sample_rate_hz(), sink->num_channels());
+ * frames in any other format are dropped.
+ */
+class RTCWavFileSink : public RTCAudioTrackSink, public RefCountInterface {
+ public:
+  /**
+   * Creates |path| and starts the writer thread.
+   * @return null if the file cannot be created.
+   */
+  LIB_WEBRTC_API static scoped_refptr<RTCWavFileSink> Create(
+      const string path, int sample_rate_hz = 48000, size_t num_channels = 1,
+      int max_buffered_ms = 2000);
+
+  /**
+   * Writes the queued audio, finalizes the WAV header and stops the writer
+   * thread. Remove the sink from its tracks first. Also done on destruction.
+   */
+  virtual void Close() = 0;
+
+  virtual int sample_rate_hz() const = 0;
+
+  virtual size_t num_channels() const = 0;
+
+  // 10 ms frames written to the file so far.
+  virtual uint64_t frames_written() const = 0;
+
+  // 10 ms frames dropped because the queue was full or the format differed.
+  virtual uint64_t frames_dropped() const = 0;
+
+ protected:
+  virtual ~RTCWavFileSink() {}
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_RTC_WAV_FILE_SINK_HXX
@@ -0,0 +1,179 @@
+#include "src/internal/audio_level_meter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace libwebrtc {
+
+namespace {
+
+// Voice activity is held this many 10 ms frames after the last voiced one.
+const int kVoiceHangoverFrames = 20;
+
+// The level must fall this far below the threshold (about 3 dB) before a
+// "below" event, so a level hovering at the threshold does not chatter.
+const float kThresholdHysteresis = 0.7071f;
+
+// Sum of squares and largest magnitude of |length| samples.
+void MeasureSamples(const int16_t* data, size_t length, uint64_t* energy,
+                    int32_t* peak) {
+  uint64_t sum = 0;
+  int32_t max_value = 0;
+  int32_t min_value = 0;
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum64 = _mm_setzero_si128();
+  __m128i max16 = _mm_setzero_si128();
+  __m128i min16 = _mm_setzero_si128();
+  for (; i + 8 <= length; i += 8) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // Each pair sum is at most 2^31, which is exact as an unsigned 32-bit
+    // value; widen to 64 bits before accumulating.
+    __m128i squares = _mm_madd_epi16(x, x);
+    sum64 = _mm_add_epi64(sum64, _mm_unpacklo_epi32(squares, zero));
+    sum64 = _mm_add_epi64(sum64, _mm_unpackhi_epi32(squares, zero));
+    max16 = _mm_max_epi16(max16, x);
+    min16 = _mm_min_epi16(min16, x);
+  }
+  alignas(16) uint64_t sums[2];
+  alignas(16) int16_t maxs[8];
+  alignas(16) int16_t mins[8];
+  _mm_store_si128(reinterpret_cast<__m128i*>(sums), sum64);
+  _mm_store_si128(reinterpret_cast<__m128i*>(maxs), max16);
+  _mm_store_si128(reinterpret_cast<__m128i*>(mins), min16);
+  sum = sums[0] + sums[1];
+  for (int j = 0; j < 8; ++j) {
+    max_value = std::max<int32_t>(max_value, maxs[j]);
+    min_value = std::min<int32_t>(min_value, mins[j]);
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  uint64x2_t sum64 = vdupq_n_u64(0);
+  int16x8_t max16 = vdupq_n_s16(0);
+  int16x8_t min16 = vdupq_n_s16(0);
+  for (; i + 8 <= length; i += 8) {
+    int16x8_t x = vld1q_s16(data + i);
+    int16x4_t lo = vget_low_s16(x);
+    int16x4_t hi = vget_high_s16(x);
+    sum64 = vpadalq_u32(sum64, vreinterpretq_u32_s32(vmull_s16(lo, lo)));
+    sum64 = vpadalq_u32(sum64, vreinterpretq_u32_s32(vmull_s16(hi, hi)));
+    max16 = vmaxq_s16(max16, x);
+    min16 = vminq_s16(min16, x);
+  }
+  sum = vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1);
+  int16_t maxs[8];
+  int16_t mins[8];
+  vst1q_s16(maxs, max16);
+  vst1q_s16(mins, min16);
+  for (int j = 0; j < 8; ++j) {
+    max_value = std::max<int32_t>(max_value, maxs[j]);
+    min_value = std::min<int32_t>(min_value, mins[j]);
+  }
+#endif
+  for (; i < length; ++i) {
+    sum += static_cast<uint64_t>(data[i] * data[i]);
+    max_value = std::max<int32_t>(max_value, data[i]);
+    min_value = std::min<int32_t>(min_value, data[i]);
+  }
+  *energy = sum;
+  *peak = std::max(max_value, -min_value);
+}
+
+}  // namespace
+
+AudioLevelMeter::AudioLevelMeter() {
+  vad_ = WebRtcVad_Create();
+  if (vad_ && (WebRtcVad_Init(vad_) != 0 || WebRtcVad_set_mode(vad_, 1))) {
+    WebRtcVad_Free(vad_);
+    vad_ = nullptr;
+  }
+}
+
+AudioLevelMeter::~AudioLevelMeter() {
+  if (vad_) {
+    WebRtcVad_Free(vad_);
+  }
+}
+
+int AudioLevelMeter::Process(const int16_t* data, int sample_rate_hz,
+                             size_t num_channels,
+                             size_t samples_per_channel) {
+  const size_t length = samples_per_channel * num_channels;
+  if (length == 0) {
+    return kNoEvents;
+  }
+  uint64_t energy = 0;
+  int32_t peak = 0;
+  MeasureSamples(data, length, &energy, &peak);
+  const float rms =
+      std::sqrt(static_cast<float>(energy) / length) / 32768.0f;
+  rms_ = rms;
+  peak_ = peak / 32768.0f;
+
+  int events = kNoEvents;
+  const float threshold = threshold_;
+  if (threshold > 0.0f) {
+    const bool above = above_threshold_;
+    if (!above && rms >= threshold) {
+      above_threshold_ = true;
+      events |= kThresholdCrossed;
+    } else if (above && rms < threshold * kThresholdHysteresis) {
+      above_threshold_ = false;
+      events |= kThresholdCrossed;
+    }
+  }
+
+  if (vad_ && WebRtcVad_ValidRateAndFrameLength(sample_rate_hz,
+                                                samples_per_channel) == 0) {
+    const int16_t* mono = data;
+    if (num_channels > 1) {
+      mono_.resize(samples_per_channel);
+      for (size_t i = 0; i < samples_per_channel; ++i) {
+        int32_t sum = 0;
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+          sum += data[i * num_channels + ch];
+        }
+        mono_[i] =
+            static_cast<int16_t>(sum / static_cast<int32_t>(num_channels));
+      }
+      mono = mono_.data();
+    }
+    if (WebRtcVad_Process(vad_, sample_rate_hz, mono, samples_per_channel) ==
+        1) {
+      hangover_frames_ = kVoiceHangoverFrames;
+    } else if (hangover_frames_ > 0) {
+      --hangover_frames_;
+    }
+    const bool voice_active = hangover_frames_ > 0;
+    if (voice_active != voice_active_) {
+      voice_active_ = voice_active;
+      events |= kVoiceActivityChanged;
+    }
+  }
+  return events;
+}
+
+void AudioLevelMeter::Reset() {
+  rms_ = 0.0f;
+  peak_ = 0.0f;
+  voice_active_ = false;
+  above_threshold_ = false;
+}
+
+RTCAudioLevel AudioLevelMeter::level() const {
+  RTCAudioLevel level;
+  level.rms = rms_;
+  level.peak = peak_;
+  level.voice_active = voice_active_;
+  return level;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,54 @@
+#ifndef INTERNAL_AUDIO_LEVEL_METER_HXX
+#define INTERNAL_AUDIO_LEVEL_METER_HXX
+
+#include <atomic>
+#include <vector>
+
+#include "common_audio/vad/include/webrtc_vad.h"
+#include "rtc_audio_track.h"
+
+namespace libwebrtc {
+
+// Measures RMS, peak and voice activity of 10 ms PCM frames. Process() runs
+// on the audio thread; the results are published through atomics so any
+// thread can read them without locking.
+class AudioLevelMeter {
+ public:
+  enum Events {
+    kNoEvents = 0,
+    kThresholdCrossed = 1 << 0,
+    kVoiceActivityChanged = 1 << 1,
+  };
+
+  AudioLevelMeter();
+  ~AudioLevelMeter();
+
+  // Returns the Events raised by this frame.
+  int Process(const int16_t* data, int sample_rate_hz, size_t num_channels,
+              size_t samples_per_channel);
+
+  // Clears the published level, e.g. when metering stops.
+  void Reset();
+
+  RTCAudioLevel level() const;
+
+  bool above_threshold() const { return above_threshold_; }
+
+  void set_threshold(float rms_threshold) { threshold_ = rms_threshold; }
+
+ private:
+  std::atomic<float> rms_{0.0f};
+  std::atomic<float> peak_{0.0f};
+  std::atomic<bool> voice_active_{false};
+  std::atomic<bool> above_threshold_{false};
+  std::atomic<float> threshold_{0.0f};
+
+  // Only used by Process().
+  VadInst* vad_ = nullptr;
+  int hangover_frames_ = 0;
+  std::vector<int16_t> mono_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_AUDIO_LEVEL_METER_HXX
@@ -0,0 +1,114 @@
+#include "src/internal/audio_mix.h"
+
+#include <algorithm>
+
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace libwebrtc {
+
+namespace audio_mix_internal {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void MixWithGain_SSE2(const int16_t* src, int16_t gain_q14, size_t length,
+                      int16_t* dst) {
+  size_t i = 0;
+  if (gain_q14 == kMixUnityGainQ14) {
+    for (; i + 8 <= length; i += 8) {
+      __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_adds_epi16(d, s));
+    }
+  } else {
+    const __m128i gain = _mm_set1_epi16(gain_q14);
+    const __m128i round = _mm_set1_epi32(1 << 13);
+    for (; i + 8 <= length; i += 8) {
+      __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+      // Full 32-bit products from the low and high halves.
+      __m128i lo = _mm_mullo_epi16(s, gain);
+      __m128i hi = _mm_mulhi_epi16(s, gain);
+      __m128i p0 = _mm_srai_epi32(
+          _mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 14);
+      __m128i p1 = _mm_srai_epi32(
+          _mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 14);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_adds_epi16(d, _mm_packs_epi32(p0, p1)));
+    }
+  }
+  MixWithGain_C(src + i, gain_q14, length - i, dst + i);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void MixWithGain_NEON(const int16_t* src, int16_t gain_q14, size_t length,
+                      int16_t* dst) {
+  size_t i = 0;
+  if (gain_q14 == kMixUnityGainQ14) {
+    for (; i + 8 <= length; i += 8) {
+      vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), vld1q_s16(src + i)));
+    }
+  } else {
+    const int16x4_t gain = vdup_n_s16(gain_q14);
+    for (; i + 8 <= length; i += 8) {
+      int16x8_t s = vld1q_s16(src + i);
+      int16x8_t scaled =
+          vcombine_s16(vqrshrn_n_s32(vmull_s16(vget_low_s16(s), gain), 14),
+                       vqrshrn_n_s32(vmull_s16(vget_high_s16(s), gain), 14));
+      vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), scaled));
+    }
+  }
+  MixWithGain_C(src + i, gain_q14, length - i, dst + i);
+}
+#endif
+
+}  // namespace audio_mix_internal
+
+namespace {
+
+typedef void (*MixFunction)(const int16_t*, int16_t, size_t, int16_t*);
+
+MixFunction SelectMixFunction() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(WEBRTC_ENABLE_AVX2)
+  if (webrtc::GetCPUInfo(webrtc::kAVX2) != 0) {
+    return audio_mix_internal::MixWithGain_AVX2;
+  }
+#endif
+  return audio_mix_internal::MixWithGain_SSE2;
+#elif defined(WEBRTC_HAS_NEON)
+  return audio_mix_internal::MixWithGain_NEON;
+#else
+  return audio_mix_internal::MixWithGain_C;
+#endif
+}
+
+}  // namespace
+
+int16_t MixGainToQ14(float gain) {
+  float scaled = gain * kMixUnityGainQ14 + 0.5f;
+  return static_cast<int16_t>(std::min(32767.f, std::max(0.f, scaled)));
+}
+
+void MixWithGain(const int16_t* src, int16_t gain_q14, size_t length,
+                 int16_t* dst) {
+  static const MixFunction mix = SelectMixFunction();
+  mix(src, gain_q14, length, dst);
+}
+
+uint64_t MixEnergy(const int16_t* src, size_t length) {
+  uint64_t energy = 0;
+  for (size_t i = 0; i < length; ++i) {
+    energy += static_cast<uint64_t>(src[i] * src[i]);
+  }
+  return energy;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,39 @@
+#ifndef INTERNAL_AUDIO_MIX_HXX
+#define INTERNAL_AUDIO_MIX_HXX
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace libwebrtc {
+
+// Unity gain for MixWithGain(). Gains are Q14, so the largest is just under 2.
+const int16_t kMixUnityGainQ14 = 1 << 14;
+
+// Converts a linear gain to Q14, clamped to [0, 2).
+int16_t MixGainToQ14(float gain);
+
+// dst[i] = saturate(dst[i] + round(src[i] * gain_q14 / 2^14)).
+// Picks the AVX2, SSE2 or NEON kernel at runtime and falls back to plain C.
+void MixWithGain(const int16_t* src, int16_t gain_q14, size_t length,
+                 int16_t* dst);
+
+// Sum of squared samples, used to rank sources by loudness.
+uint64_t MixEnergy(const int16_t* src, size_t length);
+
+// The kernels. The plain C and AVX2 ones have no webrtc dependencies, so
+// test/ can build and time them on their own.
+namespace audio_mix_internal {
+
+void MixWithGain_C(const int16_t* src, int16_t gain_q14, size_t length,
+                   int16_t* dst);
+#if defined(WEBRTC_ENABLE_AVX2)
+// Built with AVX2 enabled; only call when the CPU supports it.
+void MixWithGain_AVX2(const int16_t* src, int16_t gain_q14, size_t length,
+                      int16_t* dst);
+#endif
+
+}  // namespace audio_mix_internal
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_AUDIO_MIX_HXX
@@ -0,0 +1,46 @@
+#include <immintrin.h>
+
+#include "src/internal/audio_mix.h"
+
+namespace libwebrtc {
+
+namespace audio_mix_internal {
+
+void MixWithGain_AVX2(const int16_t* src, int16_t gain_q14, size_t length,
+                      int16_t* dst) {
+  size_t i = 0;
+  if (gain_q14 == kMixUnityGainQ14) {
+    for (; i + 16 <= length; i += 16) {
+      __m256i s =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      __m256i d =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_adds_epi16(d, s));
+    }
+  } else {
+    const __m256i gain = _mm256_set1_epi16(gain_q14);
+    const __m256i round = _mm256_set1_epi32(1 << 13);
+    for (; i + 16 <= length; i += 16) {
+      __m256i s =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      __m256i d =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+      __m256i lo = _mm256_mullo_epi16(s, gain);
+      __m256i hi = _mm256_mulhi_epi16(s, gain);
+      // Unpack and pack both work per 128-bit lane, so the sample order is
+      // restored by the pack.
+      __m256i p0 = _mm256_srai_epi32(
+          _mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), round), 14);
+      __m256i p1 = _mm256_srai_epi32(
+          _mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), round), 14);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                          _mm256_adds_epi16(d, _mm256_packs_epi32(p0, p1)));
+    }
+  }
+  MixWithGain_C(src + i, gain_q14, length - i, dst + i);
+}
+
+}  // namespace audio_mix_internal
+
+}  // namespace libwebrtc
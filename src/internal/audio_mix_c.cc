@@ -0,0 +1,22 @@
+#include <algorithm>
+
+#include "src/internal/audio_mix.h"
+
+namespace libwebrtc {
+
+namespace audio_mix_internal {
+
+void MixWithGain_C(const int16_t* src, int16_t gain_q14, size_t length,
+                   int16_t* dst) {
+  for (size_t i = 0; i < length; ++i) {
+    // Saturate the scaled sample first, like the vector kernels do.
+    int32_t scaled = (src[i] * gain_q14 + (1 << 13)) >> 14;
+    scaled = std::min(32767, std::max(-32768, scaled));
+    int32_t sum = dst[i] + scaled;
+    dst[i] = static_cast<int16_t>(std::min(32767, std::max(-32768, sum)));
+  }
+}
+
+}  // namespace audio_mix_internal
+
+}  // namespace libwebrtc
@@ -0,0 +1,144 @@
+#include "src/internal/cpu_usage_resource.h"
+
+#include <algorithm>
+
+#include "api/task_queue/default_task_queue_factory.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/cpu_info.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace libwebrtc {
+
+namespace {
+
+// Samples in a row that have to be above the high threshold before the
+// senders are degraded, and below the low threshold before they are
+// restored. Restoring is slower so that a restored sender does not push the
+// usage straight back up.
+const int kOveruseSamples = 2;
+const int kUnderuseSamples = 3;
+
+// User plus kernel CPU time of the process, or -1.
+int64_t ProcessCpuTimeUs() {
+#if defined(WEBRTC_WIN)
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel,
+                       &user)) {
+    return -1;
+  }
+  ULARGE_INTEGER kernel_time, user_time;
+  kernel_time.LowPart = kernel.dwLowDateTime;
+  kernel_time.HighPart = kernel.dwHighDateTime;
+  user_time.LowPart = user.dwLowDateTime;
+  user_time.HighPart = user.dwHighDateTime;
+  // FILETIME counts 100 ns intervals.
+  return static_cast<int64_t>((kernel_time.QuadPart + user_time.QuadPart) /
+                              10);
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+             rtc::kNumMicrosecsPerSec +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+}  // namespace
+
+CpuUsageResource::CpuUsageResource() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+CpuUsageResource::~CpuUsageResource() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+void CpuUsageResource::SetResourceListener(
+    webrtc::ResourceListener* listener) {
+  webrtc::MutexLock lock(&mutex_);
+  listener_ = listener;
+}
+
+void CpuUsageResource::Report(webrtc::ResourceUsageState state) {
+  webrtc::MutexLock lock(&mutex_);
+  if (listener_) {
+    // The listener posts to the adaptation queue, so holding |mutex_| cannot
+    // deadlock with SetResourceListener().
+    listener_->OnResourceUsageStateMeasured(
+        rtc::scoped_refptr<webrtc::Resource>(this), state);
+  }
+}
+
+CpuUsageSampler::CpuUsageSampler(const RTCCpuOveruseSettings& settings)
+    : high_threshold_percent_(settings.high_threshold_percent),
+      low_threshold_percent_(settings.low_threshold_percent > 0
+                                 ? settings.low_threshold_percent
+                                 : settings.high_threshold_percent / 2),
+      interval_ms_(std::max(settings.interval_ms, 100)),
+      number_of_cores_(
+          std::max(static_cast<int>(webrtc::CpuInfo::DetectNumberOfCores()),
+                   1)),
+      resource_(rtc::make_ref_counted<CpuUsageResource>()),
+      task_queue_factory_(webrtc::CreateDefaultTaskQueueFactory()),
+      task_queue_(task_queue_factory_->CreateTaskQueue(
+          "cpu_usage_sampler", webrtc::TaskQueueFactory::Priority::NORMAL)) {
+  task_queue_->PostTask([this] {
+    timer_ = webrtc::RepeatingTaskHandle::Start(task_queue_.get(), [this] {
+      Sample();
+      return webrtc::TimeDelta::Millis(interval_ms_);
+    });
+  });
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+CpuUsageSampler::~CpuUsageSampler() {
+  // Waits for a running sample; later ones are dropped with the queue.
+  // |resource_| is released after that, on this thread.
+  task_queue_ = nullptr;
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+void CpuUsageSampler::Sample() {
+  const int64_t wall_time_us = rtc::TimeMicros();
+  const int64_t cpu_time_us = ProcessCpuTimeUs();
+  if (cpu_time_us < 0) {
+    return;
+  }
+  const int64_t elapsed_us = wall_time_us - last_wall_time_us_;
+  const bool first = last_wall_time_us_ < 0;
+  const int64_t used_us = cpu_time_us - last_cpu_time_us_;
+  last_wall_time_us_ = wall_time_us;
+  last_cpu_time_us_ = cpu_time_us;
+  if (first || elapsed_us <= 0) {
+    return;
+  }
+
+  const int usage_percent =
+      static_cast<int>(100 * used_us / (elapsed_us * number_of_cores_));
+  if (usage_percent > high_threshold_percent_) {
+    samples_below_ = 0;
+    if (++samples_above_ >= kOveruseSamples) {
+      samples_above_ = 0;
+      resource_->Report(webrtc::ResourceUsageState::kOveruse);
+    }
+  } else if (usage_percent < low_threshold_percent_) {
+    samples_above_ = 0;
+    if (++samples_below_ >= kUnderuseSamples) {
+      samples_below_ = 0;
+      resource_->Report(webrtc::ResourceUsageState::kUnderuse);
+    }
+  } else {
+    samples_above_ = 0;
+    samples_below_ = 0;
+  }
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,69 @@
+#ifndef INTERNAL_CPU_USAGE_RESOURCE_HXX
+#define INTERNAL_CPU_USAGE_RESOURCE_HXX
+
+#include <memory>
+#include <string>
+
+#include "api/adaptation/resource.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "rtc_types.h"
+
+namespace libwebrtc {
+
+// Reports overuse and underuse of the CPU to webrtc's resource adaptation,
+// which degrades or restores the video senders of the peer connection it is
+// added to. Measurements come from a CpuUsageSampler.
+class CpuUsageResource : public webrtc::Resource {
+ public:
+  CpuUsageResource();
+  ~CpuUsageResource() override;
+
+  // webrtc::Resource
+  std::string Name() const override { return "CpuUsageResource"; }
+  void SetResourceListener(webrtc::ResourceListener* listener) override;
+
+  void Report(webrtc::ResourceUsageState state);
+
+ private:
+  webrtc::Mutex mutex_;
+  webrtc::ResourceListener* listener_ RTC_GUARDED_BY(mutex_) = nullptr;
+};
+
+// Samples the CPU usage of the whole process on a task queue of its own and
+// reports to a CpuUsageResource. See RTCCpuOveruseSettings. The sampler
+// holds a reference to the resource until its queue is gone, so the
+// resource is never released on that queue.
+class CpuUsageSampler {
+ public:
+  explicit CpuUsageSampler(const RTCCpuOveruseSettings& settings);
+  ~CpuUsageSampler();
+
+  rtc::scoped_refptr<CpuUsageResource> resource() const { return resource_; }
+
+ private:
+  // Runs every |interval_ms_| on |task_queue_|.
+  void Sample();
+
+  const int high_threshold_percent_;
+  const int low_threshold_percent_;
+  const int interval_ms_;
+  const int number_of_cores_;
+  const rtc::scoped_refptr<CpuUsageResource> resource_;
+
+  // Only accessed on |task_queue_|.
+  int64_t last_wall_time_us_ = -1;
+  int64_t last_cpu_time_us_ = -1;
+  int samples_above_ = 0;
+  int samples_below_ = 0;
+  webrtc::RepeatingTaskHandle timer_;
+  std::unique_ptr<webrtc::TaskQueueFactory> task_queue_factory_;
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter> task_queue_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_CPU_USAGE_RESOURCE_HXX
@@ -0,0 +1,77 @@
+#include "src/internal/custom_audio_source.h"
+
+#include <algorithm>
+
+#include "rtc_base/logging.h"
+
+namespace libwebrtc {
+
+void CustomAudioSource::AddSink(webrtc::AudioTrackSinkInterface* sink) {
+  webrtc::MutexLock lock(&mutex_);
+  if (std::find(sinks_.begin(), sinks_.end(), sink) == sinks_.end()) {
+    sinks_.push_back(sink);
+  }
+}
+
+void CustomAudioSource::RemoveSink(webrtc::AudioTrackSinkInterface* sink) {
+  // Waits for a delivery in progress, so |sink| is not called afterwards.
+  webrtc::MutexLock lock(&mutex_);
+  sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sink), sinks_.end());
+}
+
+void CustomAudioSource::PushFrame(const webrtc::AudioFrame& frame) {
+  PushData(frame.data(), frame.samples_per_channel(), frame.sample_rate_hz(),
+           frame.num_channels());
+}
+
+void CustomAudioSource::PushData(const int16_t* data,
+                                 size_t samples_per_channel,
+                                 int sample_rate_hz, size_t num_channels) {
+  if (sample_rate_hz <= 0 || num_channels == 0) {
+    RTC_LOG(LS_WARNING) << "Dropping audio frame with invalid format.";
+    return;
+  }
+  const size_t chunk_samples = sample_rate_hz / 100;
+  size_t samples = samples_per_channel;
+
+  webrtc::MutexLock lock(&mutex_);
+  if (sample_rate_hz != pending_sample_rate_hz_ ||
+      num_channels != pending_num_channels_) {
+    pending_.clear();
+    pending_sample_rate_hz_ = sample_rate_hz;
+    pending_num_channels_ = num_channels;
+  }
+
+  // Top up a partial chunk left from the previous push.
+  if (!pending_.empty()) {
+    size_t missing = chunk_samples - pending_.size() / num_channels;
+    size_t take = std::min(missing, samples);
+    pending_.insert(pending_.end(), data, data + take * num_channels);
+    data += take * num_channels;
+    samples -= take;
+    if (take < missing) {
+      return;
+    }
+    DeliverChunk(pending_.data(), sample_rate_hz, num_channels,
+                 chunk_samples);
+    pending_.clear();
+  }
+
+  while (samples >= chunk_samples) {
+    DeliverChunk(data, sample_rate_hz, num_channels, chunk_samples);
+    data += chunk_samples * num_channels;
+    samples -= chunk_samples;
+  }
+  pending_.assign(data, data + samples * num_channels);
+}
+
+void CustomAudioSource::DeliverChunk(const int16_t* data, int sample_rate_hz,
+                                     size_t num_channels,
+                                     size_t samples_per_channel) {
+  for (webrtc::AudioTrackSinkInterface* sink : sinks_) {
+    sink->OnData(data, 16, sample_rate_hz, num_channels, samples_per_channel,
+                 absl::nullopt);
+  }
+}
+
+}  // namespace libwebrtc
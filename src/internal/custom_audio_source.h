@@ -0,0 +1,55 @@
+#ifndef INTERNAL_CUSTOM_AUDIO_SOURCE_HXX
+#define INTERNAL_CUSTOM_AUDIO_SOURCE_HXX
+
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/media_stream_interface.h"
+#include "api/notifier.h"
+#include "rtc_base/synchronization/mutex.h"
+
+namespace libwebrtc {
+
+// An audio source fed by the application instead of the audio device.
+// Pushed PCM goes straight to the track sinks, i.e. the send streams of the
+// senders using the track, in 10 ms chunks.
+class CustomAudioSource
+    : public webrtc::Notifier<webrtc::AudioSourceInterface> {
+ public:
+  CustomAudioSource() {}
+
+  SourceState state() const override { return kLive; }
+
+  bool remote() const override { return false; }
+
+  void AddSink(webrtc::AudioTrackSinkInterface* sink) override;
+
+  void RemoveSink(webrtc::AudioTrackSinkInterface* sink) override;
+
+  // Delivers |frame| to the sinks on the calling thread. Frames that are not
+  // 10 ms long are re-chunked; a partial tail is kept for the next push.
+  void PushFrame(const webrtc::AudioFrame& frame);
+
+  // Same as PushFrame() for interleaved samples that are not in an
+  // AudioFrame, e.g. a mapped file.
+  void PushData(const int16_t* data, size_t samples_per_channel,
+                int sample_rate_hz, size_t num_channels);
+
+ protected:
+  ~CustomAudioSource() override {}
+
+ private:
+  void DeliverChunk(const int16_t* data, int sample_rate_hz,
+                    size_t num_channels, size_t samples_per_channel)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  webrtc::Mutex mutex_;
+  std::vector<webrtc::AudioTrackSinkInterface*> sinks_ RTC_GUARDED_BY(mutex_);
+  std::vector<int16_t> pending_ RTC_GUARDED_BY(mutex_);
+  int pending_sample_rate_hz_ RTC_GUARDED_BY(mutex_) = 0;
+  size_t pending_num_channels_ RTC_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_CUSTOM_AUDIO_SOURCE_HXX
@@ -0,0 +1,120 @@
+#include "src/internal/desktop_capture_scheduler.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+
+namespace libwebrtc {
+
+struct DesktopCaptureScheduler::Job::Worker {
+  std::unique_ptr<rtc::Thread> thread;
+  // Guarded by the scheduler's mutex.
+  size_t jobs = 0;
+};
+
+DesktopCaptureScheduler::Job::Job(DesktopCaptureScheduler* scheduler,
+                                  std::shared_ptr<Worker> worker,
+                                  const std::string& name)
+    : scheduler_(scheduler),
+      worker_(std::move(worker)),
+      safety_(webrtc::PendingTaskSafetyFlag::CreateDetached()) {
+  stats_.name = name;
+}
+
+DesktopCaptureScheduler::Job::~Job() {
+  // The flag is only touched on the worker thread; once this returns no task
+  // of this job can start.
+  thread()->BlockingCall([this] { safety_->SetNotAlive(); });
+  scheduler_->RemoveJob(this);
+}
+
+void DesktopCaptureScheduler::Job::PostDelayedTask(
+    absl::AnyInvocable<void() &&> task, webrtc::TimeDelta delay) {
+  const int64_t deadline_us = rtc::TimeMicros() + delay.us();
+  auto timed_task = [this, deadline_us, task = std::move(task)]() mutable {
+    const int64_t start_us = rtc::TimeMicros();
+    std::move(task)();
+    RecordRun(deadline_us, start_us, rtc::TimeMicros());
+  };
+  if (delay.IsZero()) {
+    thread()->PostTask(webrtc::SafeTask(safety_, std::move(timed_task)));
+  } else {
+    thread()->PostDelayedHighPrecisionTask(
+        webrtc::SafeTask(safety_, std::move(timed_task)), delay);
+  }
+}
+
+void DesktopCaptureScheduler::Job::RecordRun(int64_t deadline_us,
+                                             int64_t start_us,
+                                             int64_t end_us) {
+  const int64_t run_time_us = end_us - start_us;
+  const int64_t delay_us = std::max<int64_t>(0, start_us - deadline_us);
+  webrtc::MutexLock lock(&mutex_);
+  stats_.runs++;
+  stats_.total_run_time_us += run_time_us;
+  stats_.max_run_time_us = std::max(stats_.max_run_time_us, run_time_us);
+  stats_.total_delay_us += delay_us;
+  stats_.max_delay_us = std::max(stats_.max_delay_us, delay_us);
+}
+
+DesktopCaptureScheduler::JobStats DesktopCaptureScheduler::Job::stats() const {
+  webrtc::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+DesktopCaptureScheduler* DesktopCaptureScheduler::Instance() {
+  static DesktopCaptureScheduler* scheduler = new DesktopCaptureScheduler();
+  return scheduler;
+}
+
+void DesktopCaptureScheduler::SetMaxThreads(size_t max_threads) {
+  webrtc::MutexLock lock(&mutex_);
+  max_threads_ = std::max<size_t>(1, max_threads);
+}
+
+std::unique_ptr<DesktopCaptureScheduler::Job>
+DesktopCaptureScheduler::CreateJob(const std::string& name) {
+  webrtc::MutexLock lock(&mutex_);
+  // Prefer an idle thread, then a new one while under the cap, then the
+  // least loaded of the first |max_threads_|.
+  std::shared_ptr<Job::Worker> worker;
+  size_t limit = std::min(max_threads_, workers_.size());
+  for (size_t i = 0; i < limit; ++i) {
+    if (!worker || workers_[i]->jobs < worker->jobs) {
+      worker = workers_[i];
+    }
+  }
+  if ((!worker || worker->jobs > 0) && workers_.size() < max_threads_) {
+    worker = std::make_shared<Job::Worker>();
+    worker->thread = rtc::Thread::Create();
+    worker->thread->SetName(
+        "desktop_capture_thread_" + std::to_string(workers_.size()), nullptr);
+    worker->thread->Start();
+    workers_.push_back(worker);
+  }
+  RTC_DCHECK(worker);
+  worker->jobs++;
+  std::unique_ptr<Job> job(new Job(this, worker, name));
+  jobs_.push_back(job.get());
+  return job;
+}
+
+void DesktopCaptureScheduler::RemoveJob(Job* job) {
+  webrtc::MutexLock lock(&mutex_);
+  job->worker_->jobs--;
+  jobs_.erase(std::remove(jobs_.begin(), jobs_.end(), job), jobs_.end());
+}
+
+std::vector<DesktopCaptureScheduler::JobStats>
+DesktopCaptureScheduler::GetStats() const {
+  webrtc::MutexLock lock(&mutex_);
+  std::vector<JobStats> stats;
+  stats.reserve(jobs_.size());
+  for (const Job* job : jobs_) {
+    stats.push_back(job->stats());
+  }
+  return stats;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,93 @@
+#ifndef INTERNAL_DESKTOP_CAPTURE_SCHEDULER_HXX
+#define INTERNAL_DESKTOP_CAPTURE_SCHEDULER_HXX
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread.h"
+
+namespace libwebrtc {
+
+// A small pool of capture threads shared by every desktop capturer and media
+// list. Each job is pinned to one thread for its whole life (desktop capture
+// APIs are thread-affine on most platforms); jobs on the same thread are
+// multiplexed by deadline through its delayed task queue.
+class DesktopCaptureScheduler {
+ public:
+  struct JobStats {
+    std::string name;
+    uint64_t runs = 0;
+    // Time spent running the job's tasks.
+    int64_t total_run_time_us = 0;
+    int64_t max_run_time_us = 0;
+    // How late tasks started relative to their deadline.
+    int64_t total_delay_us = 0;
+    int64_t max_delay_us = 0;
+  };
+
+  class Job {
+   public:
+    ~Job();
+
+    // The thread this job runs on. Blocking calls onto it are allowed, but
+    // they hold up every other job sharing the thread.
+    rtc::Thread* thread() const { return worker_->thread.get(); }
+
+    // Runs |task| on thread() once |delay| has elapsed and records its timing.
+    // Tasks still pending when the job is destroyed are dropped.
+    void PostDelayedTask(absl::AnyInvocable<void() &&> task,
+                         webrtc::TimeDelta delay);
+
+    void PostTask(absl::AnyInvocable<void() &&> task) {
+      PostDelayedTask(std::move(task), webrtc::TimeDelta::Zero());
+    }
+
+    // Records a run of a task scheduled by other means (e.g. a repeating
+    // task). |deadline_us| is when it was due, in rtc::TimeMicros().
+    void RecordRun(int64_t deadline_us, int64_t start_us, int64_t end_us);
+
+    JobStats stats() const;
+
+   private:
+    friend class DesktopCaptureScheduler;
+    struct Worker;
+
+    Job(DesktopCaptureScheduler* scheduler, std::shared_ptr<Worker> worker,
+        const std::string& name);
+
+    DesktopCaptureScheduler* scheduler_;
+    std::shared_ptr<Worker> worker_;
+    rtc::scoped_refptr<webrtc::PendingTaskSafetyFlag> safety_;
+    mutable webrtc::Mutex mutex_;
+    JobStats stats_;
+  };
+
+  static DesktopCaptureScheduler* Instance();
+
+  // Caps the number of capture threads. Only affects jobs created later;
+  // running jobs stay on their thread.
+  void SetMaxThreads(size_t max_threads);
+
+  std::unique_ptr<Job> CreateJob(const std::string& name);
+
+  std::vector<JobStats> GetStats() const;
+
+ private:
+  DesktopCaptureScheduler() = default;
+
+  void RemoveJob(Job* job);
+
+  mutable webrtc::Mutex mutex_;
+  size_t max_threads_ = 2;
+  std::vector<std::shared_ptr<Job::Worker>> workers_;
+  std::vector<Job*> jobs_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_DESKTOP_CAPTURE_SCHEDULER_HXX
@@ -43,6 +43,9 @@ class ScreenCapturerTrackSource : public webrtc::VideoTrackSource {
       : VideoTrackSource(/*remote=*/false), capturer_(std::move(capturer)) {}
   virtual ~ScreenCapturerTrackSource() { capturer_->Stop(); }
 
+  // Screen content by default; RTCVideoContentHint::kFluid overrides it.
+  bool is_screencast() const override { return true; }
+
  private:
   rtc::VideoSourceInterface<webrtc::VideoFrame>* source() override {
     return static_cast<RTCDesktopCapturerImpl*>(capturer_.get());
@@ -0,0 +1,134 @@
+#include "src/internal/encoded_video_track_source.h"
+
+#include <set>
+
+#include "api/make_ref_counted.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/time_utils.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// A key frame request is repeated if no key frame arrived within this time.
+const int64_t kKeyFrameRequestRepeatMs = 1000;
+
+webrtc::Mutex& LiveBuffersMutex() {
+  static webrtc::Mutex* mutex = new webrtc::Mutex();
+  return *mutex;
+}
+
+std::set<const webrtc::VideoFrameBuffer*>& LiveBuffers() {
+  static auto* buffers = new std::set<const webrtc::VideoFrameBuffer*>();
+  return *buffers;
+}
+
+}  // namespace
+
+EncodedVideoFrameBuffer::EncodedVideoFrameBuffer(
+    rtc::scoped_refptr<EncodedVideoTrackSource> source,
+    rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data,
+    bool key_frame, uint64_t sequence, int width, int height)
+    : source_(source),
+      data_(data),
+      key_frame_(key_frame),
+      sequence_(sequence),
+      width_(width),
+      height_(height) {
+  webrtc::MutexLock lock(&LiveBuffersMutex());
+  LiveBuffers().insert(this);
+}
+
+EncodedVideoFrameBuffer::~EncodedVideoFrameBuffer() {
+  webrtc::MutexLock lock(&LiveBuffersMutex());
+  LiveBuffers().erase(this);
+}
+
+EncodedVideoFrameBuffer* EncodedVideoFrameBuffer::From(
+    webrtc::VideoFrameBuffer* buffer) {
+  if (!buffer || buffer->type() != Type::kNative) {
+    return nullptr;
+  }
+  webrtc::MutexLock lock(&LiveBuffersMutex());
+  return LiveBuffers().count(buffer)
+             ? static_cast<EncodedVideoFrameBuffer*>(buffer)
+             : nullptr;
+}
+
+rtc::scoped_refptr<webrtc::I420BufferInterface>
+EncodedVideoFrameBuffer::ToI420() {
+  rtc::scoped_refptr<webrtc::I420Buffer> black =
+      webrtc::I420Buffer::Create(width_, height_);
+  webrtc::I420Buffer::SetBlack(black.get());
+  return black;
+}
+
+rtc::scoped_refptr<EncodedVideoTrackSource> EncodedVideoTrackSource::Create(
+    webrtc::VideoCodecType codec) {
+  if (codec != webrtc::kVideoCodecVP8 && codec != webrtc::kVideoCodecH264) {
+    RTC_LOG(LS_ERROR) << "Encoded video sources support VP8 and H264 only.";
+    return nullptr;
+  }
+  return rtc::make_ref_counted<EncodedVideoTrackSource>(codec);
+}
+
+EncodedVideoTrackSource::EncodedVideoTrackSource(webrtc::VideoCodecType codec)
+    : VideoTrackSource(/*remote=*/false), codec_(codec) {
+  SetState(kLive);
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+EncodedVideoTrackSource::~EncodedVideoTrackSource() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool EncodedVideoTrackSource::PushFrame(const uint8_t* data, size_t size,
+                                        bool key_frame, int width, int height,
+                                        int64_t capture_time_us) {
+  if (!data || !size) {
+    return false;
+  }
+  return PushBuffer(webrtc::EncodedImageBuffer::Create(data, size), key_frame,
+                    width, height, capture_time_us);
+}
+
+bool EncodedVideoTrackSource::PushBuffer(
+    rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data,
+    bool key_frame, int width, int height, int64_t capture_time_us) {
+  if (!data || !data->size() || width <= 0 || height <= 0) {
+    return false;
+  }
+  if (key_frame) {
+    key_frame_pending_ = false;
+  }
+  rtc::scoped_refptr<EncodedVideoFrameBuffer> buffer =
+      rtc::make_ref_counted<EncodedVideoFrameBuffer>(
+          rtc::scoped_refptr<EncodedVideoTrackSource>(this), data, key_frame,
+          sequence_++, width, height);
+  broadcaster_.OnFrame(
+      webrtc::VideoFrame::Builder()
+          .set_video_frame_buffer(buffer)
+          .set_timestamp_us(capture_time_us > 0 ? capture_time_us
+                                                : rtc::TimeMicros())
+          .build());
+  return true;
+}
+
+void EncodedVideoTrackSource::RequestKeyFrame() {
+  const int64_t now_ms = rtc::TimeMillis();
+  if (key_frame_pending_ &&
+      now_ms - last_key_frame_request_ms_ < kKeyFrameRequestRepeatMs) {
+    return;
+  }
+  key_frame_pending_ = true;
+  last_key_frame_request_ms_ = now_ms;
+  RTCEncodedVideoSourceObserver* observer = observer_;
+  if (observer) {
+    observer->OnKeyFrameRequested();
+  }
+}
+
+}  // namespace libwebrtc
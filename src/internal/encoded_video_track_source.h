@@ -0,0 +1,104 @@
+#ifndef INTERNAL_ENCODED_VIDEO_TRACK_SOURCE_HXX
+#define INTERNAL_ENCODED_VIDEO_TRACK_SOURCE_HXX
+
+#include <atomic>
+
+#include "api/video/encoded_image.h"
+#include "api/video/video_frame_buffer.h"
+#include "api/video_codecs/video_codec.h"
+#include "media/base/video_broadcaster.h"
+#include "pc/video_track_source.h"
+#include "rtc_encoded_video_source.h"
+
+namespace libwebrtc {
+
+class EncodedVideoTrackSource;
+
+// Carries one encoded access unit through the video track in place of
+// pixels. PassthroughVideoEncoder recognizes it and sends the access unit
+// as is. Anything else that asks for pixels (local renderers) gets black.
+class EncodedVideoFrameBuffer : public webrtc::VideoFrameBuffer {
+ public:
+  EncodedVideoFrameBuffer(
+      rtc::scoped_refptr<EncodedVideoTrackSource> source,
+      rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data,
+      bool key_frame, uint64_t sequence, int width, int height);
+
+  // Returns |buffer| if it is an EncodedVideoFrameBuffer, else null. There
+  // is no RTTI in webrtc builds, so live buffers are kept in a set.
+  static EncodedVideoFrameBuffer* From(webrtc::VideoFrameBuffer* buffer);
+
+  Type type() const override { return Type::kNative; }
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+  rtc::scoped_refptr<webrtc::I420BufferInterface> ToI420() override;
+
+  EncodedVideoTrackSource* source() const { return source_.get(); }
+  rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data() const {
+    return data_;
+  }
+  bool key_frame() const { return key_frame_; }
+  // Increases by one per pushed frame, so dropped frames show up as gaps.
+  uint64_t sequence() const { return sequence_; }
+
+ protected:
+  ~EncodedVideoFrameBuffer() override;
+
+ private:
+  const rtc::scoped_refptr<EncodedVideoTrackSource> source_;
+  const rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data_;
+  const bool key_frame_;
+  const uint64_t sequence_;
+  const int width_;
+  const int height_;
+};
+
+// A video track source fed with encoded access units of one codec.
+class EncodedVideoTrackSource : public webrtc::VideoTrackSource {
+ public:
+  // Returns null for codecs that cannot be passed through (VP9, AV1).
+  static rtc::scoped_refptr<EncodedVideoTrackSource> Create(
+      webrtc::VideoCodecType codec);
+
+  webrtc::VideoCodecType codec() const { return codec_; }
+
+  // Copies the access unit once and delivers it to the track's sinks on the
+  // calling thread. |capture_time_us| 0 stamps the frame with the current
+  // time.
+  bool PushFrame(const uint8_t* data, size_t size, bool key_frame, int width,
+                 int height, int64_t capture_time_us);
+
+  // Same as PushFrame() for an access unit that is already in a shared
+  // buffer, e.g. a received frame; nothing is copied.
+  bool PushBuffer(rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data,
+                  bool key_frame, int width, int height,
+                  int64_t capture_time_us);
+
+  void SetObserver(RTCEncodedVideoSourceObserver* observer) {
+    observer_ = observer;
+  }
+
+  // Called by the encoder when a receiver needs a key frame or frames were
+  // lost. Repeated requests are folded until a key frame is pushed.
+  void RequestKeyFrame();
+
+ protected:
+  explicit EncodedVideoTrackSource(webrtc::VideoCodecType codec);
+  ~EncodedVideoTrackSource() override;
+
+  rtc::VideoSourceInterface<webrtc::VideoFrame>* source() override {
+    return &broadcaster_;
+  }
+
+ private:
+  const webrtc::VideoCodecType codec_;
+  rtc::VideoBroadcaster broadcaster_;
+  std::atomic<uint64_t> sequence_{0};
+  std::atomic<RTCEncodedVideoSourceObserver*> observer_{nullptr};
+  std::atomic<bool> key_frame_pending_{false};
+  std::atomic<int64_t> last_key_frame_request_ms_{0};
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_ENCODED_VIDEO_TRACK_SOURCE_HXX
@@ -0,0 +1,64 @@
+#ifndef INTERNAL_EVENT_DISPATCHER_HXX
+#define INTERNAL_EVENT_DISPATCHER_HXX
+
+#include <utility>
+
+#include "api/ref_counted_base.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread.h"
+#include "rtc_event_executor.h"
+
+namespace libwebrtc {
+
+// Delivers observer callbacks without blocking the calling media thread.
+// Events go to the application's RTCEventExecutor when one is set, otherwise
+// they are posted to the signaling thread. Events must be small copyable
+// closures: capture a reference to the emitting object plus a plain record,
+// and look the observer up when the event runs.
+class EventDispatcher : public rtc::RefCountedBase {
+ public:
+  explicit EventDispatcher(rtc::Thread* signaling_thread)
+      : signaling_thread_(signaling_thread) {}
+
+  // Once this returns the previous executor receives no more events.
+  void SetExecutor(RTCEventExecutor* executor) {
+    webrtc::MutexLock lock(&mutex_);
+    executor_ = executor;
+  }
+
+  // Called by the factory before its threads stop. Objects that outlive the
+  // factory keep the dispatcher; their events are dropped from then on.
+  void Stop() {
+    webrtc::MutexLock lock(&mutex_);
+    stopped_ = true;
+    executor_ = nullptr;
+  }
+
+  template <typename Event>
+  void Post(Event&& event) {
+    webrtc::MutexLock lock(&mutex_);
+    if (stopped_) {
+      return;
+    }
+    if (executor_) {
+      executor_->Post(RTCEventExecutor::Task(std::forward<Event>(event)));
+    } else {
+      signaling_thread_->PostTask(std::forward<Event>(event));
+    }
+  }
+
+  rtc::Thread* signaling_thread() const { return signaling_thread_; }
+
+ protected:
+  ~EventDispatcher() override = default;
+
+ private:
+  rtc::Thread* const signaling_thread_;
+  webrtc::Mutex mutex_;
+  RTCEventExecutor* executor_ = nullptr;
+  bool stopped_ = false;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_EVENT_DISPATCHER_HXX
@@ -0,0 +1,362 @@
+#include "src/internal/external_video_codec.h"
+
+#include <algorithm>
+
+#include "api/video/encoded_image.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "base/refcountedobject.h"
+#include "media/base/media_constants.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "src/internal/passthrough_video_encoder.h"
+#include "src/internal/video_encoder_tuning.h"
+#include "src/rtc_video_frame_impl.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Input frames remembered for their encoded images. Encoders that lag
+// further behind lose the capture time and rotation of their output.
+const size_t kMaxPendingFrames = 32;
+
+webrtc::SdpVideoFormat ToSdpVideoFormat(RTCVideoCodecType codec) {
+  switch (codec) {
+    case RTCVideoCodecType::kVP9:
+      return webrtc::SdpVideoFormat(cricket::kVp9CodecName);
+    case RTCVideoCodecType::kH264:
+      return webrtc::SdpVideoFormat(
+          cricket::kH264CodecName,
+          {{cricket::kH264FmtpLevelAsymmetryAllowed, "1"},
+           {cricket::kH264FmtpPacketizationMode, "1"},
+           {cricket::kH264FmtpProfileLevelId, "42e01f"}});
+    case RTCVideoCodecType::kAV1:
+      return webrtc::SdpVideoFormat(cricket::kAv1CodecName);
+    default:
+      return webrtc::SdpVideoFormat(cricket::kVp8CodecName);
+  }
+}
+
+std::vector<webrtc::SdpVideoFormat> ToSdpVideoFormats(
+    const vector<RTCVideoCodecType>& codecs, bool encoders) {
+  std::vector<webrtc::SdpVideoFormat> formats;
+  for (RTCVideoCodecType codec : codecs.std_vector()) {
+    if (encoders && codec != RTCVideoCodecType::kVP8 &&
+        codec != RTCVideoCodecType::kH264) {
+      RTC_LOG(LS_WARNING) << "Application video encoders support VP8 and "
+                             "H264 only, not offering "
+                          << webrtc::CodecTypeToPayloadString(
+                                 ToWebrtcCodecType(codec));
+      continue;
+    }
+    formats.push_back(ToSdpVideoFormat(codec));
+  }
+  return formats;
+}
+
+}  // namespace
+
+webrtc::VideoCodecType ToWebrtcCodecType(RTCVideoCodecType codec) {
+  switch (codec) {
+    case RTCVideoCodecType::kVP8:
+      return webrtc::kVideoCodecVP8;
+    case RTCVideoCodecType::kVP9:
+      return webrtc::kVideoCodecVP9;
+    case RTCVideoCodecType::kH264:
+      return webrtc::kVideoCodecH264;
+    case RTCVideoCodecType::kAV1:
+      return webrtc::kVideoCodecAV1;
+  }
+  return webrtc::kVideoCodecGeneric;
+}
+
+RTCVideoCodecType ToRtcCodecType(webrtc::VideoCodecType codec) {
+  switch (codec) {
+    case webrtc::kVideoCodecVP9:
+      return RTCVideoCodecType::kVP9;
+    case webrtc::kVideoCodecH264:
+      return RTCVideoCodecType::kH264;
+    case webrtc::kVideoCodecAV1:
+      return RTCVideoCodecType::kAV1;
+    default:
+      return RTCVideoCodecType::kVP8;
+  }
+}
+
+bool HasRtcCodecType(webrtc::VideoCodecType codec) {
+  switch (codec) {
+    case webrtc::kVideoCodecVP8:
+    case webrtc::kVideoCodecVP9:
+    case webrtc::kVideoCodecH264:
+    case webrtc::kVideoCodecAV1:
+      return true;
+    default:
+      return false;
+  }
+}
+
+ExternalVideoEncoderFactory::ExternalVideoEncoderFactory(
+    scoped_refptr<RTCVideoEncoderFactory> factory)
+    : factory_(factory) {}
+
+std::vector<webrtc::SdpVideoFormat>
+ExternalVideoEncoderFactory::GetSupportedFormats() const {
+  return ToSdpVideoFormats(factory_->supported_codecs(), /*encoders=*/true);
+}
+
+std::unique_ptr<webrtc::VideoEncoder>
+ExternalVideoEncoderFactory::CreateVideoEncoder(
+    const webrtc::SdpVideoFormat& format) {
+  const webrtc::VideoCodecType codec =
+      webrtc::PayloadStringToCodecType(format.name);
+  if (codec != webrtc::kVideoCodecVP8 && codec != webrtc::kVideoCodecH264) {
+    return nullptr;
+  }
+  scoped_refptr<RTCVideoEncoder> encoder =
+      factory_->Create(ToRtcCodecType(codec));
+  if (!encoder) {
+    return nullptr;
+  }
+  return std::make_unique<ExternalVideoEncoder>(
+      encoder, codec, H264PacketizationModeOf(format));
+}
+
+ExternalVideoDecoderFactory::ExternalVideoDecoderFactory(
+    scoped_refptr<RTCVideoDecoderFactory> factory)
+    : factory_(factory) {}
+
+std::vector<webrtc::SdpVideoFormat>
+ExternalVideoDecoderFactory::GetSupportedFormats() const {
+  return ToSdpVideoFormats(factory_->supported_codecs(), /*encoders=*/false);
+}
+
+std::unique_ptr<webrtc::VideoDecoder>
+ExternalVideoDecoderFactory::CreateVideoDecoder(
+    const webrtc::SdpVideoFormat& format) {
+  const webrtc::VideoCodecType codec =
+      webrtc::PayloadStringToCodecType(format.name);
+  if (codec == webrtc::kVideoCodecGeneric) {
+    return nullptr;
+  }
+  scoped_refptr<RTCVideoDecoder> decoder =
+      factory_->Create(ToRtcCodecType(codec));
+  if (!decoder) {
+    return nullptr;
+  }
+  return std::make_unique<ExternalVideoDecoder>(decoder);
+}
+
+ExternalVideoEncoder::ExternalVideoEncoder(
+    scoped_refptr<RTCVideoEncoder> encoder, webrtc::VideoCodecType codec,
+    webrtc::H264PacketizationMode packetization_mode)
+    : encoder_(encoder),
+      codec_(codec),
+      packetization_mode_(packetization_mode) {}
+
+ExternalVideoEncoder::~ExternalVideoEncoder() {
+  Release();
+}
+
+int ExternalVideoEncoder::InitEncode(
+    const webrtc::VideoCodec* codec_settings,
+    const webrtc::VideoEncoder::Settings& settings) {
+  if (initialized_) {
+    encoder_->Release();
+  }
+  RTCVideoEncoderSettings encoder_settings;
+  encoder_settings.codec = ToRtcCodecType(codec_);
+  encoder_settings.width = codec_settings->width;
+  encoder_settings.height = codec_settings->height;
+  encoder_settings.max_framerate = codec_settings->maxFramerate;
+  encoder_settings.start_bitrate_kbps = codec_settings->startBitrate;
+  encoder_settings.max_bitrate_kbps = codec_settings->maxBitrate;
+  encoder_settings.number_of_cores = settings.number_of_cores;
+  encoder_settings.complexity =
+      FromVideoCodecComplexity(codec_settings->GetVideoEncoderComplexity());
+  {
+    webrtc::MutexLock lock(&mutex_);
+    width_ = codec_settings->width;
+    height_ = codec_settings->height;
+    pending_.clear();
+  }
+  initialized_ = encoder_->InitEncode(encoder_settings, this);
+  return initialized_ ? WEBRTC_VIDEO_CODEC_OK : WEBRTC_VIDEO_CODEC_ERROR;
+}
+
+int32_t ExternalVideoEncoder::RegisterEncodeCompleteCallback(
+    webrtc::EncodedImageCallback* callback) {
+  webrtc::MutexLock lock(&mutex_);
+  callback_ = callback;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t ExternalVideoEncoder::Release() {
+  if (initialized_) {
+    encoder_->Release();
+    initialized_ = false;
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t ExternalVideoEncoder::Encode(
+    const webrtc::VideoFrame& frame,
+    const std::vector<webrtc::VideoFrameType>* frame_types) {
+  if (!initialized_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  rtc::scoped_refptr<webrtc::I420BufferInterface> i420 =
+      frame.video_frame_buffer()->ToI420();
+  if (!i420) {
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+  const bool key_frame =
+      frame_types &&
+      std::find(frame_types->begin(), frame_types->end(),
+                webrtc::VideoFrameType::kVideoFrameKey) != frame_types->end();
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (pending_.size() >= kMaxPendingFrames) {
+      pending_.pop_front();
+    }
+    pending_.push_back(
+        {frame.rtp_timestamp(), frame.render_time_ms(), frame.rotation()});
+  }
+  scoped_refptr<RTCVideoFrame> input = scoped_refptr<RTCVideoFrame>(
+      new RefCountedObject<VideoFrameBufferImpl>(
+          rtc::scoped_refptr<webrtc::VideoFrameBuffer>(i420)));
+  return encoder_->Encode(input, key_frame, frame.rtp_timestamp())
+             ? WEBRTC_VIDEO_CODEC_OK
+             : WEBRTC_VIDEO_CODEC_ERROR;
+}
+
+void ExternalVideoEncoder::SetRates(const RateControlParameters& parameters) {
+  if (initialized_) {
+    encoder_->SetRates(parameters.bitrate.get_sum_bps(),
+                       parameters.framerate_fps);
+  }
+}
+
+webrtc::VideoEncoder::EncoderInfo ExternalVideoEncoder::GetEncoderInfo()
+    const {
+  EncoderInfo info;
+  info.implementation_name = encoder_->implementation_name().std_string();
+  info.is_hardware_accelerated = false;
+  info.supports_native_handle = false;
+  // The encoder reports no QP, so there is nothing to scale by.
+  info.scaling_settings = ScalingSettings(ScalingSettings::kOff);
+  return info;
+}
+
+void ExternalVideoEncoder::OnEncodedFrame(const uint8_t* data, size_t size,
+                                          bool key_frame, int width,
+                                          int height, uint32_t timestamp) {
+  if (!data || !size) {
+    return;
+  }
+  webrtc::EncodedImage image;
+  image.SetRtpTimestamp(timestamp);
+  image.capture_time_ms_ = rtc::TimeMillis();
+  webrtc::EncodedImageCallback* callback;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    callback = callback_;
+    // Frames come out in input order, so older entries are done with.
+    while (!pending_.empty() && pending_.front().rtp_timestamp != timestamp) {
+      pending_.pop_front();
+    }
+    if (!pending_.empty()) {
+      image.capture_time_ms_ = pending_.front().capture_time_ms;
+      image.rotation_ = pending_.front().rotation;
+      pending_.pop_front();
+    }
+    image._encodedWidth = width > 0 ? width : width_;
+    image._encodedHeight = height > 0 ? height : height_;
+  }
+  if (!callback) {
+    return;
+  }
+  image.SetEncodedData(webrtc::EncodedImageBuffer::Create(data, size));
+  image._frameType = key_frame ? webrtc::VideoFrameType::kVideoFrameKey
+                               : webrtc::VideoFrameType::kVideoFrameDelta;
+  webrtc::CodecSpecificInfo info =
+      SingleLayerCodecSpecificInfo(codec_, key_frame, packetization_mode_);
+  callback->OnEncodedImage(image, &info);
+}
+
+ExternalVideoDecoder::ExternalVideoDecoder(
+    scoped_refptr<RTCVideoDecoder> decoder)
+    : decoder_(decoder) {}
+
+ExternalVideoDecoder::~ExternalVideoDecoder() {
+  Release();
+}
+
+bool ExternalVideoDecoder::Configure(const Settings& settings) {
+  if (configured_) {
+    decoder_->Release();
+  }
+  configured_ =
+      decoder_->Configure(ToRtcCodecType(settings.codec_type()),
+                          settings.number_of_cores(), this);
+  return configured_;
+}
+
+int32_t ExternalVideoDecoder::Decode(const webrtc::EncodedImage& input_image,
+                                     int64_t render_time_ms) {
+  if (!configured_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  return decoder_->Decode(
+             input_image.data(), input_image.size(),
+             input_image._frameType == webrtc::VideoFrameType::kVideoFrameKey,
+             input_image.RtpTimestamp())
+             ? WEBRTC_VIDEO_CODEC_OK
+             : WEBRTC_VIDEO_CODEC_ERROR;
+}
+
+int32_t ExternalVideoDecoder::RegisterDecodeCompleteCallback(
+    webrtc::DecodedImageCallback* callback) {
+  webrtc::MutexLock lock(&mutex_);
+  callback_ = callback;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t ExternalVideoDecoder::Release() {
+  if (configured_) {
+    decoder_->Release();
+    configured_ = false;
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+webrtc::VideoDecoder::DecoderInfo ExternalVideoDecoder::GetDecoderInfo()
+    const {
+  DecoderInfo info;
+  info.implementation_name = decoder_->implementation_name().std_string();
+  info.is_hardware_accelerated = false;
+  return info;
+}
+
+void ExternalVideoDecoder::OnDecodedFrame(scoped_refptr<RTCVideoFrame> frame,
+                                          uint32_t timestamp) {
+  if (!frame) {
+    return;
+  }
+  // The frame may be the application's own RTCVideoFrame implementation,
+  // so only its public accessors can be relied on.
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer = webrtc::I420Buffer::Copy(
+      frame->width(), frame->height(), frame->DataY(), frame->StrideY(),
+      frame->DataU(), frame->StrideU(), frame->DataV(), frame->StrideV());
+  webrtc::VideoFrame decoded = webrtc::VideoFrame::Builder()
+                                   .set_video_frame_buffer(buffer)
+                                   .set_rtp_timestamp(timestamp)
+                                   .build();
+  webrtc::MutexLock lock(&mutex_);
+  if (callback_) {
+    callback_->Decoded(decoded);
+  }
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,128 @@
+#ifndef INTERNAL_EXTERNAL_VIDEO_CODEC_HXX
+#define INTERNAL_EXTERNAL_VIDEO_CODEC_HXX
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "api/video_codecs/video_decoder.h"
+#include "api/video_codecs/video_decoder_factory.h"
+#include "api/video_codecs/video_encoder.h"
+#include "api/video_codecs/video_encoder_factory.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_video_codec.h"
+
+namespace libwebrtc {
+
+webrtc::VideoCodecType ToWebrtcCodecType(RTCVideoCodecType codec);
+
+// kVideoCodecGeneric and other codecs without a public name map to kVP8.
+RTCVideoCodecType ToRtcCodecType(webrtc::VideoCodecType codec);
+
+// True for the codecs RTCVideoCodecType has a name for.
+bool HasRtcCodecType(webrtc::VideoCodecType codec);
+
+// Runs the encoders of an application RTCVideoEncoderFactory.
+class ExternalVideoEncoderFactory : public webrtc::VideoEncoderFactory {
+ public:
+  explicit ExternalVideoEncoderFactory(
+      scoped_refptr<RTCVideoEncoderFactory> factory);
+
+  std::vector<webrtc::SdpVideoFormat> GetSupportedFormats() const override;
+
+  std::unique_ptr<webrtc::VideoEncoder> CreateVideoEncoder(
+      const webrtc::SdpVideoFormat& format) override;
+
+ private:
+  const scoped_refptr<RTCVideoEncoderFactory> factory_;
+};
+
+// Runs the decoders of an application RTCVideoDecoderFactory.
+class ExternalVideoDecoderFactory : public webrtc::VideoDecoderFactory {
+ public:
+  explicit ExternalVideoDecoderFactory(
+      scoped_refptr<RTCVideoDecoderFactory> factory);
+
+  std::vector<webrtc::SdpVideoFormat> GetSupportedFormats() const override;
+
+  std::unique_ptr<webrtc::VideoDecoder> CreateVideoDecoder(
+      const webrtc::SdpVideoFormat& format) override;
+
+ private:
+  const scoped_refptr<RTCVideoDecoderFactory> factory_;
+};
+
+class ExternalVideoEncoder : public webrtc::VideoEncoder,
+                             public RTCVideoEncoderCallback {
+ public:
+  ExternalVideoEncoder(scoped_refptr<RTCVideoEncoder> encoder,
+                       webrtc::VideoCodecType codec,
+                       webrtc::H264PacketizationMode packetization_mode);
+  ~ExternalVideoEncoder() override;
+
+  // webrtc::VideoEncoder
+  int InitEncode(const webrtc::VideoCodec* codec_settings,
+                 const webrtc::VideoEncoder::Settings& settings) override;
+  int32_t RegisterEncodeCompleteCallback(
+      webrtc::EncodedImageCallback* callback) override;
+  int32_t Release() override;
+  int32_t Encode(const webrtc::VideoFrame& frame,
+                 const std::vector<webrtc::VideoFrameType>* frame_types)
+      override;
+  void SetRates(const RateControlParameters& parameters) override;
+  EncoderInfo GetEncoderInfo() const override;
+
+  // RTCVideoEncoderCallback
+  void OnEncodedFrame(const uint8_t* data, size_t size, bool key_frame,
+                      int width, int height, uint32_t timestamp) override;
+
+ private:
+  // What the encoded image needs from the input frame.
+  struct PendingFrame {
+    uint32_t rtp_timestamp;
+    int64_t capture_time_ms;
+    webrtc::VideoRotation rotation;
+  };
+
+  const scoped_refptr<RTCVideoEncoder> encoder_;
+  const webrtc::VideoCodecType codec_;
+  const webrtc::H264PacketizationMode packetization_mode_;
+  bool initialized_ = false;
+
+  webrtc::Mutex mutex_;
+  webrtc::EncodedImageCallback* callback_ RTC_GUARDED_BY(mutex_) = nullptr;
+  std::deque<PendingFrame> pending_ RTC_GUARDED_BY(mutex_);
+  int width_ RTC_GUARDED_BY(mutex_) = 0;
+  int height_ RTC_GUARDED_BY(mutex_) = 0;
+};
+
+class ExternalVideoDecoder : public webrtc::VideoDecoder,
+                             public RTCVideoDecoderCallback {
+ public:
+  explicit ExternalVideoDecoder(scoped_refptr<RTCVideoDecoder> decoder);
+  ~ExternalVideoDecoder() override;
+
+  // webrtc::VideoDecoder
+  bool Configure(const Settings& settings) override;
+  int32_t Decode(const webrtc::EncodedImage& input_image,
+                 int64_t render_time_ms) override;
+  int32_t RegisterDecodeCompleteCallback(
+      webrtc::DecodedImageCallback* callback) override;
+  int32_t Release() override;
+  DecoderInfo GetDecoderInfo() const override;
+
+  // RTCVideoDecoderCallback
+  void OnDecodedFrame(scoped_refptr<RTCVideoFrame> frame,
+                      uint32_t timestamp) override;
+
+ private:
+  const scoped_refptr<RTCVideoDecoder> decoder_;
+  bool configured_ = false;
+
+  webrtc::Mutex mutex_;
+  webrtc::DecodedImageCallback* callback_ RTC_GUARDED_BY(mutex_) = nullptr;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_EXTERNAL_VIDEO_CODEC_HXX
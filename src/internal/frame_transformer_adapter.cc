@@ -0,0 +1,138 @@
+#include "src/internal/frame_transformer_adapter.h"
+
+#include "base/refcountedobject.h"
+#include "rtc_base/logging.h"
+#include "src/internal/external_video_codec.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Borrows webrtc's frame for the duration of RTCFrameTransformer::OnFrame().
+class RTCEncodedFrameImpl : public RTCEncodedFrame {
+ public:
+  RTCEncodedFrameImpl(webrtc::TransformableFrameInterface* frame,
+                      RTCMediaType media_type)
+      : frame_(frame), media_type_(media_type) {}
+
+  void Detach() { frame_ = nullptr; }
+
+  RTCMediaType media_type() const override { return media_type_; }
+
+  const uint8_t* data() const override {
+    return frame_ ? frame_->GetData().data() : nullptr;
+  }
+
+  size_t size() const override { return frame_ ? frame_->GetData().size() : 0; }
+
+  void SetData(const uint8_t* data, size_t size) override {
+    if (frame_) {
+      frame_->SetData(rtc::ArrayView<const uint8_t>(data, size));
+    }
+  }
+
+  bool is_key_frame() const override {
+    if (!frame_) {
+      return false;
+    }
+    return video_frame() ? video_frame()->IsKeyFrame() : true;
+  }
+
+  uint32_t timestamp() const override {
+    return frame_ ? frame_->GetTimestamp() : 0;
+  }
+
+  uint32_t ssrc() const override { return frame_ ? frame_->GetSsrc() : 0; }
+
+  uint8_t payload_type() const override {
+    return frame_ ? frame_->GetPayloadType() : 0;
+  }
+
+  bool has_video_codec() const override {
+    return video_frame() &&
+           HasRtcCodecType(video_frame()->Metadata().GetCodec());
+  }
+
+  RTCVideoCodecType video_codec() const override {
+    return ToRtcCodecType(video_frame() ? video_frame()->Metadata().GetCodec()
+                                        : webrtc::kVideoCodecGeneric);
+  }
+
+  int width() const override {
+    return video_frame() ? video_frame()->Metadata().GetWidth() : 0;
+  }
+
+  int height() const override {
+    return video_frame() ? video_frame()->Metadata().GetHeight() : 0;
+  }
+
+ private:
+  webrtc::TransformableVideoFrameInterface* video_frame() const {
+    return frame_ && media_type_ == RTCMediaType::VIDEO
+               ? static_cast<webrtc::TransformableVideoFrameInterface*>(frame_)
+               : nullptr;
+  }
+
+  webrtc::TransformableFrameInterface* frame_;
+  const RTCMediaType media_type_;
+};
+
+}  // namespace
+
+FrameTransformerAdapter::FrameTransformerAdapter(
+    scoped_refptr<RTCFrameTransformer> transformer, RTCMediaType media_type)
+    : transformer_(transformer), media_type_(media_type) {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+FrameTransformerAdapter::~FrameTransformerAdapter() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+void FrameTransformerAdapter::Transform(
+    std::unique_ptr<webrtc::TransformableFrameInterface> frame) {
+  if (transformer_) {
+    scoped_refptr<RTCEncodedFrameImpl> encoded_frame =
+        new RefCountedObject<RTCEncodedFrameImpl>(frame.get(), media_type_);
+    const bool keep = transformer_->OnFrame(encoded_frame);
+    encoded_frame->Detach();
+    if (!keep) {
+      return;
+    }
+  }
+  rtc::scoped_refptr<webrtc::TransformedFrameCallback> callback;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    auto it = sink_callbacks_.find(frame->GetSsrc());
+    callback = it != sink_callbacks_.end() ? it->second : callback_;
+  }
+  if (callback) {
+    callback->OnTransformedFrame(std::move(frame));
+  }
+}
+
+void FrameTransformerAdapter::RegisterTransformedFrameCallback(
+    rtc::scoped_refptr<webrtc::TransformedFrameCallback> callback) {
+  webrtc::MutexLock lock(&mutex_);
+  callback_ = callback;
+}
+
+void FrameTransformerAdapter::RegisterTransformedFrameSinkCallback(
+    rtc::scoped_refptr<webrtc::TransformedFrameCallback> callback,
+    uint32_t ssrc) {
+  webrtc::MutexLock lock(&mutex_);
+  sink_callbacks_[ssrc] = callback;
+}
+
+void FrameTransformerAdapter::UnregisterTransformedFrameCallback() {
+  webrtc::MutexLock lock(&mutex_);
+  callback_ = nullptr;
+}
+
+void FrameTransformerAdapter::UnregisterTransformedFrameSinkCallback(
+    uint32_t ssrc) {
+  webrtc::MutexLock lock(&mutex_);
+  sink_callbacks_.erase(ssrc);
+}
+
+}  // namespace libwebrtc
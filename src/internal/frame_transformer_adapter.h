@@ -0,0 +1,49 @@
+#ifndef INTERNAL_FRAME_TRANSFORMER_ADAPTER_HXX
+#define INTERNAL_FRAME_TRANSFORMER_ADAPTER_HXX
+
+#include <map>
+
+#include "api/frame_transformer_interface.h"
+#include "api/make_ref_counted.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_frame_transformer.h"
+
+namespace libwebrtc {
+
+// Runs an application RTCFrameTransformer inside webrtc's transform slot of a
+// sender or receiver. Frames are handed to the application synchronously and
+// then passed on to the sink callback registered for their SSRC, or the
+// stream-wide one, unless the application drops them.
+class FrameTransformerAdapter : public webrtc::FrameTransformerInterface {
+ public:
+  FrameTransformerAdapter(scoped_refptr<RTCFrameTransformer> transformer,
+                          RTCMediaType media_type);
+
+  // webrtc::FrameTransformerInterface
+  void Transform(
+      std::unique_ptr<webrtc::TransformableFrameInterface> frame) override;
+  void RegisterTransformedFrameCallback(
+      rtc::scoped_refptr<webrtc::TransformedFrameCallback> callback) override;
+  void RegisterTransformedFrameSinkCallback(
+      rtc::scoped_refptr<webrtc::TransformedFrameCallback> callback,
+      uint32_t ssrc) override;
+  void UnregisterTransformedFrameCallback() override;
+  void UnregisterTransformedFrameSinkCallback(uint32_t ssrc) override;
+
+ protected:
+  ~FrameTransformerAdapter() override;
+
+ private:
+  const scoped_refptr<RTCFrameTransformer> transformer_;
+  const RTCMediaType media_type_;
+  webrtc::Mutex mutex_;
+  rtc::scoped_refptr<webrtc::TransformedFrameCallback> callback_
+      RTC_GUARDED_BY(mutex_);
+  std::map<uint32_t, rtc::scoped_refptr<webrtc::TransformedFrameCallback>>
+      sink_callbacks_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_FRAME_TRANSFORMER_ADAPTER_HXX
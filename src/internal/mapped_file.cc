@@ -0,0 +1,91 @@
+#include "src/internal/mapped_file.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+
+#include "rtc_base/string_utils.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "rtc_base/logging.h"
+
+namespace libwebrtc {
+
+#if defined(WEBRTC_WIN)
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+  HANDLE file = ::CreateFileW(rtc::ToUtf16(path).c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    RTC_LOG(LS_ERROR) << "Cannot open " << path;
+    return nullptr;
+  }
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    ::CloseHandle(file);
+    return nullptr;
+  }
+  HANDLE mapping =
+      ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void* data =
+      mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!data) {
+    RTC_LOG(LS_ERROR) << "Cannot map " << path;
+    if (mapping) {
+      ::CloseHandle(mapping);
+    }
+    ::CloseHandle(file);
+    return nullptr;
+  }
+  std::unique_ptr<MappedFile> mapped(new MappedFile());
+  mapped->data_ = static_cast<const uint8_t*>(data);
+  mapped->size_ = static_cast<size_t>(size.QuadPart);
+  mapped->file_ = file;
+  mapped->mapping_ = mapping;
+  return mapped;
+}
+
+MappedFile::~MappedFile() {
+  ::UnmapViewOfFile(data_);
+  ::CloseHandle(mapping_);
+  ::CloseHandle(file_);
+}
+
+#else
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    RTC_LOG(LS_ERROR) << "Cannot open " << path;
+    return nullptr;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    RTC_LOG(LS_ERROR) << "Cannot map " << path;
+    return nullptr;
+  }
+  std::unique_ptr<MappedFile> mapped(new MappedFile());
+  mapped->data_ = static_cast<const uint8_t*>(data);
+  mapped->size_ = static_cast<size_t>(st.st_size);
+  return mapped;
+}
+
+MappedFile::~MappedFile() {
+  ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+#endif
+
+}  // namespace libwebrtc
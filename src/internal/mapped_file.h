@@ -0,0 +1,36 @@
+#ifndef INTERNAL_MAPPED_FILE_HXX
+#define INTERNAL_MAPPED_FILE_HXX
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+namespace libwebrtc {
+
+// A read-only memory mapping of a whole file.
+class MappedFile {
+ public:
+  // Returns null if |path| cannot be opened or mapped, or is empty.
+  static std::unique_ptr<MappedFile> Open(const std::string& path);
+
+  ~MappedFile();
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile() {}
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#if defined(WEBRTC_WIN)
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_MAPPED_FILE_HXX
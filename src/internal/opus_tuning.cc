@@ -0,0 +1,113 @@
+#include "src/internal/opus_tuning.h"
+
+#include <algorithm>
+#include <string>
+
+#include "absl/strings/match.h"
+#include "api/audio_codecs/opus/audio_encoder_opus.h"
+#include "media/base/media_constants.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/string_to_number.h"
+
+namespace libwebrtc {
+
+const char kOpusComplexityParameter[] = "x-libwebrtc-complexity";
+
+namespace {
+
+bool IsOpus(const cricket::Codec& codec) {
+  return absl::EqualsIgnoreCase(codec.name, cricket::kOpusCodecName);
+}
+
+bool IsRed(const cricket::Codec& codec) {
+  return absl::EqualsIgnoreCase(codec.name, cricket::kRedCodecName);
+}
+
+// Returns |format| without kOpusComplexityParameter, and the complexity it
+// carried or -1.
+webrtc::SdpAudioFormat StripComplexity(const webrtc::SdpAudioFormat& format,
+                                       int* complexity) {
+  *complexity = -1;
+  webrtc::SdpAudioFormat stripped = format;
+  auto it = stripped.parameters.find(kOpusComplexityParameter);
+  if (it != stripped.parameters.end()) {
+    absl::optional<int> value = rtc::StringToNumber<int>(it->second);
+    if (value && *value >= 0 && *value <= 10) {
+      *complexity = *value;
+    }
+    stripped.parameters.erase(it);
+  }
+  return stripped;
+}
+
+}  // namespace
+
+void ApplyOpusSettings(const RTCOpusSettings& settings,
+                       cricket::MediaContentDescription* audio) {
+  std::vector<cricket::Codec> codecs = audio->codecs();
+  auto opus = std::find_if(codecs.begin(), codecs.end(), IsOpus);
+  if (opus == codecs.end()) {
+    return;
+  }
+
+  opus->SetParam(cricket::kCodecParamUseDtx, settings.dtx ? 1 : 0);
+  opus->SetParam(cricket::kCodecParamUseInbandFec,
+                 settings.inband_fec ? 1 : 0);
+  if (settings.max_average_bitrate_bps > 0) {
+    opus->SetParam(cricket::kCodecParamMaxAverageBitrate,
+                   std::min(std::max(settings.max_average_bitrate_bps, 6000),
+                            510000));
+  }
+  if (settings.ptime_ms > 0) {
+    opus->SetParam(cricket::kCodecParamPTime, settings.ptime_ms);
+  }
+  if (settings.complexity >= 0) {
+    opus->SetParam(kOpusComplexityParameter,
+                   std::min(settings.complexity, 10));
+  }
+
+  // The sender uses RED when it is listed before the codec it protects.
+  const int opus_payload_type = opus->id;
+  auto red = std::find_if(codecs.begin(), codecs.end(), IsRed);
+  if (red != codecs.end()) {
+    cricket::Codec red_codec = *red;
+    codecs.erase(red);
+    opus = std::find_if(codecs.begin(), codecs.end(),
+                        [opus_payload_type](const cricket::Codec& codec) {
+                          return codec.id == opus_payload_type;
+                        });
+    codecs.insert(settings.red ? opus : opus + 1, red_codec);
+  } else if (settings.red) {
+    RTC_LOG(LS_WARNING) << "RED requested but not offered by the remote peer.";
+  }
+  audio->set_codecs(codecs);
+}
+
+absl::optional<webrtc::AudioCodecInfo>
+OpusTuningEncoderFactory::QueryAudioEncoder(
+    const webrtc::SdpAudioFormat& format) {
+  int complexity;
+  return factory_->QueryAudioEncoder(StripComplexity(format, &complexity));
+}
+
+std::unique_ptr<webrtc::AudioEncoder>
+OpusTuningEncoderFactory::MakeAudioEncoder(
+    int payload_type, const webrtc::SdpAudioFormat& format,
+    absl::optional<webrtc::AudioCodecPairId> codec_pair_id) {
+  int complexity;
+  webrtc::SdpAudioFormat stripped = StripComplexity(format, &complexity);
+  if (complexity >= 0 &&
+      absl::EqualsIgnoreCase(stripped.name, cricket::kOpusCodecName)) {
+    absl::optional<webrtc::AudioEncoderOpusConfig> config =
+        webrtc::AudioEncoderOpus::SdpToConfig(stripped);
+    if (config) {
+      config->complexity = complexity;
+      config->low_rate_complexity = complexity;
+      return webrtc::AudioEncoderOpus::MakeAudioEncoder(*config, payload_type,
+                                                        codec_pair_id);
+    }
+  }
+  return factory_->MakeAudioEncoder(payload_type, stripped, codec_pair_id);
+}
+
+}  // namespace libwebrtc
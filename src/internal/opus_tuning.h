@@ -0,0 +1,47 @@
+#ifndef INTERNAL_OPUS_TUNING_HXX
+#define INTERNAL_OPUS_TUNING_HXX
+
+#include <memory>
+#include <vector>
+
+#include "api/audio_codecs/audio_encoder_factory.h"
+#include "pc/session_description.h"
+#include "rtc_rtp_sender.h"
+
+namespace libwebrtc {
+
+// Opus complexity is not part of SDP. ApplyOpusSettings() passes it to
+// OpusTuningEncoderFactory as this private format parameter, which the
+// factory strips before creating the encoder.
+extern const char kOpusComplexityParameter[];
+
+// Rewrites the Opus and RED codecs of the audio section |audio| of a remote
+// description so that the encoder negotiated for sending uses |settings|.
+void ApplyOpusSettings(const RTCOpusSettings& settings,
+                       cricket::MediaContentDescription* audio);
+
+// Wraps an audio encoder factory and honours kOpusComplexityParameter.
+class OpusTuningEncoderFactory : public webrtc::AudioEncoderFactory {
+ public:
+  explicit OpusTuningEncoderFactory(
+      rtc::scoped_refptr<webrtc::AudioEncoderFactory> factory)
+      : factory_(factory) {}
+
+  std::vector<webrtc::AudioCodecSpec> GetSupportedEncoders() override {
+    return factory_->GetSupportedEncoders();
+  }
+
+  absl::optional<webrtc::AudioCodecInfo> QueryAudioEncoder(
+      const webrtc::SdpAudioFormat& format) override;
+
+  std::unique_ptr<webrtc::AudioEncoder> MakeAudioEncoder(
+      int payload_type, const webrtc::SdpAudioFormat& format,
+      absl::optional<webrtc::AudioCodecPairId> codec_pair_id) override;
+
+ private:
+  rtc::scoped_refptr<webrtc::AudioEncoderFactory> factory_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_OPUS_TUNING_HXX
@@ -0,0 +1,302 @@
+#include "src/internal/passthrough_video_encoder.h"
+
+#include <algorithm>
+#include <string>
+
+#include "absl/strings/match.h"
+#include "api/video/encoded_image.h"
+#include "api/video/video_frame.h"
+#include "media/base/media_constants.h"
+#include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/logging.h"
+#include "src/internal/encoded_video_track_source.h"
+#include "src/internal/video_encoder_tuning.h"
+
+namespace libwebrtc {
+
+namespace {
+
+bool ContainsCodec(const std::vector<webrtc::SdpVideoFormat>& formats,
+                   const webrtc::SdpVideoFormat& format) {
+  return std::any_of(formats.begin(), formats.end(),
+                     [&format](const webrtc::SdpVideoFormat& supported) {
+                       return format.IsSameCodec(supported);
+                     });
+}
+
+bool ContainsCodecName(const std::vector<webrtc::SdpVideoFormat>& formats,
+                       const char* name) {
+  return std::any_of(formats.begin(), formats.end(),
+                     [name](const webrtc::SdpVideoFormat& supported) {
+                       return absl::EqualsIgnoreCase(supported.name, name);
+                     });
+}
+
+}  // namespace
+
+webrtc::CodecSpecificInfo SingleLayerCodecSpecificInfo(
+    webrtc::VideoCodecType codec, bool key_frame,
+    webrtc::H264PacketizationMode packetization_mode) {
+  webrtc::CodecSpecificInfo info;
+  info.codecType = codec;
+  if (codec == webrtc::kVideoCodecVP8) {
+    info.codecSpecific.VP8.nonReference = false;
+    info.codecSpecific.VP8.temporalIdx = webrtc::kNoTemporalIdx;
+    info.codecSpecific.VP8.layerSync = false;
+    info.codecSpecific.VP8.keyIdx = webrtc::kNoKeyIdx;
+  } else if (codec == webrtc::kVideoCodecH264) {
+    info.codecSpecific.H264.packetization_mode = packetization_mode;
+    info.codecSpecific.H264.temporal_idx = webrtc::kNoTemporalIdx;
+    info.codecSpecific.H264.base_layer_sync = false;
+    info.codecSpecific.H264.idr_frame = key_frame;
+  }
+  return info;
+}
+
+webrtc::H264PacketizationMode H264PacketizationModeOf(
+    const webrtc::SdpVideoFormat& format) {
+  auto it = format.parameters.find(cricket::kH264FmtpPacketizationMode);
+  return it != format.parameters.end() && it->second == "1"
+             ? webrtc::H264PacketizationMode::NonInterleaved
+             : webrtc::H264PacketizationMode::SingleNalUnit;
+}
+
+PassthroughVideoEncoderFactory::PassthroughVideoEncoderFactory(
+    std::unique_ptr<webrtc::VideoEncoderFactory> factory,
+    const RTCVideoEncoderCpuSettings& cpu_defaults)
+    : factory_(std::move(factory)), cpu_defaults_(cpu_defaults) {}
+
+std::vector<webrtc::SdpVideoFormat>
+PassthroughVideoEncoderFactory::GetSupportedFormats() const {
+  std::vector<webrtc::SdpVideoFormat> formats = factory_->GetSupportedFormats();
+  if (!ContainsCodecName(formats, cricket::kVp8CodecName)) {
+    formats.push_back(webrtc::SdpVideoFormat(cricket::kVp8CodecName));
+  }
+  if (!ContainsCodecName(formats, cricket::kH264CodecName)) {
+    // Constrained baseline, the profile every H.264 decoder handles.
+    formats.push_back(webrtc::SdpVideoFormat(
+        cricket::kH264CodecName,
+        {{cricket::kH264FmtpLevelAsymmetryAllowed, "1"},
+         {cricket::kH264FmtpPacketizationMode, "1"},
+         {cricket::kH264FmtpProfileLevelId, "42e01f"}}));
+  }
+  return formats;
+}
+
+std::unique_ptr<webrtc::VideoEncoder>
+PassthroughVideoEncoderFactory::CreateVideoEncoder(
+    const webrtc::SdpVideoFormat& format) {
+  webrtc::SdpVideoFormat stripped = format;
+  RTCVideoEncoderCpuSettings cpu_settings =
+      TakeVideoEncoderCpuSettings(&stripped);
+  if (cpu_settings.complexity < 0) {
+    cpu_settings.complexity = cpu_defaults_.complexity;
+  }
+  if (cpu_settings.max_threads <= 0) {
+    cpu_settings.max_threads = cpu_defaults_.max_threads;
+  }
+  std::unique_ptr<webrtc::VideoEncoder> encoder;
+  if (ContainsCodec(factory_->GetSupportedFormats(), stripped)) {
+    encoder = factory_->CreateVideoEncoder(stripped);
+  }
+  return std::make_unique<PassthroughVideoEncoder>(
+      std::move(encoder), cpu_settings, H264PacketizationModeOf(format));
+}
+
+PassthroughVideoEncoder::PassthroughVideoEncoder(
+    std::unique_ptr<webrtc::VideoEncoder> encoder,
+    const RTCVideoEncoderCpuSettings& cpu_settings,
+    webrtc::H264PacketizationMode packetization_mode)
+    : encoder_(std::move(encoder)),
+      cpu_settings_(cpu_settings),
+      packetization_mode_(packetization_mode) {}
+
+void PassthroughVideoEncoder::SetFecControllerOverride(
+    webrtc::FecControllerOverride* fec_controller_override) {
+  if (encoder_) {
+    encoder_->SetFecControllerOverride(fec_controller_override);
+  }
+}
+
+int PassthroughVideoEncoder::InitEncode(
+    const webrtc::VideoCodec* codec_settings,
+    const webrtc::VideoEncoder::Settings& settings) {
+  codec_type_ = codec_settings->codecType;
+  if (encoder_) {
+    webrtc::VideoCodec codec = *codec_settings;
+    if (cpu_settings_.complexity >= 0) {
+      codec.SetVideoEncoderComplexity(
+          ToVideoCodecComplexity(cpu_settings_.complexity));
+    }
+    int number_of_cores = settings.number_of_cores;
+    if (cpu_settings_.max_threads > 0) {
+      number_of_cores = std::min(number_of_cores, cpu_settings_.max_threads);
+    }
+    complexity_ = FromVideoCodecComplexity(codec.GetVideoEncoderComplexity());
+    number_of_cores_ = number_of_cores;
+    const webrtc::VideoEncoder::Settings limited(
+        settings.capabilities, number_of_cores, settings.max_payload_size);
+    // A failure only matters once raw frames arrive.
+    encoder_initialized_ =
+        encoder_->InitEncode(&codec, limited) == WEBRTC_VIDEO_CODEC_OK;
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PassthroughVideoEncoder::RegisterEncodeCompleteCallback(
+    webrtc::EncodedImageCallback* callback) {
+  callback_ = callback;
+  if (encoder_) {
+    encoder_->RegisterEncodeCompleteCallback(callback);
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PassthroughVideoEncoder::Release() {
+  if (encoder_ && encoder_initialized_) {
+    encoder_->Release();
+  }
+  encoder_initialized_ = false;
+  last_source_ = nullptr;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PassthroughVideoEncoder::Encode(
+    const webrtc::VideoFrame& frame,
+    const std::vector<webrtc::VideoFrameType>* frame_types) {
+  EncodedVideoFrameBuffer* encoded =
+      EncodedVideoFrameBuffer::From(frame.video_frame_buffer().get());
+  if (!encoded) {
+    passing_through_ = false;
+    return EncodeWithEncoder(frame, frame_types);
+  }
+  passing_through_ = true;
+  if (!callback_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+
+  EncodedVideoTrackSource* source = encoded->source();
+  if (source != last_source_) {
+    last_source_ = source;
+    next_sequence_ = encoded->sequence();
+    waiting_for_key_frame_ = true;
+    if (source->codec() != codec_type_) {
+      RTC_LOG(LS_WARNING) << "Encoded source codec "
+                          << webrtc::CodecTypeToPayloadString(source->codec())
+                          << " differs from the negotiated "
+                          << webrtc::CodecTypeToPayloadString(codec_type_)
+                          << ", dropping its frames.";
+    }
+  }
+  if (source->codec() != codec_type_) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  const bool lost = encoded->sequence() != next_sequence_;
+  next_sequence_ = encoded->sequence() + 1;
+  const bool key_frame_requested =
+      frame_types &&
+      std::find(frame_types->begin(), frame_types->end(),
+                webrtc::VideoFrameType::kVideoFrameKey) != frame_types->end();
+  if (encoded->key_frame()) {
+    waiting_for_key_frame_ = false;
+  } else if (lost) {
+    waiting_for_key_frame_ = true;
+  }
+  if (!encoded->key_frame() &&
+      (key_frame_requested || waiting_for_key_frame_)) {
+    source->RequestKeyFrame();
+  }
+  if (waiting_for_key_frame_) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  webrtc::EncodedImage image;
+  image.SetEncodedData(encoded->data());
+  image.SetRtpTimestamp(frame.rtp_timestamp());
+  image.capture_time_ms_ = frame.render_time_ms();
+  image._encodedWidth = encoded->width();
+  image._encodedHeight = encoded->height();
+  image._frameType = encoded->key_frame()
+                         ? webrtc::VideoFrameType::kVideoFrameKey
+                         : webrtc::VideoFrameType::kVideoFrameDelta;
+  image.rotation_ = frame.rotation();
+
+  webrtc::CodecSpecificInfo info =
+      SingleLayerCodecSpecificInfo(codec_type_, encoded->key_frame(),
+                                   packetization_mode_);
+  const webrtc::EncodedImageCallback::Result result =
+      callback_->OnEncodedImage(image, &info);
+  return result.error == webrtc::EncodedImageCallback::Result::OK
+             ? WEBRTC_VIDEO_CODEC_OK
+             : WEBRTC_VIDEO_CODEC_ERROR;
+}
+
+int32_t PassthroughVideoEncoder::EncodeWithEncoder(
+    const webrtc::VideoFrame& frame,
+    const std::vector<webrtc::VideoFrameType>* frame_types) {
+  if (!encoder_ || !encoder_initialized_) {
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  }
+  // This encoder claims native frame support for the pass-through path, so
+  // convert other native frames for encoders without it.
+  if (frame.video_frame_buffer()->type() ==
+          webrtc::VideoFrameBuffer::Type::kNative &&
+      !encoder_->GetEncoderInfo().supports_native_handle) {
+    webrtc::VideoFrame converted = frame;
+    converted.set_video_frame_buffer(frame.video_frame_buffer()->ToI420());
+    return encoder_->Encode(converted, frame_types);
+  }
+  return encoder_->Encode(frame, frame_types);
+}
+
+void PassthroughVideoEncoder::SetRates(
+    const RateControlParameters& parameters) {
+  // The access units are sent as they are; only a real encoder can follow
+  // the target bitrate.
+  if (encoder_ && encoder_initialized_) {
+    encoder_->SetRates(parameters);
+  }
+}
+
+void PassthroughVideoEncoder::OnPacketLossRateUpdate(float packet_loss_rate) {
+  if (encoder_) {
+    encoder_->OnPacketLossRateUpdate(packet_loss_rate);
+  }
+}
+
+void PassthroughVideoEncoder::OnRttUpdate(int64_t rtt_ms) {
+  if (encoder_) {
+    encoder_->OnRttUpdate(rtt_ms);
+  }
+}
+
+void PassthroughVideoEncoder::OnLossNotification(
+    const LossNotification& loss_notification) {
+  if (encoder_) {
+    encoder_->OnLossNotification(loss_notification);
+  }
+}
+
+webrtc::VideoEncoder::EncoderInfo PassthroughVideoEncoder::GetEncoderInfo()
+    const {
+  EncoderInfo info = encoder_ ? encoder_->GetEncoderInfo() : EncoderInfo();
+  info.supports_native_handle = true;
+  if (passing_through_ || !encoder_) {
+    info.implementation_name = "Passthrough";
+    info.is_hardware_accelerated = false;
+    // Frames must not be dropped or scaled for bitrate: the access units
+    // cannot be changed and a gap breaks the stream until the next key
+    // frame.
+    info.has_trusted_rate_controller = true;
+    info.scaling_settings = ScalingSettings(ScalingSettings::kOff);
+  } else if (cpu_settings_.complexity >= 0 || cpu_settings_.max_threads > 0) {
+    info.implementation_name += " (complexity " + std::to_string(complexity_) +
+                                ", " + std::to_string(number_of_cores_) +
+                                " cores)";
+  }
+  return info;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,97 @@
+#ifndef INTERNAL_PASSTHROUGH_VIDEO_ENCODER_HXX
+#define INTERNAL_PASSTHROUGH_VIDEO_ENCODER_HXX
+
+#include <memory>
+#include <vector>
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_encoder.h"
+#include "api/video_codecs/video_encoder_factory.h"
+#include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_rtp_sender.h"
+
+namespace libwebrtc {
+
+// The codec-specific info the packetizers need for a frame of a VP8 or H264
+// stream without temporal or spatial layers. |packetization_mode| is the
+// negotiated one of an H264 stream.
+webrtc::CodecSpecificInfo SingleLayerCodecSpecificInfo(
+    webrtc::VideoCodecType codec, bool key_frame,
+    webrtc::H264PacketizationMode packetization_mode =
+        webrtc::H264PacketizationMode::NonInterleaved);
+
+// The packetization-mode of an H264 |format|; mode 0 when it is absent, as
+// RFC 6184 specifies.
+webrtc::H264PacketizationMode H264PacketizationModeOf(
+    const webrtc::SdpVideoFormat& format);
+
+// Wraps the factory's video encoders so that frames of an
+// EncodedVideoTrackSource are sent without encoding, while all other frames
+// go to the wrapped encoder. The codecs that can be passed through are
+// offered even when no encoder for them is built in. The wrapped encoders
+// get the CPU limits of their sender, or |cpu_defaults|.
+class PassthroughVideoEncoderFactory : public webrtc::VideoEncoderFactory {
+ public:
+  PassthroughVideoEncoderFactory(
+      std::unique_ptr<webrtc::VideoEncoderFactory> factory,
+      const RTCVideoEncoderCpuSettings& cpu_defaults);
+
+  std::vector<webrtc::SdpVideoFormat> GetSupportedFormats() const override;
+
+  std::unique_ptr<webrtc::VideoEncoder> CreateVideoEncoder(
+      const webrtc::SdpVideoFormat& format) override;
+
+ private:
+  const std::unique_ptr<webrtc::VideoEncoderFactory> factory_;
+  const RTCVideoEncoderCpuSettings cpu_defaults_;
+};
+
+class PassthroughVideoEncoder : public webrtc::VideoEncoder {
+ public:
+  // |encoder| may be null when the codec is only passed through.
+  // |packetization_mode| is used for passed-through H264 frames.
+  PassthroughVideoEncoder(std::unique_ptr<webrtc::VideoEncoder> encoder,
+                          const RTCVideoEncoderCpuSettings& cpu_settings,
+                          webrtc::H264PacketizationMode packetization_mode);
+
+  void SetFecControllerOverride(
+      webrtc::FecControllerOverride* fec_controller_override) override;
+  int InitEncode(const webrtc::VideoCodec* codec_settings,
+                 const webrtc::VideoEncoder::Settings& settings) override;
+  int32_t RegisterEncodeCompleteCallback(
+      webrtc::EncodedImageCallback* callback) override;
+  int32_t Release() override;
+  int32_t Encode(const webrtc::VideoFrame& frame,
+                 const std::vector<webrtc::VideoFrameType>* frame_types)
+      override;
+  void SetRates(const RateControlParameters& parameters) override;
+  void OnPacketLossRateUpdate(float packet_loss_rate) override;
+  void OnRttUpdate(int64_t rtt_ms) override;
+  void OnLossNotification(const LossNotification& loss_notification) override;
+  EncoderInfo GetEncoderInfo() const override;
+
+ private:
+  int32_t EncodeWithEncoder(
+      const webrtc::VideoFrame& frame,
+      const std::vector<webrtc::VideoFrameType>* frame_types);
+
+  const std::unique_ptr<webrtc::VideoEncoder> encoder_;
+  const RTCVideoEncoderCpuSettings cpu_settings_;
+  const webrtc::H264PacketizationMode packetization_mode_;
+  // What |encoder_| was last initialized with, for the stats.
+  int complexity_ = 1;
+  int number_of_cores_ = 0;
+  webrtc::EncodedImageCallback* callback_ = nullptr;
+  webrtc::VideoCodecType codec_type_ = webrtc::kVideoCodecGeneric;
+  bool encoder_initialized_ = false;
+  bool passing_through_ = false;
+  // Passed-through frames are dropped from a lost frame until the next key
+  // frame, since receivers could not decode them.
+  bool waiting_for_key_frame_ = true;
+  const void* last_source_ = nullptr;
+  uint64_t next_sequence_ = 0;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_PASSTHROUGH_VIDEO_ENCODER_HXX
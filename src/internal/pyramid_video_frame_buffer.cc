@@ -0,0 +1,54 @@
+#include "src/internal/pyramid_video_frame_buffer.h"
+
+namespace libwebrtc {
+
+PyramidVideoFrameBuffer::PyramidVideoFrameBuffer(
+    rtc::scoped_refptr<webrtc::I420BufferInterface> full)
+    : full_(full) {}
+
+rtc::scoped_refptr<webrtc::VideoFrameBuffer>
+PyramidVideoFrameBuffer::CropAndScale(int offset_x, int offset_y,
+                                      int crop_width, int crop_height,
+                                      int scaled_width, int scaled_height) {
+  if (offset_x != 0 || offset_y != 0 || crop_width != width() ||
+      crop_height != height()) {
+    return webrtc::I420BufferInterface::CropAndScale(
+        offset_x, offset_y, crop_width, crop_height, scaled_width,
+        scaled_height);
+  }
+  if (scaled_width == width() && scaled_height == height()) {
+    return full_;
+  }
+
+  rtc::scoped_refptr<webrtc::I420BufferInterface> source = full_;
+  for (size_t i = 1; i <= kLevels; ++i) {
+    if ((width() >> i) < scaled_width || (height() >> i) < scaled_height) {
+      break;
+    }
+    source = Level(i);
+  }
+  if (source->width() == scaled_width && source->height() == scaled_height) {
+    return source;
+  }
+  rtc::scoped_refptr<webrtc::I420Buffer> scaled =
+      webrtc::I420Buffer::Create(scaled_width, scaled_height);
+  scaled->ScaleFrom(*source);
+  return scaled;
+}
+
+rtc::scoped_refptr<webrtc::I420BufferInterface> PyramidVideoFrameBuffer::Level(
+    size_t index) {
+  webrtc::MutexLock lock(&mutex_);
+  rtc::scoped_refptr<webrtc::I420BufferInterface> source = full_;
+  for (size_t i = 0; i < index; ++i) {
+    if (!levels_[i]) {
+      levels_[i] = webrtc::I420Buffer::Create(width() >> (i + 1),
+                                              height() >> (i + 1));
+      levels_[i]->ScaleFrom(*source);
+    }
+    source = levels_[i];
+  }
+  return source;
+}
+
+}  // namespace libwebrtc
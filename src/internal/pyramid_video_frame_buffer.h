@@ -0,0 +1,55 @@
+#ifndef INTERNAL_PYRAMID_VIDEO_FRAME_BUFFER_HXX
+#define INTERNAL_PYRAMID_VIDEO_FRAME_BUFFER_HXX
+
+#include <stddef.h>
+
+#include "api/scoped_refptr.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame_buffer.h"
+#include "rtc_base/synchronization/mutex.h"
+
+namespace libwebrtc {
+
+// An I420 frame that keeps its 1/2 and 1/4 downscales once computed.
+// Simulcast layers, the encoder adapter and preview renderers all call
+// Scale() on the same captured frame; with this buffer each level is scaled
+// once per frame, from the level above it, instead of once per caller from
+// the full frame.
+class PyramidVideoFrameBuffer : public webrtc::I420BufferInterface {
+ public:
+  explicit PyramidVideoFrameBuffer(
+      rtc::scoped_refptr<webrtc::I420BufferInterface> full);
+
+  int width() const override { return full_->width(); }
+  int height() const override { return full_->height(); }
+  const uint8_t* DataY() const override { return full_->DataY(); }
+  const uint8_t* DataU() const override { return full_->DataU(); }
+  const uint8_t* DataV() const override { return full_->DataV(); }
+  int StrideY() const override { return full_->StrideY(); }
+  int StrideU() const override { return full_->StrideU(); }
+  int StrideV() const override { return full_->StrideV(); }
+
+  // Uncropped requests are served from the smallest level that is at least
+  // the requested size; crops fall back to the full frame.
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScale(
+      int offset_x, int offset_y, int crop_width, int crop_height,
+      int scaled_width, int scaled_height) override;
+
+ private:
+  // Levels below the full frame: 1/2 and 1/4.
+  static const size_t kLevels = 2;
+
+  // Returns level |index| (1 is 1/2), scaling the missing levels above it
+  // first.
+  rtc::scoped_refptr<webrtc::I420BufferInterface> Level(size_t index);
+
+  const rtc::scoped_refptr<webrtc::I420BufferInterface> full_;
+
+  webrtc::Mutex mutex_;
+  rtc::scoped_refptr<webrtc::I420Buffer> levels_[kLevels]
+      RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_PYRAMID_VIDEO_FRAME_BUFFER_HXX
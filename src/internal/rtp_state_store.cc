@@ -0,0 +1,97 @@
+#include "src/internal/rtp_state_store.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/time_utils.h"
+
+namespace libwebrtc {
+
+SenderSettings RtpStateStore::GetSenderSettings(
+    const webrtc::RtpSenderInterface* sender) const {
+  webrtc::MutexLock lock(&mutex_);
+  auto it = entries_.find(sender);
+  return it != entries_.end() ? it->second.settings : SenderSettings();
+}
+
+void RtpStateStore::SetSenderSettings(
+    rtc::scoped_refptr<webrtc::RtpSenderInterface> sender,
+    const SenderSettings& settings) {
+  webrtc::MutexLock lock(&mutex_);
+  EntryOf(sender.get(), sender).settings = settings;
+}
+
+bool RtpStateStore::KeyFrameRequestDue(const void* owner) const {
+  const int64_t now_ms = rtc::TimeMillis();
+  webrtc::MutexLock lock(&mutex_);
+  auto it = entries_.find(owner);
+  if (it == entries_.end() || it->second.last_key_frame_request_ms < 0) {
+    return true;
+  }
+  return now_ms - it->second.last_key_frame_request_ms >=
+         it->second.min_key_frame_interval_ms;
+}
+
+void RtpStateStore::OnKeyFrameRequestSent(
+    const void* key, rtc::scoped_refptr<rtc::RefCountInterface> owner) {
+  const int64_t now_ms = rtc::TimeMillis();
+  webrtc::MutexLock lock(&mutex_);
+  Entry& entry = EntryOf(key, owner);
+  entry.last_key_frame_request_ms = now_ms;
+  ++entry.key_frame_requests;
+}
+
+void RtpStateStore::SetMinKeyFrameRequestInterval(
+    const void* key, rtc::scoped_refptr<rtc::RefCountInterface> owner,
+    int interval_ms) {
+  webrtc::MutexLock lock(&mutex_);
+  EntryOf(key, owner).min_key_frame_interval_ms = std::max(interval_ms, 0);
+}
+
+int RtpStateStore::GetMinKeyFrameRequestInterval(const void* owner) const {
+  webrtc::MutexLock lock(&mutex_);
+  auto it = entries_.find(owner);
+  return it != entries_.end() ? it->second.min_key_frame_interval_ms
+                              : kDefaultMinKeyFrameRequestIntervalMs;
+}
+
+uint64_t RtpStateStore::GetKeyFrameRequests(const void* owner) const {
+  webrtc::MutexLock lock(&mutex_);
+  auto it = entries_.find(owner);
+  return it != entries_.end() ? it->second.key_frame_requests : 0;
+}
+
+void RtpStateStore::Prune(const std::vector<const void*>& live) {
+  std::vector<Entry> removed;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (std::find(live.begin(), live.end(), it->first) == live.end()) {
+        removed.push_back(std::move(it->second));
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // |removed| releases its references outside the lock.
+}
+
+void RtpStateStore::Clear() {
+  std::map<const void*, Entry> removed;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    removed.swap(entries_);
+  }
+}
+
+RtpStateStore::Entry& RtpStateStore::EntryOf(
+    const void* key, rtc::scoped_refptr<rtc::RefCountInterface> owner) {
+  Entry& entry = entries_[key];
+  if (!entry.owner) {
+    entry.owner = std::move(owner);
+  }
+  return entry;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,112 @@
+#ifndef INTERNAL_RTP_STATE_STORE_HXX
+#define INTERNAL_RTP_STATE_STORE_HXX
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "api/ref_counted_base.h"
+#include "api/rtp_sender_interface.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_rtp_sender.h"
+#include "src/internal/event_dispatcher.h"
+
+namespace libwebrtc {
+
+// Minimum interval of RequestKeyFrame() on senders and receivers until one
+// is set; the same as RTCVideoRelay's default.
+const int kDefaultMinKeyFrameRequestIntervalMs = 300;
+
+// Per-sender settings that webrtc's sender has no place for.
+struct SenderSettings {
+  bool has_opus_settings = false;
+  RTCOpusSettings opus;
+  bool has_video_encoder_cpu_settings = false;
+  RTCVideoEncoderCpuSettings video_encoder_cpu;
+};
+
+// State of the senders and receivers of one peer connection. Their wrappers
+// are recreated on every call, so the ones the peer connection creates share
+// its store. Entries are keyed by the webrtc sender or receiver and hold a
+// reference to it, so the address cannot be reused while the entry exists;
+// the peer connection prunes the entries of those it no longer has.
+class RtpStateStore : public rtc::RefCountedBase {
+ public:
+  explicit RtpStateStore(rtc::scoped_refptr<EventDispatcher> dispatcher)
+      : dispatcher_(dispatcher) {}
+
+  // The dispatcher of the factory that created the peer connection, for the
+  // track and stream wrappers that sender and receiver wrappers create.
+  rtc::scoped_refptr<EventDispatcher> dispatcher() const {
+    return dispatcher_;
+  }
+
+  // Returns the settings of |sender|, or defaults if none were set.
+  SenderSettings GetSenderSettings(
+      const webrtc::RtpSenderInterface* sender) const;
+
+  void SetSenderSettings(
+      rtc::scoped_refptr<webrtc::RtpSenderInterface> sender,
+      const SenderSettings& settings);
+
+  // Key frame requests of a sender or receiver. A request is due if the
+  // last one that was sent is at least the minimum interval old; checking
+  // does not count it.
+  bool KeyFrameRequestDue(const void* owner) const;
+
+  template <typename Owner>
+  void OnKeyFrameRequestSent(const rtc::scoped_refptr<Owner>& owner) {
+    OnKeyFrameRequestSent(owner.get(), owner);
+  }
+
+  template <typename Owner>
+  void SetMinKeyFrameRequestInterval(const rtc::scoped_refptr<Owner>& owner,
+                                     int interval_ms) {
+    SetMinKeyFrameRequestInterval(owner.get(), owner, interval_ms);
+  }
+
+  int GetMinKeyFrameRequestInterval(const void* owner) const;
+
+  // Requests of |owner| that were sent.
+  uint64_t GetKeyFrameRequests(const void* owner) const;
+
+  // Drops the entries of senders and receivers that are not in |live|.
+  void Prune(const std::vector<const void*>& live);
+
+  void Clear();
+
+ protected:
+  ~RtpStateStore() override = default;
+
+ private:
+  struct Entry {
+    rtc::scoped_refptr<rtc::RefCountInterface> owner;
+    SenderSettings settings;
+    int min_key_frame_interval_ms = kDefaultMinKeyFrameRequestIntervalMs;
+    int64_t last_key_frame_request_ms = -1;
+    uint64_t key_frame_requests = 0;
+  };
+
+  void OnKeyFrameRequestSent(const void* key,
+                             rtc::scoped_refptr<rtc::RefCountInterface> owner);
+
+  void SetMinKeyFrameRequestInterval(
+      const void* key, rtc::scoped_refptr<rtc::RefCountInterface> owner,
+      int interval_ms);
+
+  // Returns the entry of |key|, creating it with |owner|.
+  Entry& EntryOf(const void* key,
+                 rtc::scoped_refptr<rtc::RefCountInterface> owner)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const rtc::scoped_refptr<EventDispatcher> dispatcher_;
+  mutable webrtc::Mutex mutex_;
+  std::map<const void*, Entry> entries_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_RTP_STATE_STORE_HXX
@@ -0,0 +1,245 @@
+#include "src/internal/shared_desktop_capturer.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "api/sequence_checker.h"
+#include "modules/desktop_capture/desktop_and_cursor_composer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+
+namespace libwebrtc {
+
+namespace {
+
+enum { kFrameJitterMs = 5 };
+
+typedef std::tuple<DesktopType, webrtc::DesktopCapturer::SourceId, bool>
+    CapturerKey;
+
+std::mutex& RegistryMutex() {
+  static std::mutex* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::map<CapturerKey, std::weak_ptr<SharedDesktopCapturer>>& Registry() {
+  static auto* registry =
+      new std::map<CapturerKey, std::weak_ptr<SharedDesktopCapturer>>();
+  return *registry;
+}
+
+}  // namespace
+
+std::shared_ptr<SharedDesktopCapturer> SharedDesktopCapturer::GetOrCreate(
+    DesktopType type, webrtc::DesktopCapturer::SourceId source_id,
+    bool compose_cursor) {
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  auto& entry = Registry()[CapturerKey(type, source_id, compose_cursor)];
+  std::shared_ptr<SharedDesktopCapturer> capturer = entry.lock();
+  if (!capturer) {
+    capturer = std::make_shared<SharedDesktopCapturer>(type, source_id,
+                                                       compose_cursor);
+    entry = capturer;
+  }
+  return capturer;
+}
+
+SharedDesktopCapturer::SharedDesktopCapturer(
+    DesktopType type, webrtc::DesktopCapturer::SourceId source_id,
+    bool compose_cursor)
+    : type_(type),
+      source_id_(source_id),
+      compose_cursor_(compose_cursor),
+      job_(DesktopCaptureScheduler::Instance()->CreateJob(
+          (type == kScreen ? "screen:" : "window:") +
+          std::to_string(source_id))),
+      thread_(job_->thread()) {
+  options_ = webrtc::DesktopCaptureOptions::CreateDefault();
+  options_.set_detect_updated_region(true);
+#ifdef WEBRTC_WIN
+  options_.set_allow_directx_capturer(true);
+#endif
+#ifdef WEBRTC_LINUX
+  if (type == kScreen) {
+    options_.set_allow_pipewire(true);
+  }
+#endif
+  thread_->BlockingCall([this, type] {
+    std::unique_ptr<webrtc::DesktopCapturer> capturer =
+        type == kScreen
+            ? webrtc::DesktopCapturer::CreateScreenCapturer(options_)
+            : webrtc::DesktopCapturer::CreateWindowCapturer(options_);
+    if (compose_cursor_) {
+      capturer_ = std::make_unique<webrtc::DesktopAndCursorComposer>(
+          std::move(capturer), options_);
+    } else {
+      capturer_ = std::move(capturer);
+      cursor_monitor_ = webrtc::MouseCursorMonitor::Create(options_);
+    }
+  });
+}
+
+SharedDesktopCapturer::~SharedDesktopCapturer() {
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto it = Registry().find(CapturerKey(type_, source_id_, compose_cursor_));
+    // A new capturer may already have replaced this one.
+    if (it != Registry().end() && it->second.expired()) {
+      Registry().erase(it);
+    }
+  }
+  thread_->BlockingCall([this] {
+    consumers_.clear();
+    cursor_.reset();
+    cursor_monitor_.reset();
+    capturer_.reset();
+  });
+  // Drops the pending capture tick, if any.
+  job_.reset();
+}
+
+bool SharedDesktopCapturer::AddConsumer(Consumer* consumer,
+                                        uint32_t interval_ms) {
+  return thread_->BlockingCall([this, consumer, interval_ms] {
+    RTC_DCHECK_RUN_ON(thread_);
+    if (!capturer_started_) {
+      if (source_id_ != -1) {
+        if (!capturer_->SelectSource(source_id_)) {
+          return false;
+        }
+        if (type_ == kWindow && !capturer_->FocusOnSelectedSource()) {
+          return false;
+        }
+      }
+      capturer_->Start(this);
+      if (cursor_monitor_) {
+        cursor_monitor_->Init(this,
+                              webrtc::MouseCursorMonitor::SHAPE_AND_POSITION);
+      }
+      capturer_started_ = true;
+    }
+
+    auto it = std::find_if(
+        consumers_.begin(), consumers_.end(),
+        [consumer](const ConsumerState& s) { return s.consumer == consumer; });
+    if (it != consumers_.end()) {
+      it->interval_ms = interval_ms;
+    } else {
+      consumers_.push_back({consumer, interval_ms, rtc::TimeMillis()});
+      // The monitor only reports changes, so a late consumer gets the
+      // current cursor here.
+      if (cursor_) {
+        consumer->OnSharedCursorShape(*cursor_);
+      }
+      if (cursor_reported_) {
+        consumer->OnSharedCursorPosition(cursor_position_, cursor_inside_);
+      }
+    }
+
+    if (!loop_scheduled_) {
+      loop_scheduled_ = true;
+      job_->PostTask([this] { CaptureFrame(); });
+    }
+    return true;
+  });
+}
+
+void SharedDesktopCapturer::RemoveConsumer(Consumer* consumer) {
+  thread_->BlockingCall([this, consumer] {
+    RTC_DCHECK_RUN_ON(thread_);
+    consumers_.erase(
+        std::remove_if(consumers_.begin(), consumers_.end(),
+                       [consumer](const ConsumerState& s) {
+                         return s.consumer == consumer;
+                       }),
+        consumers_.end());
+  });
+}
+
+uint32_t SharedDesktopCapturer::CaptureInterval() const {
+  uint32_t interval = 1000;
+  for (const auto& state : consumers_) {
+    interval = std::min(interval, state.interval_ms);
+  }
+  return interval;
+}
+
+void SharedDesktopCapturer::CaptureFrame() {
+  RTC_DCHECK_RUN_ON(thread_);
+  if (consumers_.empty()) {
+    // Nobody is listening; the next AddConsumer() restarts the loop.
+    loop_scheduled_ = false;
+    return;
+  }
+  capturer_->CaptureFrame();
+  if (cursor_monitor_) {
+    cursor_monitor_->Capture();
+  }
+  job_->PostDelayedTask(
+      [this]() { CaptureFrame(); },
+      webrtc::TimeDelta::Millis(CaptureInterval()));
+}
+
+void SharedDesktopCapturer::OnCaptureResult(
+    webrtc::DesktopCapturer::Result result,
+    std::unique_ptr<webrtc::DesktopFrame> frame) {
+  RTC_DCHECK_RUN_ON(thread_);
+  const int64_t now_ms = rtc::TimeMillis();
+  const bool success = result == webrtc::DesktopCapturer::Result::SUCCESS;
+  if (success && frame) {
+    frame_rect_ =
+        webrtc::DesktopRect::MakeOriginSize(frame->top_left(), frame->size());
+  }
+  std::vector<Consumer*> due;
+  for (auto& state : consumers_) {
+    if (success) {
+      // Allow a little jitter so a consumer running at the loop rate is not
+      // skipped every other tick.
+      if (now_ms + kFrameJitterMs < state.next_frame_ms) {
+        continue;
+      }
+      state.next_frame_ms =
+          std::max(state.next_frame_ms + state.interval_ms, now_ms);
+    }
+    due.push_back(state.consumer);
+  }
+  for (Consumer* consumer : due) {
+    consumer->OnSharedCaptureResult(result, success ? frame.get() : nullptr);
+  }
+}
+
+void SharedDesktopCapturer::OnMouseCursor(webrtc::MouseCursor* cursor) {
+  RTC_DCHECK_RUN_ON(thread_);
+  cursor_.reset(cursor);
+  std::vector<ConsumerState> consumers = consumers_;
+  for (const auto& state : consumers) {
+    state.consumer->OnSharedCursorShape(*cursor_);
+  }
+}
+
+void SharedDesktopCapturer::OnMouseCursorPosition(
+    const webrtc::DesktopVector& position) {
+  RTC_DCHECK_RUN_ON(thread_);
+  if (frame_rect_.is_empty()) {
+    return;
+  }
+  webrtc::DesktopVector relative = position.subtract(frame_rect_.top_left());
+  bool inside = frame_rect_.Contains(position);
+  if (cursor_reported_ && relative.equals(cursor_position_) &&
+      inside == cursor_inside_) {
+    return;
+  }
+  cursor_reported_ = true;
+  cursor_position_ = relative;
+  cursor_inside_ = inside;
+  std::vector<ConsumerState> consumers = consumers_;
+  for (const auto& state : consumers) {
+    state.consumer->OnSharedCursorPosition(relative, inside);
+  }
+}
+
+}  // namespace libwebrtc
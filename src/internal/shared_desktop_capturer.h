@@ -0,0 +1,112 @@
+#ifndef INTERNAL_SHARED_DESKTOP_CAPTURER_HXX
+#define INTERNAL_SHARED_DESKTOP_CAPTURER_HXX
+
+#include <memory>
+#include <vector>
+
+#include "modules/desktop_capture/desktop_capture_options.h"
+#include "modules/desktop_capture/desktop_capturer.h"
+#include "modules/desktop_capture/desktop_frame.h"
+#include "modules/desktop_capture/mouse_cursor.h"
+#include "modules/desktop_capture/mouse_cursor_monitor.h"
+#include "rtc_types.h"
+#include "src/internal/desktop_capture_scheduler.h"
+
+namespace libwebrtc {
+
+// One capture loop per (type, source id), shared by every RTCDesktopCapturer
+// that targets the same screen or window. Each consumer gets the raw desktop
+// frame at its own rate and does its own crop/scale, so two previews and a
+// peer connection of the same display only pay for one capture.
+//
+// Without cursor composition the cursor is left out of the frames and its
+// shape and position are reported to consumers separately, so cursor moves
+// alone do not dirty the frame.
+class SharedDesktopCapturer : public webrtc::DesktopCapturer::Callback,
+                              public webrtc::MouseCursorMonitor::Callback {
+ public:
+  class Consumer {
+   public:
+    // Called on the capture thread. |frame| is null unless |result| is
+    // SUCCESS and is only valid for the duration of the call.
+    virtual void OnSharedCaptureResult(webrtc::DesktopCapturer::Result result,
+                                       const webrtc::DesktopFrame* frame) = 0;
+
+    // Cursor callbacks, only used when the cursor is not composed into the
+    // frame. Called on the capture thread when the shape changes, and when
+    // the position (relative to the last captured frame) changes. A new
+    // consumer gets the current shape and position from AddConsumer().
+    virtual void OnSharedCursorShape(const webrtc::MouseCursor& cursor) {}
+
+    virtual void OnSharedCursorPosition(const webrtc::DesktopVector& position,
+                                        bool inside_frame) {}
+
+   protected:
+    virtual ~Consumer() {}
+  };
+
+  // Returns the capturer already running for |source_id|, or creates one.
+  // The loop is torn down when the last reference goes away.
+  static std::shared_ptr<SharedDesktopCapturer> GetOrCreate(
+      DesktopType type, webrtc::DesktopCapturer::SourceId source_id,
+      bool compose_cursor = true);
+
+  SharedDesktopCapturer(DesktopType type,
+                        webrtc::DesktopCapturer::SourceId source_id,
+                        bool compose_cursor);
+  ~SharedDesktopCapturer() override;
+
+  // Starts delivering frames to |consumer| every |interval_ms|. Returns false
+  // if the source could not be selected.
+  bool AddConsumer(Consumer* consumer, uint32_t interval_ms);
+
+  // After this returns |consumer| will not be called again.
+  void RemoveConsumer(Consumer* consumer);
+
+  DesktopType type() const { return type_; }
+
+  webrtc::DesktopCapturer::SourceId source_id() const { return source_id_; }
+
+  bool compose_cursor() const { return compose_cursor_; }
+
+ private:
+  struct ConsumerState {
+    Consumer* consumer;
+    uint32_t interval_ms;
+    int64_t next_frame_ms;
+  };
+
+  void OnCaptureResult(webrtc::DesktopCapturer::Result result,
+                       std::unique_ptr<webrtc::DesktopFrame> frame) override;
+
+  // webrtc::MouseCursorMonitor::Callback
+  void OnMouseCursor(webrtc::MouseCursor* cursor) override;
+  void OnMouseCursorPosition(const webrtc::DesktopVector& position) override;
+
+  void CaptureFrame();
+
+  uint32_t CaptureInterval() const;
+
+  DesktopType type_;
+  webrtc::DesktopCapturer::SourceId source_id_;
+  bool compose_cursor_;
+  webrtc::DesktopCaptureOptions options_;
+  std::unique_ptr<DesktopCaptureScheduler::Job> job_;
+  rtc::Thread* thread_;
+  std::unique_ptr<webrtc::DesktopCapturer> capturer_;
+  std::unique_ptr<webrtc::MouseCursorMonitor> cursor_monitor_;
+  // Only accessed on |thread_|, the job's capture thread.
+  std::vector<ConsumerState> consumers_;
+  webrtc::DesktopRect frame_rect_;
+  // The last shape and position reported, replayed to new consumers.
+  std::unique_ptr<webrtc::MouseCursor> cursor_;
+  webrtc::DesktopVector cursor_position_;
+  bool cursor_inside_ = false;
+  bool cursor_reported_ = false;
+  bool capturer_started_ = false;
+  bool loop_scheduled_ = false;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_SHARED_DESKTOP_CAPTURER_HXX
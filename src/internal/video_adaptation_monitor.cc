@@ -0,0 +1,238 @@
+#include "src/internal/video_adaptation_monitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/stats/rtcstats_objects.h"
+#include "base/refcountedobject.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "src/internal/event_dispatcher.h"
+#include "src/rtc_rtp_sender_impl.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Frame rate change, relative to the last report, that is reported on its
+// own. Smaller changes are noise of the stats' one second window.
+const double kFramerateChange = 0.25;
+
+class StatsCallback : public webrtc::RTCStatsCollectorCallback {
+ public:
+  using Handler = std::function<void(
+      const rtc::scoped_refptr<const webrtc::RTCStatsReport>&)>;
+
+  explicit StatsCallback(Handler handler) : handler_(std::move(handler)) {}
+
+  void OnStatsDelivered(
+      const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report)
+      override {
+    handler_(report);
+  }
+
+ private:
+  const Handler handler_;
+};
+
+RTCQualityLimitationReason ToQualityLimitationReason(
+    const std::string& reason) {
+  if (reason == "cpu") return RTCQualityLimitationReason::kCpu;
+  if (reason == "bandwidth") return RTCQualityLimitationReason::kBandwidth;
+  if (reason == "other") return RTCQualityLimitationReason::kOther;
+  return RTCQualityLimitationReason::kNone;
+}
+
+// Whether |state| is worth reporting after |last|.
+bool Changed(const RTCVideoAdaptationState& last,
+             const RTCVideoAdaptationState& state) {
+  if (state.reason != last.reason || state.width != last.width ||
+      state.height != last.height) {
+    return true;
+  }
+  return std::abs(state.framerate - last.framerate) >=
+         kFramerateChange * std::max(last.framerate, 1.0);
+}
+
+}  // namespace
+
+VideoAdaptationMonitor::VideoAdaptationMonitor(
+    rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection,
+    rtc::scoped_refptr<EventDispatcher> dispatcher,
+    rtc::scoped_refptr<RtpStateStore> rtp_state,
+    RTCVideoAdaptationObserver* observer, int interval_ms)
+    : shared_(std::make_shared<Shared>(dispatcher, rtp_state)) {
+  {
+    webrtc::MutexLock lock(&shared_->mutex);
+    shared_->peer_connection = peer_connection;
+    shared_->observer = observer;
+  }
+  // Polling on the signaling thread keeps the peer connection's proxy from
+  // blocking on it, and the monitor never has to wait for a poll to end.
+  std::shared_ptr<Shared> shared = shared_;
+  const webrtc::TimeDelta interval =
+      webrtc::TimeDelta::Millis(std::max(interval_ms, 100));
+  rtc::Thread* signaling_thread = dispatcher->signaling_thread();
+  signaling_thread->PostTask([shared, interval, signaling_thread] {
+    webrtc::RepeatingTaskHandle::Start(signaling_thread, [shared, interval] {
+      return Poll(shared) ? interval : webrtc::TimeDelta::PlusInfinity();
+    });
+  });
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+VideoAdaptationMonitor::~VideoAdaptationMonitor() {
+  // Stops the polling without waiting for it. The reference is dropped
+  // outside the lock, since that can close the peer connection.
+  rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection;
+  bool in_callback;
+  {
+    webrtc::MutexLock lock(&shared_->mutex);
+    peer_connection = std::move(shared_->peer_connection);
+    shared_->observer = nullptr;
+    shared_->reported.clear();
+    in_callback = shared_->delivering &&
+                  rtc::IsThreadRefEqual(shared_->delivering_thread,
+                                        rtc::CurrentThreadRef());
+  }
+  if (!in_callback) {
+    // Waits for an event that already took the observer. From inside the
+    // callback there is nothing to wait for: it is the one running.
+    webrtc::MutexLock delivery_lock(&shared_->delivery_mutex);
+  }
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool VideoAdaptationMonitor::Poll(const std::shared_ptr<Shared>& shared) {
+  rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection;
+  {
+    webrtc::MutexLock lock(&shared->mutex);
+    peer_connection = shared->peer_connection;
+  }
+  if (!peer_connection) {
+    return false;
+  }
+
+  std::vector<rtc::scoped_refptr<webrtc::RtpSenderInterface>> senders;
+  for (const auto& sender : peer_connection->GetSenders()) {
+    if (sender->media_type() == cricket::MEDIA_TYPE_VIDEO) {
+      senders.push_back(sender);
+    }
+  }
+
+  {
+    // Forget removed senders.
+    webrtc::MutexLock lock(&shared->mutex);
+    for (auto it = shared->reported.begin();
+         it != shared->reported.end();) {
+      if (std::find(senders.begin(), senders.end(), it->second.sender) ==
+          senders.end()) {
+        it = shared->reported.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // One report per tick, split per sender below.
+  peer_connection->GetStats(
+      rtc::make_ref_counted<StatsCallback>(
+          [shared, senders](const rtc::scoped_refptr<
+                            const webrtc::RTCStatsReport>& report) {
+            for (const auto& sender : senders) {
+              OnStats(shared, sender, report);
+            }
+          })
+          .get());
+  return true;
+}
+
+void VideoAdaptationMonitor::OnStats(
+    const std::shared_ptr<Shared>& shared,
+    rtc::scoped_refptr<webrtc::RtpSenderInterface> sender,
+    const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report) {
+  rtc::scoped_refptr<webrtc::MediaStreamTrackInterface> track =
+      sender->track();
+  if (!track) {
+    return;
+  }
+
+  // The outbound-rtp streams of |sender| are the ones whose media source
+  // is its track. With simulcast the top layer is reported.
+  const webrtc::RTCOutboundRtpStreamStats* top = nullptr;
+  int64_t top_pixels = -1;
+  for (const webrtc::RTCOutboundRtpStreamStats* stats :
+       report->GetStatsOfType<webrtc::RTCOutboundRtpStreamStats>()) {
+    if (!stats->media_source_id.has_value()) {
+      continue;
+    }
+    const webrtc::RTCStats* source = report->Get(*stats->media_source_id);
+    if (!source ||
+        std::string(source->type()) != webrtc::RTCVideoSourceStats::kType ||
+        static_cast<const webrtc::RTCMediaSourceStats*>(source)
+                ->track_identifier.value_or(std::string()) != track->id()) {
+      continue;
+    }
+    const int64_t pixels =
+        static_cast<int64_t>(stats->frame_width.value_or(0)) *
+        stats->frame_height.value_or(0);
+    if (pixels > top_pixels) {
+      top = stats;
+      top_pixels = pixels;
+    }
+  }
+  if (!top) {
+    // Not sending yet.
+    return;
+  }
+
+  RTCVideoAdaptationState state;
+  state.reason = ToQualityLimitationReason(
+      top->quality_limitation_reason.value_or(std::string()));
+  state.width = static_cast<int>(top->frame_width.value_or(0));
+  state.height = static_cast<int>(top->frame_height.value_or(0));
+  state.framerate = top->frames_per_second.value_or(0.0);
+  state.resolution_changes =
+      top->quality_limitation_resolution_changes.value_or(0);
+
+  {
+    webrtc::MutexLock lock(&shared->mutex);
+    if (!shared->observer) {
+      return;
+    }
+    auto it = shared->reported.find(sender.get());
+    if (it != shared->reported.end() && !Changed(it->second.state, state)) {
+      return;
+    }
+    shared->reported[sender.get()] = Entry{sender, state};
+  }
+
+  shared->dispatcher->Post([shared, sender, state] {
+    // Held across the call so the destructor can wait for it.
+    webrtc::MutexLock delivery_lock(&shared->delivery_mutex);
+    RTCVideoAdaptationObserver* observer;
+    {
+      webrtc::MutexLock lock(&shared->mutex);
+      observer = shared->observer;
+      shared->delivering_thread = rtc::CurrentThreadRef();
+      shared->delivering = observer != nullptr;
+    }
+    if (!observer) {
+      return;
+    }
+    observer->OnVideoAdaptationChanged(
+        scoped_refptr<RTCRtpSender>(
+            new RefCountedObject<RTCRtpSenderImpl>(sender,
+                                                   shared->rtp_state)),
+        state);
+    webrtc::MutexLock lock(&shared->mutex);
+    shared->delivering = false;
+  });
+}
+
+}  // namespace libwebrtc
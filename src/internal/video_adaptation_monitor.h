@@ -0,0 +1,80 @@
+#ifndef INTERNAL_VIDEO_ADAPTATION_MONITOR_HXX
+#define INTERNAL_VIDEO_ADAPTATION_MONITOR_HXX
+
+#include <map>
+#include <memory>
+
+#include "api/peer_connection_interface.h"
+#include "api/rtp_sender_interface.h"
+#include "api/stats/rtc_stats_report.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_peerconnection.h"
+#include "src/internal/event_dispatcher.h"
+#include "src/internal/rtp_state_store.h"
+
+namespace libwebrtc {
+
+// Polls the outbound-rtp stats of the video senders of a peer connection and
+// posts their adaptation changes to an RTCVideoAdaptationObserver through the
+// dispatcher of the factory that created the peer connection.
+class VideoAdaptationMonitor {
+ public:
+  VideoAdaptationMonitor(
+      rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection,
+      rtc::scoped_refptr<EventDispatcher> dispatcher,
+      rtc::scoped_refptr<RtpStateStore> rtp_state,
+      RTCVideoAdaptationObserver* observer, int interval_ms);
+
+  // No events are delivered once this returns. Waits for a callback that is
+  // running on another thread; from inside the callback it does not wait.
+  ~VideoAdaptationMonitor();
+
+ private:
+  struct Entry {
+    rtc::scoped_refptr<webrtc::RtpSenderInterface> sender;
+    RTCVideoAdaptationState state;
+  };
+
+  // Shared with stats callbacks and queued events, which can outlive the
+  // monitor.
+  struct Shared {
+    Shared(rtc::scoped_refptr<EventDispatcher> dispatcher,
+           rtc::scoped_refptr<RtpStateStore> rtp_state)
+        : dispatcher(dispatcher), rtp_state(rtp_state) {}
+
+    const rtc::scoped_refptr<EventDispatcher> dispatcher;
+    // Passed to the sender wrappers of the events.
+    const rtc::scoped_refptr<RtpStateStore> rtp_state;
+    // Held while the observer is called. Taken before |mutex|.
+    webrtc::Mutex delivery_mutex;
+    webrtc::Mutex mutex;
+    // Null once the monitor is gone, which stops the polling.
+    rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection
+        RTC_GUARDED_BY(mutex);
+    RTCVideoAdaptationObserver* observer RTC_GUARDED_BY(mutex) = nullptr;
+    // The state last reported per sender.
+    std::map<webrtc::RtpSenderInterface*, Entry> reported
+        RTC_GUARDED_BY(mutex);
+    // The thread calling the observer, while |delivering|.
+    bool delivering RTC_GUARDED_BY(mutex) = false;
+    rtc::PlatformThreadRef delivering_thread RTC_GUARDED_BY(mutex);
+  };
+
+  // Runs every |interval_ms| on the signaling thread, where the peer
+  // connection is called directly. Returns false once the monitor is gone.
+  static bool Poll(const std::shared_ptr<Shared>& shared);
+
+  // Runs on the signaling thread with the stats of all senders; reports
+  // those of |sender|.
+  static void OnStats(
+      const std::shared_ptr<Shared>& shared,
+      rtc::scoped_refptr<webrtc::RtpSenderInterface> sender,
+      const rtc::scoped_refptr<const webrtc::RTCStatsReport>& report);
+
+  const std::shared_ptr<Shared> shared_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_VIDEO_ADAPTATION_MONITOR_HXX
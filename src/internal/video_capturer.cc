@@ -12,13 +12,30 @@
 
 #include <algorithm>
 
+#include "api/make_ref_counted.h"
 #include "api/scoped_refptr.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame_buffer.h"
 #include "api/video/video_rotation.h"
+#include "src/internal/pyramid_video_frame_buffer.h"
 
 namespace webrtc {
 namespace internal {
+namespace {
+
+// Lets every consumer of the frame share one set of downscales; see
+// libwebrtc::PyramidVideoFrameBuffer. Native buffers scale themselves.
+rtc::scoped_refptr<VideoFrameBuffer> WithPyramid(
+    rtc::scoped_refptr<VideoFrameBuffer> buffer) {
+  if (buffer->type() != VideoFrameBuffer::Type::kI420) {
+    return buffer;
+  }
+  return rtc::make_ref_counted<libwebrtc::PyramidVideoFrameBuffer>(
+      buffer->ToI420());
+}
+
+}  // namespace
+
 VideoCapturer::VideoCapturer() = default;
 VideoCapturer::~VideoCapturer() = default;
 
@@ -42,14 +59,16 @@ void VideoCapturer::OnFrame(const VideoFrame& frame) {
         I420Buffer::Create(out_width, out_height);
     scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
     broadcaster_.OnFrame(VideoFrame::Builder()
-                             .set_video_frame_buffer(scaled_buffer)
+                             .set_video_frame_buffer(WithPyramid(scaled_buffer))
                              .set_rotation(kVideoRotation_0)
                              .set_timestamp_us(frame.timestamp_us())
                              .set_id(frame.id())
                              .build());
   } else {
     // No adaptations needed, just return the frame as is.
-    broadcaster_.OnFrame(frame);
+    VideoFrame shared = frame;
+    shared.set_video_frame_buffer(WithPyramid(frame.video_frame_buffer()));
+    broadcaster_.OnFrame(shared);
   }
 }
 
@@ -0,0 +1,84 @@
+#include "src/internal/video_encoder_tuning.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "rtc_base/string_to_number.h"
+
+namespace libwebrtc {
+
+const char kVideoComplexityParameter[] = "x-libwebrtc-video-complexity";
+const char kVideoMaxThreadsParameter[] = "x-libwebrtc-max-threads";
+
+namespace {
+
+// Returns the value of |name| in |format|, or -1, and removes it.
+int TakeParameter(webrtc::SdpVideoFormat* format, const char* name) {
+  auto it = format->parameters.find(name);
+  if (it == format->parameters.end()) {
+    return -1;
+  }
+  absl::optional<int> value = rtc::StringToNumber<int>(it->second);
+  format->parameters.erase(it);
+  return value && *value >= 0 ? *value : -1;
+}
+
+}  // namespace
+
+void ApplyVideoEncoderCpuSettings(const RTCVideoEncoderCpuSettings& settings,
+                                  cricket::MediaContentDescription* video) {
+  std::vector<cricket::Codec> codecs = video->codecs();
+  for (cricket::Codec& codec : codecs) {
+    if (codec.GetResiliencyType() != cricket::Codec::ResiliencyType::kNone) {
+      continue;
+    }
+    if (settings.complexity >= 0) {
+      codec.SetParam(kVideoComplexityParameter,
+                     std::min(settings.complexity, 4));
+    }
+    if (settings.max_threads > 0) {
+      codec.SetParam(kVideoMaxThreadsParameter, settings.max_threads);
+    }
+  }
+  video->set_codecs(codecs);
+}
+
+RTCVideoEncoderCpuSettings TakeVideoEncoderCpuSettings(
+    webrtc::SdpVideoFormat* format) {
+  RTCVideoEncoderCpuSettings settings;
+  settings.complexity = TakeParameter(format, kVideoComplexityParameter);
+  settings.max_threads = TakeParameter(format, kVideoMaxThreadsParameter);
+  return settings;
+}
+
+webrtc::VideoCodecComplexity ToVideoCodecComplexity(int complexity) {
+  switch (complexity) {
+    case 0:
+      return webrtc::VideoCodecComplexity::kComplexityLow;
+    case 2:
+      return webrtc::VideoCodecComplexity::kComplexityHigh;
+    case 3:
+      return webrtc::VideoCodecComplexity::kComplexityHigher;
+    case 4:
+      return webrtc::VideoCodecComplexity::kComplexityMax;
+    default:
+      return webrtc::VideoCodecComplexity::kComplexityNormal;
+  }
+}
+
+int FromVideoCodecComplexity(webrtc::VideoCodecComplexity complexity) {
+  switch (complexity) {
+    case webrtc::VideoCodecComplexity::kComplexityLow:
+      return 0;
+    case webrtc::VideoCodecComplexity::kComplexityHigh:
+      return 2;
+    case webrtc::VideoCodecComplexity::kComplexityHigher:
+      return 3;
+    case webrtc::VideoCodecComplexity::kComplexityMax:
+      return 4;
+    default:
+      return 1;
+  }
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,34 @@
+#ifndef INTERNAL_VIDEO_ENCODER_TUNING_HXX
+#define INTERNAL_VIDEO_ENCODER_TUNING_HXX
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_codec.h"
+#include "pc/session_description.h"
+#include "rtc_rtp_sender.h"
+
+namespace libwebrtc {
+
+// Encoder CPU limits are not part of SDP either. Like the Opus complexity
+// (see opus_tuning.h) they reach the encoder factory as private format
+// parameters of the send codecs, set by ApplyVideoEncoderCpuSettings() and
+// taken off again by TakeVideoEncoderCpuSettings().
+extern const char kVideoComplexityParameter[];
+extern const char kVideoMaxThreadsParameter[];
+
+// Adds the limits of |settings| that are set to every media codec of the
+// video section |video| of a remote description.
+void ApplyVideoEncoderCpuSettings(const RTCVideoEncoderCpuSettings& settings,
+                                  cricket::MediaContentDescription* video);
+
+// Removes the private parameters from |format| and returns the limits they
+// carried, -1 for those that were absent.
+RTCVideoEncoderCpuSettings TakeVideoEncoderCpuSettings(
+    webrtc::SdpVideoFormat* format);
+
+// RTCVideoEncoderCpuSettings::complexity (0 to 4) and webrtc's scale.
+webrtc::VideoCodecComplexity ToVideoCodecComplexity(int complexity);
+int FromVideoCodecComplexity(webrtc::VideoCodecComplexity complexity);
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_VIDEO_ENCODER_TUNING_HXX
@@ -0,0 +1,249 @@
+#include "src/internal/virtual_audio_device_module.h"
+
+#include <cstring>
+
+#include "rtc_audio_frame_impl.h"
+#include "rtc_base/logging.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// The recorded signal, when enabled, is 48 kHz mono silence.
+const int kRecordingSampleRateHz = 48000;
+const size_t kRecordingChannels = 1;
+
+void CopyDeviceName(const char* device_name,
+                    char name[webrtc::kAdmMaxDeviceNameSize],
+                    char guid[webrtc::kAdmMaxGuidSize]) {
+  strncpy(name, device_name, webrtc::kAdmMaxDeviceNameSize - 1);
+  name[webrtc::kAdmMaxDeviceNameSize - 1] = '\0';
+  if (guid) {
+    strncpy(guid, device_name, webrtc::kAdmMaxGuidSize - 1);
+    guid[webrtc::kAdmMaxGuidSize - 1] = '\0';
+  }
+}
+
+}  // namespace
+
+VirtualAudioDeviceModule::VirtualAudioDeviceModule(
+    webrtc::TaskQueueFactory* task_queue_factory,
+    RTCAudioTrackSink* playout_sink, int playout_sample_rate_hz,
+    size_t playout_channels, bool record_silence)
+    : playout_sink_(playout_sink),
+      playout_sample_rate_hz_(playout_sample_rate_hz),
+      playout_channels_(playout_channels),
+      record_silence_(record_silence),
+      task_queue_(task_queue_factory->CreateTaskQueue(
+          "virtual_audio_device", webrtc::TaskQueueFactory::Priority::HIGH)),
+      playout_buffer_(playout_sample_rate_hz / 100 * playout_channels),
+      recording_buffer_(kRecordingSampleRateHz / 100 * kRecordingChannels) {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+VirtualAudioDeviceModule::~VirtualAudioDeviceModule() {
+  // Waits for a running tick; later ticks are dropped with the queue.
+  task_queue_ = nullptr;
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+int32_t VirtualAudioDeviceModule::ActiveAudioLayer(
+    AudioLayer* audio_layer) const {
+  *audio_layer = kDummyAudio;
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::RegisterAudioCallback(
+    webrtc::AudioTransport* callback) {
+  webrtc::MutexLock lock(&mutex_);
+  audio_transport_ = callback;
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::Init() {
+  webrtc::MutexLock lock(&mutex_);
+  initialized_ = true;
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::Terminate() {
+  webrtc::MutexLock lock(&mutex_);
+  playing_ = false;
+  recording_ = false;
+  playout_initialized_ = false;
+  recording_initialized_ = false;
+  initialized_ = false;
+  UpdateTimer();
+  return 0;
+}
+
+bool VirtualAudioDeviceModule::Initialized() const {
+  webrtc::MutexLock lock(&mutex_);
+  return initialized_;
+}
+
+int32_t VirtualAudioDeviceModule::PlayoutDeviceName(
+    uint16_t index, char name[webrtc::kAdmMaxDeviceNameSize],
+    char guid[webrtc::kAdmMaxGuidSize]) {
+  if (index != 0) {
+    return -1;
+  }
+  CopyDeviceName("Virtual Speaker", name, guid);
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::RecordingDeviceName(
+    uint16_t index, char name[webrtc::kAdmMaxDeviceNameSize],
+    char guid[webrtc::kAdmMaxGuidSize]) {
+  if (index != 0 || !record_silence_) {
+    return -1;
+  }
+  CopyDeviceName("Virtual Microphone", name, guid);
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::PlayoutIsAvailable(bool* available) {
+  *available = true;
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::InitPlayout() {
+  webrtc::MutexLock lock(&mutex_);
+  playout_initialized_ = true;
+  return 0;
+}
+
+bool VirtualAudioDeviceModule::PlayoutIsInitialized() const {
+  webrtc::MutexLock lock(&mutex_);
+  return playout_initialized_;
+}
+
+int32_t VirtualAudioDeviceModule::StartPlayout() {
+  webrtc::MutexLock lock(&mutex_);
+  if (!playout_initialized_) {
+    return -1;
+  }
+  playing_ = true;
+  UpdateTimer();
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::StopPlayout() {
+  webrtc::MutexLock lock(&mutex_);
+  playing_ = false;
+  UpdateTimer();
+  return 0;
+}
+
+bool VirtualAudioDeviceModule::Playing() const {
+  webrtc::MutexLock lock(&mutex_);
+  return playing_;
+}
+
+int32_t VirtualAudioDeviceModule::RecordingIsAvailable(bool* available) {
+  *available = record_silence_;
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::InitRecording() {
+  if (!record_silence_) {
+    return -1;
+  }
+  webrtc::MutexLock lock(&mutex_);
+  recording_initialized_ = true;
+  return 0;
+}
+
+bool VirtualAudioDeviceModule::RecordingIsInitialized() const {
+  webrtc::MutexLock lock(&mutex_);
+  return recording_initialized_;
+}
+
+int32_t VirtualAudioDeviceModule::StartRecording() {
+  webrtc::MutexLock lock(&mutex_);
+  if (!recording_initialized_) {
+    return -1;
+  }
+  recording_ = true;
+  UpdateTimer();
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::StopRecording() {
+  webrtc::MutexLock lock(&mutex_);
+  recording_ = false;
+  UpdateTimer();
+  return 0;
+}
+
+bool VirtualAudioDeviceModule::Recording() const {
+  webrtc::MutexLock lock(&mutex_);
+  return recording_;
+}
+
+int32_t VirtualAudioDeviceModule::StereoPlayoutIsAvailable(
+    bool* available) const {
+  *available = playout_channels_ == 2;
+  return 0;
+}
+
+int32_t VirtualAudioDeviceModule::StereoPlayout(bool* enabled) const {
+  *enabled = playout_channels_ == 2;
+  return 0;
+}
+
+void VirtualAudioDeviceModule::UpdateTimer() {
+  const bool needed = playing_ || recording_;
+  if (needed == timer_running_) {
+    return;
+  }
+  timer_running_ = needed;
+  task_queue_->PostTask([this, needed] {
+    if (!needed) {
+      timer_.Stop();
+      return;
+    }
+    timer_ = webrtc::RepeatingTaskHandle::Start(
+        task_queue_.get(),
+        [this] {
+          Process();
+          return webrtc::TimeDelta::Millis(10);
+        },
+        webrtc::TaskQueueBase::DelayPrecision::kHigh);
+  });
+}
+
+void VirtualAudioDeviceModule::Process() {
+  webrtc::MutexLock lock(&mutex_);
+  if (!audio_transport_) {
+    return;
+  }
+
+  if (playing_) {
+    const size_t samples_per_channel = playout_sample_rate_hz_ / 100;
+    size_t samples_out = 0;
+    int64_t elapsed_time_ms = 0;
+    int64_t ntp_time_ms = 0;
+    audio_transport_->NeedMorePlayData(
+        samples_per_channel, sizeof(int16_t) * playout_channels_,
+        playout_channels_, playout_sample_rate_hz_, playout_buffer_.data(),
+        samples_out, &elapsed_time_ms, &ntp_time_ms);
+    if (playout_sink_ && samples_out > 0) {
+      scoped_refptr<RTCAudioFrameImpl> frame = RTCAudioFrameImpl::Acquire();
+      if (frame->UpdateFrame(0, playout_buffer_.data(), samples_out,
+                             playout_sample_rate_hz_, playout_channels_)) {
+        playout_sink_->OnData(frame);
+      }
+    }
+  }
+
+  if (recording_) {
+    uint32_t new_mic_level = 0;
+    audio_transport_->RecordedDataIsAvailable(
+        recording_buffer_.data(), kRecordingSampleRateHz / 100,
+        sizeof(int16_t) * kRecordingChannels, kRecordingChannels,
+        kRecordingSampleRateHz, 0, 0, 0, false, new_mic_level);
+  }
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,93 @@
+#ifndef INTERNAL_VIRTUAL_AUDIO_DEVICE_MODULE_HXX
+#define INTERNAL_VIRTUAL_AUDIO_DEVICE_MODULE_HXX
+
+#include <memory>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "modules/audio_device/include/audio_device.h"
+#include "modules/audio_device/include/audio_device_default.h"
+#include "rtc_audio_track.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/task_utils/repeating_task.h"
+
+namespace libwebrtc {
+
+// An audio device without hardware. A 10 ms timer on its own task queue pulls
+// the mixed playout (handed to |playout_sink| or dropped) and, if enabled,
+// feeds silence as the recorded signal. With recording disabled, only custom
+// audio sources feed the send streams.
+class VirtualAudioDeviceModule
+    : public webrtc::webrtc_impl::AudioDeviceModuleDefault<
+          webrtc::AudioDeviceModule> {
+ public:
+  VirtualAudioDeviceModule(webrtc::TaskQueueFactory* task_queue_factory,
+                           RTCAudioTrackSink* playout_sink,
+                           int playout_sample_rate_hz, size_t playout_channels,
+                           bool record_silence);
+  ~VirtualAudioDeviceModule() override;
+
+  int32_t ActiveAudioLayer(AudioLayer* audio_layer) const override;
+  int32_t RegisterAudioCallback(webrtc::AudioTransport* callback) override;
+
+  int32_t Init() override;
+  int32_t Terminate() override;
+  bool Initialized() const override;
+
+  int16_t PlayoutDevices() override { return 1; }
+  int16_t RecordingDevices() override { return record_silence_ ? 1 : 0; }
+  int32_t PlayoutDeviceName(uint16_t index,
+                            char name[webrtc::kAdmMaxDeviceNameSize],
+                            char guid[webrtc::kAdmMaxGuidSize]) override;
+  int32_t RecordingDeviceName(uint16_t index,
+                              char name[webrtc::kAdmMaxDeviceNameSize],
+                              char guid[webrtc::kAdmMaxGuidSize]) override;
+
+  int32_t PlayoutIsAvailable(bool* available) override;
+  int32_t InitPlayout() override;
+  bool PlayoutIsInitialized() const override;
+  int32_t StartPlayout() override;
+  int32_t StopPlayout() override;
+  bool Playing() const override;
+
+  int32_t RecordingIsAvailable(bool* available) override;
+  int32_t InitRecording() override;
+  bool RecordingIsInitialized() const override;
+  int32_t StartRecording() override;
+  int32_t StopRecording() override;
+  bool Recording() const override;
+
+  int32_t StereoPlayoutIsAvailable(bool* available) const override;
+  int32_t StereoPlayout(bool* enabled) const override;
+
+ private:
+  // Runs every 10 ms on |task_queue_|.
+  void Process();
+
+  void UpdateTimer() RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  RTCAudioTrackSink* const playout_sink_;
+  const int playout_sample_rate_hz_;
+  const size_t playout_channels_;
+  const bool record_silence_;
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter> task_queue_;
+
+  mutable webrtc::Mutex mutex_;
+  webrtc::AudioTransport* audio_transport_ RTC_GUARDED_BY(mutex_) = nullptr;
+  bool initialized_ RTC_GUARDED_BY(mutex_) = false;
+  bool playout_initialized_ RTC_GUARDED_BY(mutex_) = false;
+  bool recording_initialized_ RTC_GUARDED_BY(mutex_) = false;
+  bool playing_ RTC_GUARDED_BY(mutex_) = false;
+  bool recording_ RTC_GUARDED_BY(mutex_) = false;
+  bool timer_running_ RTC_GUARDED_BY(mutex_) = false;
+
+  // Only accessed on |task_queue_|.
+  webrtc::RepeatingTaskHandle timer_;
+  std::vector<int16_t> playout_buffer_;
+  std::vector<int16_t> recording_buffer_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_VIRTUAL_AUDIO_DEVICE_MODULE_HXX
@@ -0,0 +1,176 @@
+#include "src/internal/wav_file_audio_source.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "rtc_base/logging.h"
+
+namespace libwebrtc {
+
+namespace {
+
+const uint16_t kWavFormatPcm = 1;
+const uint16_t kWavFormatExtensible = 0xFFFE;
+
+uint16_t ReadLE16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadLE32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+struct WavInfo {
+  int sample_rate_hz = 0;
+  size_t num_channels = 0;
+  size_t data_offset = 0;
+  size_t data_size = 0;
+};
+
+// Walks the RIFF chunks for "fmt " and "data".
+bool ParseWav(const uint8_t* data, size_t size, WavInfo* info) {
+  if (size < 12 || memcmp(data, "RIFF", 4) != 0 ||
+      memcmp(data + 8, "WAVE", 4) != 0) {
+    return false;
+  }
+  bool have_format = false;
+  size_t offset = 12;
+  while (offset + 8 <= size) {
+    const uint8_t* chunk = data + offset;
+    const size_t chunk_size = ReadLE32(chunk + 4);
+    const size_t body = offset + 8;
+    if (memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunk_size < 16 || body + 16 > size) {
+        return false;
+      }
+      const uint16_t format = ReadLE16(data + body);
+      const uint16_t bits_per_sample = ReadLE16(data + body + 14);
+      if ((format != kWavFormatPcm && format != kWavFormatExtensible) ||
+          bits_per_sample != 16) {
+        return false;
+      }
+      info->num_channels = ReadLE16(data + body + 2);
+      info->sample_rate_hz = static_cast<int>(ReadLE32(data + body + 4));
+      have_format = true;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (!have_format) {
+        return false;
+      }
+      info->data_offset = body;
+      // Tolerate files whose writer never patched the size.
+      info->data_size = std::min(chunk_size, size - body);
+      return true;
+    }
+    // Chunks are padded to an even size.
+    offset = body + chunk_size + (chunk_size & 1);
+  }
+  return false;
+}
+
+}  // namespace
+
+rtc::scoped_refptr<WavFileAudioSource> WavFileAudioSource::Create(
+    webrtc::TaskQueueFactory* task_queue_factory, const std::string& path,
+    bool loop) {
+  std::unique_ptr<MappedFile> file = MappedFile::Open(path);
+  if (!file) {
+    return nullptr;
+  }
+  WavInfo info;
+  if (!ParseWav(file->data(), file->size(), &info) ||
+      info.num_channels == 0 || info.num_channels > 8 ||
+      info.sample_rate_hz < 8000 || info.sample_rate_hz > 48000 ||
+      info.sample_rate_hz % 100 != 0) {
+    RTC_LOG(LS_ERROR) << path << " is not a supported 16-bit PCM WAV file.";
+    return nullptr;
+  }
+  // Samples are read in place, which needs 16-bit alignment.
+  if (info.data_offset % sizeof(int16_t) != 0) {
+    RTC_LOG(LS_ERROR) << path << " has an unaligned data chunk.";
+    return nullptr;
+  }
+  const size_t num_samples = info.data_size / sizeof(int16_t);
+  if (num_samples < info.num_channels) {
+    RTC_LOG(LS_ERROR) << path << " has no audio.";
+    return nullptr;
+  }
+  const int16_t* samples =
+      reinterpret_cast<const int16_t*>(file->data() + info.data_offset);
+  return rtc::make_ref_counted<WavFileAudioSource>(
+      task_queue_factory, std::move(file), samples, num_samples,
+      info.sample_rate_hz, info.num_channels, loop);
+}
+
+WavFileAudioSource::WavFileAudioSource(
+    webrtc::TaskQueueFactory* task_queue_factory,
+    std::unique_ptr<MappedFile> file, const int16_t* samples,
+    size_t num_samples, int sample_rate_hz, size_t num_channels, bool loop)
+    : file_(std::move(file)),
+      samples_(samples),
+      num_frames_(num_samples / num_channels),
+      sample_rate_hz_(sample_rate_hz),
+      num_channels_(num_channels),
+      loop_(loop),
+      wrap_buffer_(sample_rate_hz / 100 * num_channels),
+      task_queue_(task_queue_factory->CreateTaskQueue(
+          "wav_file_audio_source", webrtc::TaskQueueFactory::Priority::HIGH)) {
+  task_queue_->PostTask([this] {
+    timer_ = webrtc::RepeatingTaskHandle::Start(
+        task_queue_.get(),
+        [this] {
+          if (!PushChunk()) {
+            timer_.Stop();
+          }
+          return webrtc::TimeDelta::Millis(10);
+        },
+        webrtc::TaskQueueBase::DelayPrecision::kHigh);
+  });
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor " << sample_rate_hz << " Hz, "
+                   << num_channels << " ch, " << num_frames_ << " frames";
+}
+
+WavFileAudioSource::~WavFileAudioSource() {
+  // Waits for a running push; later ticks are dropped with the queue.
+  task_queue_ = nullptr;
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool WavFileAudioSource::PushChunk() {
+  const size_t chunk_frames = sample_rate_hz_ / 100;
+  if (position_ + chunk_frames <= num_frames_) {
+    PushData(samples_ + position_ * num_channels_, chunk_frames,
+             sample_rate_hz_, num_channels_);
+    position_ += chunk_frames;
+    if (position_ == num_frames_ && loop_) {
+      position_ = 0;
+    }
+    return position_ < num_frames_;
+  }
+
+  // The chunk runs past the end: continue from the start when looping,
+  // otherwise pad the last chunk with silence.
+  size_t filled = 0;
+  while (filled < chunk_frames) {
+    if (position_ == num_frames_) {
+      if (!loop_) {
+        std::fill(wrap_buffer_.begin() + filled * num_channels_,
+                  wrap_buffer_.end(), 0);
+        break;
+      }
+      position_ = 0;
+    }
+    const size_t take =
+        std::min(chunk_frames - filled, num_frames_ - position_);
+    std::copy(samples_ + position_ * num_channels_,
+              samples_ + (position_ + take) * num_channels_,
+              wrap_buffer_.begin() + filled * num_channels_);
+    filled += take;
+    position_ += take;
+  }
+  PushData(wrap_buffer_.data(), chunk_frames, sample_rate_hz_, num_channels_);
+  return loop_ || position_ < num_frames_;
+}
+
+}  // namespace libwebrtc
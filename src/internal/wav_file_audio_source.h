@@ -0,0 +1,55 @@
+#ifndef INTERNAL_WAV_FILE_AUDIO_SOURCE_HXX
+#define INTERNAL_WAV_FILE_AUDIO_SOURCE_HXX
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "src/internal/custom_audio_source.h"
+#include "src/internal/mapped_file.h"
+
+namespace libwebrtc {
+
+// A custom audio source that plays a 16-bit PCM WAV file in real time. The
+// file is memory mapped and pushed in 10 ms chunks from a timer on its own
+// task queue, straight from the mapping unless a chunk wraps around the end.
+class WavFileAudioSource : public CustomAudioSource {
+ public:
+  // Returns null if |path| is not a 16-bit PCM WAV file whose sample rate is
+  // a multiple of 100 Hz.
+  static rtc::scoped_refptr<WavFileAudioSource> Create(
+      webrtc::TaskQueueFactory* task_queue_factory, const std::string& path,
+      bool loop);
+
+ protected:
+  WavFileAudioSource(webrtc::TaskQueueFactory* task_queue_factory,
+                     std::unique_ptr<MappedFile> file, const int16_t* samples,
+                     size_t num_samples, int sample_rate_hz,
+                     size_t num_channels, bool loop);
+  ~WavFileAudioSource() override;
+
+ private:
+  // Pushes the next 10 ms; runs on |task_queue_|.
+  bool PushChunk();
+
+  const std::unique_ptr<MappedFile> file_;
+  // Interleaved samples of the data chunk, inside |file_|.
+  const int16_t* const samples_;
+  const size_t num_frames_;
+  const int sample_rate_hz_;
+  const size_t num_channels_;
+  const bool loop_;
+
+  // Only accessed on |task_queue_|.
+  size_t position_ = 0;
+  std::vector<int16_t> wrap_buffer_;
+  webrtc::RepeatingTaskHandle timer_;
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter> task_queue_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // INTERNAL_WAV_FILE_AUDIO_SOURCE_HXX
@@ -38,4 +38,15 @@ LibWebRTC::CreateRTCPeerConnectionFactory() {
   return rtc_peerconnection_factory;
 }
 
+// Creates and returns an instance of RTCPeerConnectionFactory using |options|.
+scoped_refptr<RTCPeerConnectionFactory>
+LibWebRTC::CreateRTCPeerConnectionFactory(
+    const RTCPeerConnectionFactoryOptions& options) {
+  scoped_refptr<RTCPeerConnectionFactory> rtc_peerconnection_factory =
+      scoped_refptr<RTCPeerConnectionFactory>(
+          new RefCountedObject<RTCPeerConnectionFactoryImpl>(options));
+  rtc_peerconnection_factory->Initialize();
+  return rtc_peerconnection_factory;
+}
+
 }  // namespace libwebrtc
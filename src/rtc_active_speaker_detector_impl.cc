@@ -0,0 +1,237 @@
+#include "rtc_active_speaker_detector_impl.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/refcountedobject.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_rtp_receiver_impl.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Smoothing time constants: speech start is picked up quickly, pauses
+// between words do not drop a speaker.
+const float kAttackMs = 50.0f;
+const float kReleaseMs = 600.0f;
+
+// A receiver whose level has not changed for this long counts as silent.
+// The receiver keeps reporting the last packet for 10 s after a stream
+// stops.
+const int64_t kStaleMs = 500;
+
+// Loudness (127 - RFC 6464 level) above which a receiver is speaking,
+// i.e. louder than -50 dBov.
+const float kSpeakingLoudness = 77.0f;
+
+// Bonus of receivers in the current ranking, in dB, so similar levels do
+// not flip the ranking on every poll.
+const float kSwitchMargin = 3.0f;
+
+float SmoothingFactor(float time_constant_ms, int interval_ms) {
+  return 1.0f - std::exp(-interval_ms / time_constant_ms);
+}
+
+}  // namespace
+
+RTCActiveSpeakerDetectorImpl::RTCActiveSpeakerDetectorImpl(
+    webrtc::TaskQueueFactory* task_queue_factory,
+    rtc::scoped_refptr<EventDispatcher> dispatcher,
+    RTCActiveSpeakerObserver* observer, size_t max_speakers, int interval_ms)
+    : dispatcher_(dispatcher),
+      observer_(observer),
+      max_speakers_(max_speakers),
+      interval_ms_(std::max(interval_ms, 10)),
+      ranking_(std::make_shared<Ranking>()),
+      task_queue_(task_queue_factory->CreateTaskQueue(
+          "active_speaker_detector",
+          webrtc::TaskQueueFactory::Priority::NORMAL)) {
+  task_queue_->PostTask([this] {
+    timer_ = webrtc::RepeatingTaskHandle::Start(task_queue_.get(), [this] {
+      Process();
+      return webrtc::TimeDelta::Millis(interval_ms_);
+    });
+  });
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+RTCActiveSpeakerDetectorImpl::~RTCActiveSpeakerDetectorImpl() {
+  // Waits for a running poll; later ones are dropped with the queue.
+  task_queue_ = nullptr;
+  {
+    webrtc::MutexLock lock(&ranking_->mutex);
+    ranking_->closed = true;
+  }
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool RTCActiveSpeakerDetectorImpl::AddReceiver(
+    scoped_refptr<RTCRtpReceiver> receiver) {
+  RTCRtpReceiverImpl* impl = static_cast<RTCRtpReceiverImpl*>(receiver.get());
+  rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtc_receiver =
+      impl->rtp_receiver();
+  if (rtc_receiver->media_type() != cricket::MEDIA_TYPE_AUDIO) {
+    return false;
+  }
+  webrtc::MutexLock lock(&mutex_);
+  for (const Entry& entry : entries_) {
+    if (entry.receiver == rtc_receiver) {
+      return false;
+    }
+  }
+  Entry entry;
+  entry.receiver = rtc_receiver;
+  entry.store = impl->store();
+  entries_.push_back(entry);
+  return true;
+}
+
+void RTCActiveSpeakerDetectorImpl::RemoveReceiver(
+    scoped_refptr<RTCRtpReceiver> receiver) {
+  webrtc::RtpReceiverInterface* rtc_receiver =
+      static_cast<RTCRtpReceiverImpl*>(receiver.get())->rtp_receiver().get();
+  webrtc::MutexLock lock(&mutex_);
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [rtc_receiver](const Entry& entry) {
+                                  return entry.receiver.get() == rtc_receiver;
+                                }),
+                 entries_.end());
+}
+
+vector<scoped_refptr<RTCRtpReceiver>>
+RTCActiveSpeakerDetectorImpl::active_speakers() const {
+  webrtc::MutexLock lock(&ranking_->mutex);
+  return Wrap(ranking_->speakers);
+}
+
+void RTCActiveSpeakerDetectorImpl::Process() {
+  struct Candidate {
+    Speaker speaker;
+    float score;
+  };
+
+  std::vector<rtc::scoped_refptr<webrtc::RtpReceiverInterface>> receivers;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    receivers.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+      receivers.push_back(entry.receiver);
+    }
+  }
+
+  // GetSources() hops to the worker thread, so query outside |mutex_|.
+  std::vector<int> levels(receivers.size());
+  std::vector<uint32_t> rtp_timestamps(receivers.size());
+  for (size_t i = 0; i < receivers.size(); ++i) {
+    levels[i] = RTCRtpReceiverImpl::AudioLevelOf(receivers[i].get(),
+                                                 &rtp_timestamps[i]);
+  }
+
+  const int64_t now_ms = rtc::TimeMillis();
+  const float attack = SmoothingFactor(kAttackMs, interval_ms_);
+  const float release = SmoothingFactor(kReleaseMs, interval_ms_);
+  std::vector<Candidate> candidates;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    for (Entry& entry : entries_) {
+      // Receivers added since the query are picked up by the next poll.
+      auto it = std::find(receivers.begin(), receivers.end(), entry.receiver);
+      if (it == receivers.end()) {
+        continue;
+      }
+      const size_t i = it - receivers.begin();
+      if (levels[i] >= 0 && (entry.last_update_ms < 0 ||
+                             rtp_timestamps[i] != entry.rtp_timestamp)) {
+        entry.rtp_timestamp = rtp_timestamps[i];
+        entry.last_update_ms = now_ms;
+      }
+      const bool fresh = levels[i] >= 0 && entry.last_update_ms >= 0 &&
+                         now_ms - entry.last_update_ms < kStaleMs;
+      const float target = fresh ? 127.0f - levels[i] : 0.0f;
+      entry.loudness +=
+          (target > entry.loudness ? attack : release) *
+          (target - entry.loudness);
+
+      const bool ranked =
+          std::find(last_ranking_.begin(), last_ranking_.end(),
+                    entry.receiver.get()) != last_ranking_.end();
+      const float score = entry.loudness + (ranked ? kSwitchMargin : 0.0f);
+      if (score >= kSpeakingLoudness) {
+        candidates.push_back({{entry.receiver, entry.store}, score});
+      }
+    }
+  }
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     return a.score > b.score;
+                   });
+  if (max_speakers_ > 0 && candidates.size() > max_speakers_) {
+    candidates.resize(max_speakers_);
+  }
+
+  std::vector<webrtc::RtpReceiverInterface*> new_ranking;
+  new_ranking.reserve(candidates.size());
+  for (const Candidate& candidate : candidates) {
+    new_ranking.push_back(candidate.speaker.receiver.get());
+  }
+  if (new_ranking == last_ranking_) {
+    return;
+  }
+  last_ranking_ = std::move(new_ranking);
+
+  uint64_t generation;
+  {
+    webrtc::MutexLock lock(&ranking_->mutex);
+    ranking_->speakers.clear();
+    for (const Candidate& candidate : candidates) {
+      ranking_->speakers.push_back(candidate.speaker);
+    }
+    generation = ++ranking_->generation;
+  }
+  if (observer_) {
+    std::shared_ptr<Ranking> ranking = ranking_;
+    RTCActiveSpeakerObserver* observer = observer_;
+    dispatcher_->Post([ranking, generation, observer] {
+      Deliver(ranking, generation, observer);
+    });
+  }
+}
+
+void RTCActiveSpeakerDetectorImpl::Deliver(
+    const std::shared_ptr<Ranking>& ranking, uint64_t generation,
+    RTCActiveSpeakerObserver* observer) {
+  vector<scoped_refptr<RTCRtpReceiver>> speakers;
+  {
+    webrtc::MutexLock lock(&ranking->mutex);
+    // A newer ranking is queued behind this one, or the detector is gone.
+    if (ranking->closed || ranking->generation != generation) {
+      return;
+    }
+    // Changes that were coalesced may have ended where the observer was.
+    std::vector<webrtc::RtpReceiverInterface*> current;
+    for (const Speaker& speaker : ranking->speakers) {
+      current.push_back(speaker.receiver.get());
+    }
+    if (current == ranking->delivered) {
+      return;
+    }
+    ranking->delivered = std::move(current);
+    speakers = Wrap(ranking->speakers);
+  }
+  observer->OnActiveSpeakersChanged(speakers);
+}
+
+vector<scoped_refptr<RTCRtpReceiver>> RTCActiveSpeakerDetectorImpl::Wrap(
+    const std::vector<Speaker>& speakers) {
+  std::vector<scoped_refptr<RTCRtpReceiver>> wrapped;
+  for (const Speaker& speaker : speakers) {
+    wrapped.push_back(new RefCountedObject<RTCRtpReceiverImpl>(
+        speaker.receiver, speaker.store));
+  }
+  return wrapped;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,90 @@
+#ifndef LIB_WEBRTC_ACTIVE_SPEAKER_DETECTOR_IMPL_HXX
+#define LIB_WEBRTC_ACTIVE_SPEAKER_DETECTOR_IMPL_HXX
+
+#include <memory>
+#include <vector>
+
+#include "api/rtp_receiver_interface.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "rtc_active_speaker_detector.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "src/internal/event_dispatcher.h"
+#include "src/internal/rtp_state_store.h"
+
+namespace libwebrtc {
+
+class RTCActiveSpeakerDetectorImpl : public RTCActiveSpeakerDetector {
+ public:
+  RTCActiveSpeakerDetectorImpl(webrtc::TaskQueueFactory* task_queue_factory,
+                               rtc::scoped_refptr<EventDispatcher> dispatcher,
+                               RTCActiveSpeakerObserver* observer,
+                               size_t max_speakers, int interval_ms);
+
+  bool AddReceiver(scoped_refptr<RTCRtpReceiver> receiver) override;
+
+  void RemoveReceiver(scoped_refptr<RTCRtpReceiver> receiver) override;
+
+  vector<scoped_refptr<RTCRtpReceiver>> active_speakers() const override;
+
+ protected:
+  ~RTCActiveSpeakerDetectorImpl() override;
+
+ private:
+  // A receiver and the state store of its peer connection, which the
+  // wrappers handed to the application need for their track's audio level
+  // events and for key frame requests.
+  struct Speaker {
+    rtc::scoped_refptr<webrtc::RtpReceiverInterface> receiver;
+    rtc::scoped_refptr<RtpStateStore> store;
+  };
+
+  struct Entry {
+    rtc::scoped_refptr<webrtc::RtpReceiverInterface> receiver;
+    rtc::scoped_refptr<RtpStateStore> store;
+    // Loudness, 127 minus the RFC 6464 level, smoothed.
+    float loudness = 0.0f;
+    uint32_t rtp_timestamp = 0;
+    int64_t last_update_ms = -1;
+  };
+
+  // The ranking, shared with queued events so they can run after the
+  // detector is gone and find out that they are stale.
+  struct Ranking {
+    webrtc::Mutex mutex;
+    std::vector<Speaker> speakers RTC_GUARDED_BY(mutex);
+    uint64_t generation RTC_GUARDED_BY(mutex) = 0;
+    // Identities of the ranking the observer last received.
+    std::vector<webrtc::RtpReceiverInterface*> delivered RTC_GUARDED_BY(mutex);
+    bool closed RTC_GUARDED_BY(mutex) = false;
+  };
+
+  // Runs every |interval_ms_| on |task_queue_|.
+  void Process();
+
+  // Delivers the ranking of |generation| unless a newer one was queued.
+  static void Deliver(const std::shared_ptr<Ranking>& ranking,
+                      uint64_t generation, RTCActiveSpeakerObserver* observer);
+
+  static vector<scoped_refptr<RTCRtpReceiver>> Wrap(
+      const std::vector<Speaker>& speakers);
+
+  const rtc::scoped_refptr<EventDispatcher> dispatcher_;
+  RTCActiveSpeakerObserver* const observer_;
+  const size_t max_speakers_;
+  const int interval_ms_;
+  const std::shared_ptr<Ranking> ranking_;
+
+  webrtc::Mutex mutex_;
+  std::vector<Entry> entries_ RTC_GUARDED_BY(mutex_);
+
+  // Only accessed on |task_queue_|.
+  std::vector<webrtc::RtpReceiverInterface*> last_ranking_;
+  webrtc::RepeatingTaskHandle timer_;
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter> task_queue_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_ACTIVE_SPEAKER_DETECTOR_IMPL_HXX
@@ -0,0 +1,104 @@
+#include "rtc_audio_frame_impl.h"
+
+#include <vector>
+
+#include "audio/utility/audio_frame_operations.h"
+#include "rtc_base/synchronization/mutex.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Enough for a few tracks pushing with some frames in flight. Each entry
+// holds a full webrtc::AudioFrame buffer.
+const size_t kMaxPooledFrames = 32;
+
+webrtc::Mutex& PoolMutex() {
+  static webrtc::Mutex* mutex = new webrtc::Mutex();
+  return *mutex;
+}
+
+std::vector<RTCAudioFrameImpl*>& Pool() {
+  static auto* pool = new std::vector<RTCAudioFrameImpl*>();
+  return *pool;
+}
+
+}  // namespace
+
+scoped_refptr<RTCAudioFrame> RTCAudioFrame::Create() {
+  return RTCAudioFrameImpl::Acquire();
+}
+
+scoped_refptr<RTCAudioFrame> RTCAudioFrame::Create(uint32_t timestamp,
+                                                   const int16_t* data,
+                                                   size_t samples_per_channel,
+                                                   int sample_rate_hz,
+                                                   size_t num_channels) {
+  scoped_refptr<RTCAudioFrameImpl> frame = RTCAudioFrameImpl::Acquire();
+  if (!frame->UpdateFrame(timestamp, data, samples_per_channel, sample_rate_hz,
+                          num_channels)) {
+    return nullptr;
+  }
+  return frame;
+}
+
+scoped_refptr<RTCAudioFrameImpl> RTCAudioFrameImpl::Acquire() {
+  {
+    webrtc::MutexLock lock(&PoolMutex());
+    if (!Pool().empty()) {
+      RTCAudioFrameImpl* frame = Pool().back();
+      Pool().pop_back();
+      return frame;
+    }
+  }
+  return new RTCAudioFrameImpl();
+}
+
+void RTCAudioFrameImpl::Recycle(RTCAudioFrameImpl* frame) {
+  frame->frame_.Reset();
+  {
+    webrtc::MutexLock lock(&PoolMutex());
+    if (Pool().size() < kMaxPooledFrames) {
+      Pool().push_back(frame);
+      return;
+    }
+  }
+  delete frame;
+}
+
+int RTCAudioFrameImpl::AddRef() const {
+  return AtomicOps::Increment(&ref_count_);
+}
+
+int RTCAudioFrameImpl::Release() const {
+  int count = AtomicOps::Decrement(&ref_count_);
+  if (!count) {
+    Recycle(const_cast<RTCAudioFrameImpl*>(this));
+  }
+  return count;
+}
+
+bool RTCAudioFrameImpl::UpdateFrame(uint32_t timestamp, const int16_t* data,
+                                    size_t samples_per_channel,
+                                    int sample_rate_hz, size_t num_channels) {
+  if (samples_per_channel * num_channels >
+      webrtc::AudioFrame::kMaxDataSizeSamples) {
+    return false;
+  }
+  frame_.UpdateFrame(timestamp, data, samples_per_channel, sample_rate_hz,
+                     webrtc::AudioFrame::kNormalSpeech,
+                     webrtc::AudioFrame::kVadUnknown, num_channels);
+  return true;
+}
+
+void RTCAudioFrameImpl::CopyFrom(scoped_refptr<RTCAudioFrame> src) {
+  frame_.CopyFrom(static_cast<RTCAudioFrameImpl*>(src.get())->rtc_frame());
+}
+
+void RTCAudioFrameImpl::Add(scoped_refptr<RTCAudioFrame> frame_to_add) {
+  webrtc::AudioFrameOperations::Add(
+      static_cast<RTCAudioFrameImpl*>(frame_to_add.get())->rtc_frame(),
+      &frame_);
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,63 @@
+#ifndef LIB_WEBRTC_AUDIO_FRAME_IMPL_HXX
+#define LIB_WEBRTC_AUDIO_FRAME_IMPL_HXX
+
+#include "api/audio/audio_frame.h"
+#include "rtc_audio_frame.h"
+
+namespace libwebrtc {
+
+// An RTCAudioFrame backed by a webrtc::AudioFrame. Instances are recycled
+// through a small free list when their last reference is released.
+class RTCAudioFrameImpl : public RTCAudioFrame {
+ public:
+  // Takes a frame from the pool, or allocates one if the pool is empty.
+  static scoped_refptr<RTCAudioFrameImpl> Acquire();
+
+  int AddRef() const override;
+
+  int Release() const override;
+
+  bool UpdateFrame(uint32_t timestamp, const int16_t* data,
+                   size_t samples_per_channel, int sample_rate_hz,
+                   size_t num_channels = 1) override;
+
+  void CopyFrom(scoped_refptr<RTCAudioFrame> src) override;
+
+  void Add(scoped_refptr<RTCAudioFrame> frame_to_add) override;
+
+  void Mute() override { frame_.Mute(); }
+
+  const int16_t* data() const override { return frame_.data(); }
+
+  int16_t* mutable_data() override { return frame_.mutable_data(); }
+
+  size_t samples_per_channel() const override {
+    return frame_.samples_per_channel();
+  }
+
+  int sample_rate_hz() const override { return frame_.sample_rate_hz(); }
+
+  size_t num_channels() const override { return frame_.num_channels(); }
+
+  uint32_t timestamp() const override { return frame_.timestamp(); }
+
+  const webrtc::AudioFrame& rtc_frame() const { return frame_; }
+
+  webrtc::AudioFrame* mutable_rtc_frame() { return &frame_; }
+
+ protected:
+  ~RTCAudioFrameImpl() override {}
+
+ private:
+  RTCAudioFrameImpl() {}
+
+  // Returns |frame| to the pool, or frees it when the pool is full.
+  static void Recycle(RTCAudioFrameImpl* frame);
+
+  mutable volatile int ref_count_ = 0;
+  webrtc::AudioFrame frame_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_AUDIO_FRAME_IMPL_HXX
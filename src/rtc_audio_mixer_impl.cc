@@ -0,0 +1,179 @@
+#include "rtc_audio_mixer_impl.h"
+
+#include <algorithm>
+
+#include "rtc_audio_frame_impl.h"
+#include "rtc_audio_track_impl.h"
+#include "rtc_base/logging.h"
+#include "src/internal/audio_mix.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Frames a track may run ahead of the mixer clock before its oldest frames
+// are dropped.
+const size_t kMaxQueuedFrames = 2;
+
+webrtc::AudioTrackInterface* RtcTrackOf(scoped_refptr<RTCAudioTrack> track) {
+  return static_cast<AudioTrackImpl*>(track.get())->rtc_track().get();
+}
+
+}  // namespace
+
+RTCAudioMixerImpl::Input::Input(scoped_refptr<RTCAudioTrack> track,
+                                float gain)
+    : gain_q14(MixGainToQ14(gain)),
+      track_(track),
+      rtc_track_(RtcTrackOf(track)) {}
+
+void RTCAudioMixerImpl::Input::OnData(scoped_refptr<RTCAudioFrame> frame) {
+  webrtc::MutexLock lock(&mutex_);
+  frames_.push_back(frame);
+  while (frames_.size() > kMaxQueuedFrames) {
+    frames_.pop_front();
+  }
+}
+
+scoped_refptr<RTCAudioFrame> RTCAudioMixerImpl::Input::Pop() {
+  webrtc::MutexLock lock(&mutex_);
+  if (frames_.empty()) {
+    return nullptr;
+  }
+  scoped_refptr<RTCAudioFrame> frame = frames_.front();
+  frames_.pop_front();
+  return frame;
+}
+
+RTCAudioMixerImpl::RTCAudioMixerImpl(
+    webrtc::TaskQueueFactory* task_queue_factory, RTCAudioTrackSink* output,
+    int sample_rate_hz, size_t num_channels, size_t max_mixed_sources)
+    : output_(output),
+      sample_rate_hz_(sample_rate_hz),
+      num_channels_(std::min<size_t>(std::max<size_t>(num_channels, 1), 2)),
+      max_mixed_sources_(max_mixed_sources),
+      task_queue_(task_queue_factory->CreateTaskQueue(
+          "audio_mixer", webrtc::TaskQueueFactory::Priority::HIGH)) {
+  task_queue_->PostTask([this] {
+    timer_ = webrtc::RepeatingTaskHandle::Start(
+        task_queue_.get(),
+        [this] {
+          Process();
+          return webrtc::TimeDelta::Millis(10);
+        },
+        webrtc::TaskQueueBase::DelayPrecision::kHigh);
+  });
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+RTCAudioMixerImpl::~RTCAudioMixerImpl() {
+  // Waits for a running mix; later ticks are dropped with the queue.
+  task_queue_ = nullptr;
+  webrtc::MutexLock lock(&mutex_);
+  for (auto& input : inputs_) {
+    input->track()->RemoveSink(input.get());
+  }
+  inputs_.clear();
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+RTCAudioMixerImpl::Input* RTCAudioMixerImpl::FindInput(
+    webrtc::AudioTrackInterface* rtc_track) {
+  for (auto& input : inputs_) {
+    if (input->rtc_track() == rtc_track) {
+      return input.get();
+    }
+  }
+  return nullptr;
+}
+
+bool RTCAudioMixerImpl::AddTrack(scoped_refptr<RTCAudioTrack> track,
+                                 float gain) {
+  webrtc::MutexLock lock(&mutex_);
+  if (FindInput(RtcTrackOf(track))) {
+    return false;
+  }
+  inputs_.push_back(std::unique_ptr<Input>(new Input(track, gain)));
+  track->AddSink(inputs_.back().get(), sample_rate_hz_, num_channels_);
+  return true;
+}
+
+void RTCAudioMixerImpl::RemoveTrack(scoped_refptr<RTCAudioTrack> track) {
+  webrtc::MutexLock lock(&mutex_);
+  webrtc::AudioTrackInterface* rtc_track = RtcTrackOf(track);
+  auto it = std::find_if(inputs_.begin(), inputs_.end(),
+                         [rtc_track](const std::unique_ptr<Input>& input) {
+                           return input->rtc_track() == rtc_track;
+                         });
+  if (it == inputs_.end()) {
+    return;
+  }
+  (*it)->track()->RemoveSink(it->get());
+  inputs_.erase(it);
+}
+
+void RTCAudioMixerImpl::SetGain(scoped_refptr<RTCAudioTrack> track,
+                                float gain) {
+  webrtc::MutexLock lock(&mutex_);
+  Input* input = FindInput(RtcTrackOf(track));
+  if (input) {
+    input->gain_q14 = MixGainToQ14(gain);
+  }
+}
+
+void RTCAudioMixerImpl::SetMaxMixedSources(size_t max_mixed_sources) {
+  max_mixed_sources_ = max_mixed_sources;
+}
+
+void RTCAudioMixerImpl::Process() {
+  struct Candidate {
+    scoped_refptr<RTCAudioFrame> frame;
+    int16_t gain_q14;
+    uint64_t energy;
+  };
+
+  const size_t samples_per_channel = sample_rate_hz_ / 100;
+  const size_t length = samples_per_channel * num_channels_;
+  std::vector<Candidate> candidates;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    candidates.reserve(inputs_.size());
+    for (auto& input : inputs_) {
+      scoped_refptr<RTCAudioFrame> frame = input->Pop();
+      const int16_t gain_q14 = input->gain_q14;
+      if (!frame || gain_q14 == 0 ||
+          frame->sample_rate_hz() != sample_rate_hz_ ||
+          frame->num_channels() != num_channels_ ||
+          frame->samples_per_channel() != samples_per_channel) {
+        continue;
+      }
+      candidates.push_back(
+          {frame, gain_q14, MixEnergy(frame->data(), length) * gain_q14});
+    }
+  }
+
+  const size_t max_mixed_sources = max_mixed_sources_;
+  if (max_mixed_sources > 0 && candidates.size() > max_mixed_sources) {
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + max_mixed_sources,
+                     candidates.end(),
+                     [](const Candidate& a, const Candidate& b) {
+                       return a.energy > b.energy;
+                     });
+    candidates.resize(max_mixed_sources);
+  }
+
+  scoped_refptr<RTCAudioFrameImpl> mixed = RTCAudioFrameImpl::Acquire();
+  mixed->UpdateFrame(timestamp_, nullptr, samples_per_channel,
+                     sample_rate_hz_, num_channels_);
+  timestamp_ += static_cast<uint32_t>(samples_per_channel);
+  if (!candidates.empty()) {
+    int16_t* dst = mixed->mutable_data();
+    for (const Candidate& candidate : candidates) {
+      MixWithGain(candidate.frame->data(), candidate.gain_q14, length, dst);
+    }
+  }
+  output_->OnData(mixed);
+}
+
+}  // namespace libwebrtc
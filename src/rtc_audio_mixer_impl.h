@@ -0,0 +1,85 @@
+#ifndef LIB_WEBRTC_AUDIO_MIXER_IMPL_HXX
+#define LIB_WEBRTC_AUDIO_MIXER_IMPL_HXX
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "api/media_stream_interface.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "rtc_audio_mixer.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/task_utils/repeating_task.h"
+
+namespace libwebrtc {
+
+class RTCAudioMixerImpl : public RTCAudioMixer {
+ public:
+  RTCAudioMixerImpl(webrtc::TaskQueueFactory* task_queue_factory,
+                    RTCAudioTrackSink* output, int sample_rate_hz,
+                    size_t num_channels, size_t max_mixed_sources);
+
+  bool AddTrack(scoped_refptr<RTCAudioTrack> track, float gain) override;
+
+  void RemoveTrack(scoped_refptr<RTCAudioTrack> track) override;
+
+  void SetGain(scoped_refptr<RTCAudioTrack> track, float gain) override;
+
+  void SetMaxMixedSources(size_t max_mixed_sources) override;
+
+  int sample_rate_hz() const override { return sample_rate_hz_; }
+
+  size_t num_channels() const override { return num_channels_; }
+
+ protected:
+  ~RTCAudioMixerImpl() override;
+
+ private:
+  // One mixed track. Frames arrive on the audio thread and are queued until
+  // the mixer clock takes them.
+  class Input : public RTCAudioTrackSink {
+   public:
+    Input(scoped_refptr<RTCAudioTrack> track, float gain);
+
+    void OnData(scoped_refptr<RTCAudioFrame> frame) override;
+
+    // Takes the next frame, or null if none has arrived.
+    scoped_refptr<RTCAudioFrame> Pop();
+
+    scoped_refptr<RTCAudioTrack> track() const { return track_; }
+    webrtc::AudioTrackInterface* rtc_track() const { return rtc_track_; }
+
+    std::atomic<int16_t> gain_q14;
+
+   private:
+    const scoped_refptr<RTCAudioTrack> track_;
+    webrtc::AudioTrackInterface* const rtc_track_;
+    webrtc::Mutex mutex_;
+    std::deque<scoped_refptr<RTCAudioFrame>> frames_ RTC_GUARDED_BY(mutex_);
+  };
+
+  // Runs every 10 ms on |task_queue_|.
+  void Process();
+
+  Input* FindInput(webrtc::AudioTrackInterface* rtc_track)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  RTCAudioTrackSink* const output_;
+  const int sample_rate_hz_;
+  const size_t num_channels_;
+  std::atomic<size_t> max_mixed_sources_;
+
+  webrtc::Mutex mutex_;
+  std::vector<std::unique_ptr<Input>> inputs_ RTC_GUARDED_BY(mutex_);
+
+  // Only accessed on |task_queue_|.
+  uint32_t timestamp_ = 0;
+  webrtc::RepeatingTaskHandle timer_;
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter> task_queue_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_AUDIO_MIXER_IMPL_HXX
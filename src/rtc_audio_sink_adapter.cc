@@ -0,0 +1,376 @@
+#include "rtc_audio_sink_adapter.h"
+
+#include <algorithm>
+#include <map>
+
+#include "audio/remix_resample.h"
+#include "rtc_audio_frame_impl.h"
+#include "rtc_base/logging.h"
+#include "src/internal/event_dispatcher.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Guards the registry. Adapters drop their reference count under it, so an
+// adapter found in the registry always has a live reference.
+webrtc::Mutex& RegistryMutex() {
+  static webrtc::Mutex* mutex = new webrtc::Mutex();
+  return *mutex;
+}
+
+std::map<webrtc::AudioTrackInterface*, AudioSinkAdapter*>& Registry() {
+  static auto* registry =
+      new std::map<webrtc::AudioTrackInterface*, AudioSinkAdapter*>();
+  return *registry;
+}
+
+}  // namespace
+
+scoped_refptr<AudioSinkAdapter> AudioSinkAdapter::ForTrack(
+    rtc::scoped_refptr<webrtc::AudioTrackInterface> track, bool create) {
+  webrtc::MutexLock lock(&RegistryMutex());
+  auto it = Registry().find(track.get());
+  if (it != Registry().end()) {
+    return it->second;
+  }
+  if (!create) {
+    return nullptr;
+  }
+  AudioSinkAdapter* adapter = new AudioSinkAdapter(track);
+  Registry()[track.get()] = adapter;
+  return adapter;
+}
+
+AudioSinkAdapter::AudioSinkAdapter(
+    rtc::scoped_refptr<webrtc::AudioTrackInterface> track)
+    : rtc_track_(track) {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor " << (void*)this;
+}
+
+AudioSinkAdapter::~AudioSinkAdapter() {
+  bool attached;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    attached = active() || detach_deferred_;
+  }
+  if (attached) {
+    rtc_track_->RemoveSink(this);
+  }
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+int AudioSinkAdapter::AddRef() const {
+  return AtomicOps::Increment(&ref_count_);
+}
+
+int AudioSinkAdapter::Release() const {
+  int count;
+  {
+    webrtc::MutexLock lock(&RegistryMutex());
+    count = AtomicOps::Decrement(&ref_count_);
+    if (!count) {
+      Registry().erase(rtc_track_.get());
+    }
+  }
+  if (!count) {
+    delete this;
+  }
+  return count;
+}
+
+bool AudioSinkAdapter::UpdateActivity(
+    bool was_active, scoped_refptr<AudioSinkAdapter>* released) {
+  const bool is_active = active();
+  if (detach_deferred_) {
+    // Still attached, so only a pending detach can be left to do.
+    if (is_active) {
+      detach_deferred_ = false;
+      return false;
+    }
+    was_active = true;
+  }
+  if (is_active == was_active) {
+    return false;
+  }
+  if (is_active) {
+    self_ = this;
+  } else if (InSinkCallback()) {
+    // Detaching here would wait on the lock the track's source holds while
+    // it calls us, and |self_| keeps us alive until OnData() returns.
+    detach_deferred_ = true;
+    return false;
+  } else {
+    detach_deferred_ = false;
+    *released = std::move(self_);
+    meter_.Reset();
+  }
+  return true;
+}
+
+bool AudioSinkAdapter::InSinkCallback() const {
+  return delivering_ &&
+         rtc::IsThreadRefEqual(delivering_thread_, rtc::CurrentThreadRef());
+}
+
+void AudioSinkAdapter::DetachIfInactive() {
+  scoped_refptr<AudioSinkAdapter> released;
+  bool detach;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    detach = UpdateActivity(active(), &released);
+  }
+  if (detach) {
+    rtc_track_->RemoveSink(this);
+  }
+}
+
+void AudioSinkAdapter::AddSink(
+    RTCAudioTrackSink* sink, int sample_rate_hz, size_t num_channels,
+    rtc::scoped_refptr<EventDispatcher> dispatcher) {
+  if (num_channels > 2) {
+    RTC_LOG(LS_WARNING) << "Only mono or stereo output is supported, "
+                           "delivering the track's channel layout.";
+    num_channels = 0;
+  }
+  bool attach;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    const bool was_active = active();
+    if (dispatcher) {
+      dispatcher_ = dispatcher;
+    }
+    sinks_.erase(std::remove_if(sinks_.begin(), sinks_.end(),
+                                [sink](const SinkEntry& entry) {
+                                  return entry.sink == sink;
+                                }),
+                 sinks_.end());
+    sinks_.push_back({sink, sample_rate_hz, num_channels});
+    auto it = std::find_if(
+        converters_.begin(), converters_.end(),
+        [sample_rate_hz, num_channels](const std::unique_ptr<Converter>& c) {
+          return c->sample_rate_hz == sample_rate_hz &&
+                 c->num_channels == num_channels;
+        });
+    if (it == converters_.end()) {
+      std::unique_ptr<Converter> converter(new Converter());
+      converter->sample_rate_hz = sample_rate_hz;
+      converter->num_channels = num_channels;
+      converters_.push_back(std::move(converter));
+    }
+    attach = UpdateActivity(was_active, nullptr);
+  }
+  if (attach) {
+    rtc_track_->AddSink(this);
+  }
+}
+
+void AudioSinkAdapter::RemoveSink(RTCAudioTrackSink* sink) {
+  scoped_refptr<AudioSinkAdapter> released;
+  bool detach;
+  bool in_callback;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (sinks_.empty()) {
+      return;
+    }
+    in_callback = InSinkCallback();
+    const bool was_active = active();
+    sinks_.erase(std::remove_if(sinks_.begin(), sinks_.end(),
+                                [sink](const SinkEntry& entry) {
+                                  return entry.sink == sink;
+                                }),
+                 sinks_.end());
+    // Drop converters nobody asks for any more.
+    converters_.erase(
+        std::remove_if(converters_.begin(), converters_.end(),
+                       [this](const std::unique_ptr<Converter>& c) {
+                         return std::none_of(
+                             sinks_.begin(), sinks_.end(),
+                             [&c](const SinkEntry& entry) {
+                               return entry.sample_rate_hz ==
+                                          c->sample_rate_hz &&
+                                      entry.num_channels == c->num_channels;
+                             });
+                       }),
+        converters_.end());
+    detach = UpdateActivity(was_active, &released);
+  }
+  if (!in_callback) {
+    // Waits for a call to |sink| that is already running. Inside a sink,
+    // OnData() checks each sink again before calling it.
+    webrtc::MutexLock wait(&delivery_mutex_);
+  }
+  if (detach) {
+    rtc_track_->RemoveSink(this);
+  }
+}
+
+void AudioSinkAdapter::EnableLevelMeter(bool enable) {
+  scoped_refptr<AudioSinkAdapter> released;
+  bool changed;
+  bool is_active;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    const bool was_active = active();
+    meter_enabled_ = enable;
+    if (!meter_enabled_ && !metering_for_observer_) {
+      meter_.Reset();
+    }
+    changed = UpdateActivity(was_active, &released);
+    is_active = active();
+  }
+  if (changed) {
+    if (is_active) {
+      rtc_track_->AddSink(this);
+    } else {
+      rtc_track_->RemoveSink(this);
+    }
+  }
+}
+
+void AudioSinkAdapter::SetLevelObserver(
+    RTCAudioLevelObserver* observer, float rms_threshold,
+    rtc::scoped_refptr<EventDispatcher> dispatcher) {
+  scoped_refptr<AudioSinkAdapter> released;
+  bool changed;
+  bool is_active;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    const bool was_active = active();
+    if (dispatcher) {
+      dispatcher_ = dispatcher;
+    }
+    level_observer_ = observer;
+    meter_.set_threshold(observer ? rms_threshold : 0.0f);
+    metering_for_observer_ = observer != nullptr;
+    if (!meter_enabled_ && !metering_for_observer_) {
+      meter_.Reset();
+    }
+    changed = UpdateActivity(was_active, &released);
+    is_active = active();
+  }
+  if (changed) {
+    if (is_active) {
+      rtc_track_->AddSink(this);
+    } else {
+      rtc_track_->RemoveSink(this);
+    }
+  }
+}
+
+void AudioSinkAdapter::PostLevelEvents(int events) {
+  const RTCAudioLevel level = meter_.level();
+  const bool above = meter_.above_threshold();
+  if (!dispatcher_) {
+    // Set through a track wrapper that did not come from a factory or a
+    // peer connection.
+    RTC_LOG(LS_WARNING) << "No dispatcher for audio level events";
+    return;
+  }
+  scoped_refptr<AudioSinkAdapter> self(this);
+  // The observer is looked up when the event runs, so clearing it stops
+  // events that are already queued.
+  dispatcher_->Post([self, events, level, above] {
+    RTCAudioLevelObserver* observer;
+    {
+      webrtc::MutexLock lock(&self->mutex_);
+      observer = self->level_observer_;
+    }
+    if (!observer) {
+      return;
+    }
+    if (events & AudioLevelMeter::kThresholdCrossed) {
+      observer->OnLevelThresholdCrossed(above, level);
+    }
+    if (events & AudioLevelMeter::kVoiceActivityChanged) {
+      observer->OnVoiceActivityChanged(level.voice_active);
+    }
+  });
+}
+
+void AudioSinkAdapter::OnData(const void* audio_data, int bits_per_sample,
+                              int sample_rate, size_t number_of_channels,
+                              size_t number_of_frames) {
+  if (bits_per_sample != 16) {
+    return;
+  }
+  const int16_t* data = static_cast<const int16_t*>(audio_data);
+  webrtc::MutexLock delivery_lock(&delivery_mutex_);
+  bool was_deferred;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    was_deferred = detach_deferred_;
+    Convert(data, sample_rate, number_of_channels, number_of_frames);
+    delivering_ = true;
+    delivering_thread_ = rtc::CurrentThreadRef();
+  }
+  for (const Delivery& delivery : deliveries_) {
+    {
+      // An earlier sink may have removed this one.
+      webrtc::MutexLock lock(&mutex_);
+      if (std::none_of(sinks_.begin(), sinks_.end(),
+                       [&delivery](const SinkEntry& entry) {
+                         return entry.sink == delivery.sink;
+                       })) {
+        continue;
+      }
+    }
+    delivery.sink->OnData(delivery.frame);
+  }
+  deliveries_.clear();
+  bool deferred_now;
+  rtc::scoped_refptr<EventDispatcher> dispatcher;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    delivering_ = false;
+    deferred_now = detach_deferred_ && !was_deferred;
+    dispatcher = dispatcher_;
+  }
+  // Without a dispatcher the next call from outside a sink detaches.
+  if (deferred_now && dispatcher) {
+    scoped_refptr<AudioSinkAdapter> self(this);
+    dispatcher->Post([self] { self->DetachIfInactive(); });
+  }
+}
+
+void AudioSinkAdapter::Convert(const int16_t* data, int sample_rate,
+                               size_t number_of_channels,
+                               size_t number_of_frames) {
+  if (meter_enabled_ || metering_for_observer_) {
+    const int events = meter_.Process(data, sample_rate, number_of_channels,
+                                      number_of_frames);
+    if (events != AudioLevelMeter::kNoEvents &&
+        level_observer_ != nullptr) {
+      PostLevelEvents(events);
+    }
+  }
+  for (auto& converter : converters_) {
+    const int rate = converter->sample_rate_hz > 0 ? converter->sample_rate_hz
+                                                   : sample_rate;
+    const size_t channels = converter->num_channels > 0
+                                ? converter->num_channels
+                                : number_of_channels;
+    scoped_refptr<RTCAudioFrameImpl> frame = RTCAudioFrameImpl::Acquire();
+    if (rate == sample_rate && channels == number_of_channels) {
+      if (!frame->UpdateFrame(0, data, number_of_frames, sample_rate,
+                              number_of_channels)) {
+        continue;
+      }
+    } else {
+      webrtc::AudioFrame* dst = frame->mutable_rtc_frame();
+      dst->sample_rate_hz_ = rate;
+      dst->num_channels_ = channels;
+      webrtc::voe::RemixAndResample(data, number_of_frames, number_of_channels,
+                                    sample_rate, &converter->resampler, dst);
+    }
+    for (const auto& entry : sinks_) {
+      if (entry.sample_rate_hz == converter->sample_rate_hz &&
+          entry.num_channels == converter->num_channels) {
+        deliveries_.push_back({entry.sink, frame});
+      }
+    }
+  }
+}
+
+}  // namespace libwebrtc
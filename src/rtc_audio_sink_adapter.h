@@ -0,0 +1,133 @@
+#ifndef LIB_WEBRTC_AUDIO_SINK_ADAPTER_HXX
+#define LIB_WEBRTC_AUDIO_SINK_ADAPTER_HXX
+
+#include <memory>
+#include <vector>
+
+#include "api/media_stream_interface.h"
+#include "common_audio/resampler/include/push_resampler.h"
+#include "rtc_audio_track.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "src/internal/audio_level_meter.h"
+#include "src/internal/event_dispatcher.h"
+
+namespace libwebrtc {
+
+// Fans the PCM of one webrtc audio track out to RTCAudioTrackSinks and the
+// level meter. There is at most one adapter per track, shared by all
+// RTCAudioTrack wrappers of it, so each requested format is converted once
+// per 10 ms frame. The adapter keeps itself alive while it has sinks or the
+// meter is on, so they outlive the wrapper that set them up.
+//
+// Sinks are called without |mutex_| held, so they may add or remove sinks
+// of any track. The track's source holds its own lock while it calls
+// OnData(), so when a sink removes the last one the adapter stays attached
+// and detaches later, from the dispatcher or the next call from outside.
+class AudioSinkAdapter : public webrtc::AudioTrackSinkInterface,
+                         public RefCountInterface {
+ public:
+  // Returns the adapter of |track|, creating it if |create| is set.
+  static scoped_refptr<AudioSinkAdapter> ForTrack(
+      rtc::scoped_refptr<webrtc::AudioTrackInterface> track, bool create);
+
+  int AddRef() const override;
+
+  int Release() const override;
+
+  // |dispatcher| runs a detach deferred from inside a sink; see above.
+  void AddSink(RTCAudioTrackSink* sink, int sample_rate_hz,
+               size_t num_channels,
+               rtc::scoped_refptr<EventDispatcher> dispatcher);
+
+  void RemoveSink(RTCAudioTrackSink* sink);
+
+  void EnableLevelMeter(bool enable);
+
+  // Level events are posted to |dispatcher|, or to the last one given to
+  // this or AddSink() if it is null.
+  void SetLevelObserver(RTCAudioLevelObserver* observer, float rms_threshold,
+                        rtc::scoped_refptr<EventDispatcher> dispatcher);
+
+  RTCAudioLevel level() const { return meter_.level(); }
+
+ protected:
+  // webrtc::AudioTrackSinkInterface
+  void OnData(const void* audio_data, int bits_per_sample, int sample_rate,
+              size_t number_of_channels, size_t number_of_frames) override;
+
+ private:
+  // A requested output format and its conversion state.
+  struct Converter {
+    int sample_rate_hz;
+    size_t num_channels;
+    webrtc::PushResampler<int16_t> resampler;
+  };
+
+  struct SinkEntry {
+    RTCAudioTrackSink* sink;
+    int sample_rate_hz;
+    size_t num_channels;
+  };
+
+  struct Delivery {
+    RTCAudioTrackSink* sink;
+    scoped_refptr<RTCAudioFrame> frame;
+  };
+
+  explicit AudioSinkAdapter(
+      rtc::scoped_refptr<webrtc::AudioTrackInterface> track);
+  ~AudioSinkAdapter() override;
+
+  bool active() const RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !sinks_.empty() || meter_enabled_ || metering_for_observer_;
+  }
+
+  // Called after a change under |mutex_|. Returns true if active() changed;
+  // the caller then attaches to or detaches from the track after unlocking.
+  // On deactivation the self reference moves to |released|, to be dropped
+  // once the caller is done. Inside a sink the detach is deferred instead,
+  // and a later call finishes it.
+  bool UpdateActivity(bool was_active,
+                      scoped_refptr<AudioSinkAdapter>* released)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // True on the thread that is calling the sinks, while it does.
+  bool InSinkCallback() const RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Finishes a deferred detach unless the adapter became active again.
+  void DetachIfInactive();
+
+  void PostLevelEvents(int events) RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Runs the meter and the format conversions of one frame and queues the
+  // sink calls in |deliveries_|.
+  void Convert(const int16_t* data, int sample_rate, size_t number_of_channels,
+               size_t number_of_frames)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(delivery_mutex_, mutex_);
+
+  rtc::scoped_refptr<webrtc::AudioTrackInterface> rtc_track_;
+  mutable volatile int ref_count_ = 0;
+  // Held by OnData() while it calls the sinks, so RemoveSink() can wait for
+  // a running call. Taken before |mutex_|.
+  webrtc::Mutex delivery_mutex_;
+  std::vector<Delivery> deliveries_ RTC_GUARDED_BY(delivery_mutex_);
+  webrtc::Mutex mutex_;
+  bool delivering_ RTC_GUARDED_BY(mutex_) = false;
+  rtc::PlatformThreadRef delivering_thread_ RTC_GUARDED_BY(mutex_);
+  // Inactive, but still attached to the track and holding |self_|.
+  bool detach_deferred_ RTC_GUARDED_BY(mutex_) = false;
+  std::vector<SinkEntry> sinks_ RTC_GUARDED_BY(mutex_);
+  std::vector<std::unique_ptr<Converter>> converters_ RTC_GUARDED_BY(mutex_);
+  // Held while active() or a detach is deferred.
+  scoped_refptr<AudioSinkAdapter> self_ RTC_GUARDED_BY(mutex_);
+  bool meter_enabled_ RTC_GUARDED_BY(mutex_) = false;
+  bool metering_for_observer_ RTC_GUARDED_BY(mutex_) = false;
+  rtc::scoped_refptr<EventDispatcher> dispatcher_ RTC_GUARDED_BY(mutex_);
+  RTCAudioLevelObserver* level_observer_ RTC_GUARDED_BY(mutex_) = nullptr;
+  AudioLevelMeter meter_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_AUDIO_SINK_ADAPTER_HXX
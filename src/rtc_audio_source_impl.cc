@@ -1,5 +1,7 @@
 #include "rtc_audio_source_impl.h"
 
+#include "rtc_audio_frame_impl.h"
+
 namespace libwebrtc {
 
 RTCAudioSourceImpl::RTCAudioSourceImpl(
@@ -8,8 +10,22 @@ RTCAudioSourceImpl::RTCAudioSourceImpl(
   RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
 }
 
+RTCAudioSourceImpl::RTCAudioSourceImpl(
+    rtc::scoped_refptr<CustomAudioSource> custom_source)
+    : rtc_audio_source_(custom_source), custom_source_(custom_source) {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
 RTCAudioSourceImpl::~RTCAudioSourceImpl() {
   RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
 }
 
+void RTCAudioSourceImpl::OnData(scoped_refptr<RTCAudioFrame> frame) {
+  if (!custom_source_ || !frame) {
+    return;
+  }
+  custom_source_->PushFrame(
+      static_cast<RTCAudioFrameImpl*>(frame.get())->rtc_frame());
+}
+
 }  // namespace libwebrtc
@@ -11,6 +11,7 @@
 #include "rtc_audio_source.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/synchronization/mutex.h"
+#include "src/internal/custom_audio_source.h"
 
 namespace libwebrtc {
 
@@ -19,14 +20,23 @@ class RTCAudioSourceImpl : public RTCAudioSource {
   RTCAudioSourceImpl(
       rtc::scoped_refptr<webrtc::AudioSourceInterface> rtc_audio_source);
 
+  RTCAudioSourceImpl(rtc::scoped_refptr<CustomAudioSource> custom_source);
+
   virtual ~RTCAudioSourceImpl();
 
+  virtual SourceType GetSourceType() const override {
+    return custom_source_ ? kCustom : kMicrophone;
+  }
+
+  virtual void OnData(scoped_refptr<RTCAudioFrame> frame) override;
+
   rtc::scoped_refptr<webrtc::AudioSourceInterface> rtc_audio_source() {
     return rtc_audio_source_;
   }
 
  private:
   rtc::scoped_refptr<webrtc::AudioSourceInterface> rtc_audio_source_;
+  rtc::scoped_refptr<CustomAudioSource> custom_source_;
 };
 
 }  // namespace libwebrtc
@@ -3,8 +3,9 @@
 namespace libwebrtc {
 
 AudioTrackImpl::AudioTrackImpl(
-    rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track)
-    : rtc_track_(audio_track) {
+    rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track,
+    rtc::scoped_refptr<EventDispatcher> dispatcher)
+    : rtc_track_(audio_track), dispatcher_(dispatcher) {
   RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
   id_ = rtc_track_->id();
   kind_ = rtc_track_->kind();
@@ -18,4 +19,49 @@ void AudioTrackImpl::SetVolume(double volume) {
   rtc_track_->GetSource()->SetVolume(volume);
 }
 
+void AudioTrackImpl::AddSink(RTCAudioTrackSink* sink, int sample_rate_hz,
+                             size_t num_channels) {
+  if (!sink_adapter_) {
+    sink_adapter_ = AudioSinkAdapter::ForTrack(rtc_track_, true);
+  }
+  sink_adapter_->AddSink(sink, sample_rate_hz, num_channels, dispatcher_);
+}
+
+void AudioTrackImpl::RemoveSink(RTCAudioTrackSink* sink) {
+  // The sink may have been added through another wrapper of this track.
+  scoped_refptr<AudioSinkAdapter> adapter =
+      sink_adapter_ ? sink_adapter_
+                    : AudioSinkAdapter::ForTrack(rtc_track_, false);
+  if (adapter) {
+    adapter->RemoveSink(sink);
+  }
+}
+
+void AudioTrackImpl::EnableLevelMeter(bool enable) {
+  if (!sink_adapter_) {
+    sink_adapter_ = AudioSinkAdapter::ForTrack(rtc_track_, enable);
+  }
+  if (sink_adapter_) {
+    sink_adapter_->EnableLevelMeter(enable);
+  }
+}
+
+RTCAudioLevel AudioTrackImpl::GetAudioLevel() const {
+  // Metering may have been turned on through another wrapper of this track.
+  scoped_refptr<AudioSinkAdapter> adapter =
+      sink_adapter_ ? sink_adapter_
+                    : AudioSinkAdapter::ForTrack(rtc_track_, false);
+  return adapter ? adapter->level() : RTCAudioLevel();
+}
+
+void AudioTrackImpl::SetLevelObserver(RTCAudioLevelObserver* observer,
+                                      float rms_threshold) {
+  if (!sink_adapter_) {
+    sink_adapter_ = AudioSinkAdapter::ForTrack(rtc_track_, observer != nullptr);
+  }
+  if (sink_adapter_) {
+    sink_adapter_->SetLevelObserver(observer, rms_threshold, dispatcher_);
+  }
+}
+
 }  // namespace libwebrtc
@@ -8,20 +8,38 @@
 #include "media/engine/webrtc_video_engine.h"
 #include "media/engine/webrtc_voice_engine.h"
 #include "pc/media_session.h"
+#include "rtc_audio_sink_adapter.h"
 #include "rtc_audio_track.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/synchronization/mutex.h"
+#include "src/internal/event_dispatcher.h"
 
 namespace libwebrtc {
 
 class AudioTrackImpl : public RTCAudioTrack {
  public:
-  AudioTrackImpl(rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track);
+  // Level events go through |dispatcher|, the one of the factory that
+  // created the track or the peer connection that received it. Without one
+  // they go through that of another wrapper of the track that has one.
+  AudioTrackImpl(rtc::scoped_refptr<webrtc::AudioTrackInterface> audio_track,
+                 rtc::scoped_refptr<EventDispatcher> dispatcher = nullptr);
 
   virtual ~AudioTrackImpl();
 
   virtual void SetVolume(double volume) override;
 
+  virtual void AddSink(RTCAudioTrackSink* sink, int sample_rate_hz = 0,
+                       size_t num_channels = 0) override;
+
+  virtual void RemoveSink(RTCAudioTrackSink* sink) override;
+
+  virtual void EnableLevelMeter(bool enable) override;
+
+  virtual RTCAudioLevel GetAudioLevel() const override;
+
+  virtual void SetLevelObserver(RTCAudioLevelObserver* observer,
+                                float rms_threshold) override;
+
   virtual const string kind() const override { return kind_; }
 
   virtual const string id() const override { return id_; }
@@ -42,6 +60,10 @@ class AudioTrackImpl : public RTCAudioTrack {
 
  private:
   rtc::scoped_refptr<webrtc::AudioTrackInterface> rtc_track_;
+  rtc::scoped_refptr<EventDispatcher> dispatcher_;
+  // Shared with the other wrappers of |rtc_track_|; set by the first AddSink
+  // or level meter call.
+  scoped_refptr<AudioSinkAdapter> sink_adapter_;
   string id_, kind_;
 };
 
@@ -16,8 +16,13 @@
 
 #include "rtc_desktop_capturer_impl.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "api/sequence_checker.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
 #include "third_party/libyuv/include/libyuv.h"
 #ifdef WEBRTC_WIN
 #include "modules/desktop_capture/win/window_capture_utils.h"
@@ -25,42 +30,20 @@
 
 namespace libwebrtc {
 
-enum { kCaptureDelay = 33, kCaptureMessageId = 1000 };
-
 RTCDesktopCapturerImpl::RTCDesktopCapturerImpl(
-    DesktopType type, webrtc::DesktopCapturer::SourceId source_id,
-    rtc::Thread* signaling_thread, scoped_refptr<MediaSource> source)
-    : thread_(rtc::Thread::Create()),
-      source_id_(source_id),
-      signaling_thread_(signaling_thread),
+    std::shared_ptr<SharedDesktopCapturer> capturer,
+    rtc::scoped_refptr<EventDispatcher> event_dispatcher,
+    scoped_refptr<MediaSource> source)
+    : capturer_(std::move(capturer)),
+      type_(capturer_->type()),
+      source_id_(capturer_->source_id()),
+      event_dispatcher_(event_dispatcher),
       source_(source) {
-  RTC_DCHECK(thread_);
-  type_ = type;
-  thread_->Start();
-  options_ = webrtc::DesktopCaptureOptions::CreateDefault();
-  options_.set_detect_updated_region(true);
-#ifdef WEBRTC_WIN
-  options_.set_allow_directx_capturer(true);
-#endif
-#ifdef WEBRTC_LINUX
-  if (type == kScreen) {
-    options_.set_allow_pipewire(true);
-  }
-#endif
-  thread_->BlockingCall([this, type] {
-    if (type == kScreen) {
-      capturer_ = std::make_unique<webrtc::DesktopAndCursorComposer>(
-          webrtc::DesktopCapturer::CreateScreenCapturer(options_), options_);
-    } else {
-      capturer_ = std::make_unique<webrtc::DesktopAndCursorComposer>(
-          webrtc::DesktopCapturer::CreateWindowCapturer(options_), options_);
-    }
-  });
+  RTC_DCHECK(capturer_);
 }
 
 RTCDesktopCapturerImpl::~RTCDesktopCapturerImpl() {
-  thread_->Stop();
-  capturer_.reset();
+  capturer_->RemoveConsumer(this);
 }
 
 RTCDesktopCapturerImpl::CaptureState RTCDesktopCapturerImpl::Start(
@@ -76,6 +59,10 @@ RTCDesktopCapturerImpl::CaptureState RTCDesktopCapturerImpl::Start(
   return Start(fps);
 }
 
+void RTCDesktopCapturerImpl::SetOutputSize(uint32_t width, uint32_t height) {
+  output_size_.store((static_cast<uint64_t>(width) << 32) | height);
+}
+
 RTCDesktopCapturerImpl::CaptureState RTCDesktopCapturerImpl::Start(
     uint32_t fps) {
   if (capture_state_ == CS_RUNNING) {
@@ -93,36 +80,24 @@ RTCDesktopCapturerImpl::CaptureState RTCDesktopCapturerImpl::Start(
     capture_delay_ = uint32_t(1000.0 / fps);
   }
 
-  if (source_id_ != -1) {
-    if (!capturer_->SelectSource(source_id_)) {
-      capture_state_ = CS_FAILED;
-      return capture_state_;
-    }
-    if (type_ == kWindow) {
-      if (!capturer_->FocusOnSelectedSource()) {
-        capture_state_ = CS_FAILED;
-        return capture_state_;
-      }
-    }
-  }
-
-  thread_->BlockingCall([this] { capturer_->Start(this); });
+  // Not a consumer yet, so the capture thread does not touch these. The
+  // shared capturer replays the cursor to us when added.
+  crop_rect_ = webrtc::DesktopRect();
+  cursor_reported_ = false;
+  raw_cursor_known_ = false;
   capture_state_ = CS_RUNNING;
-  thread_->PostTask([this] { CaptureFrame(); });
-  if (observer_) {
-    signaling_thread_->BlockingCall([&, this]() { observer_->OnStart(this); });
+  if (!capturer_->AddConsumer(this, capture_delay_)) {
+    capture_state_ = CS_FAILED;
+    return capture_state_;
   }
+
+  PostEvent({Event::kStart});
   return capture_state_;
 }
 
 void RTCDesktopCapturerImpl::Stop() {
-  if (observer_) {
-    if (!signaling_thread_->IsCurrent()) {
-      signaling_thread_->BlockingCall([&, this]() { observer_->OnStop(this); });
-    } else {
-      observer_->OnStop(this);
-    }
-  }
+  capturer_->RemoveConsumer(this);
+  PostEvent({Event::kStop});
   capture_state_ = CS_STOPPED;
 }
 
@@ -136,72 +111,100 @@ int filterException(int code, PEXCEPTION_POINTERS ex) {
 }
 #endif
 
-void RTCDesktopCapturerImpl::OnCaptureResult(
-    webrtc::DesktopCapturer::Result result,
-    std::unique_ptr<webrtc::DesktopFrame> frame) {
+void RTCDesktopCapturerImpl::OnSharedCaptureResult(
+    webrtc::DesktopCapturer::Result result, const webrtc::DesktopFrame* frame) {
+  if (capture_state_ != CS_RUNNING) {
+    return;
+  }
+
   if (result != result_) {
     if (result == webrtc::DesktopCapturer::Result::ERROR_PERMANENT) {
-      if (observer_) {
-        signaling_thread_->BlockingCall(
-            [&, this]() { observer_->OnError(this); });
-      }
+      PostEvent({Event::kError});
       capture_state_ = CS_FAILED;
+      capturer_->RemoveConsumer(this);
       return;
     }
 
     if (result == webrtc::DesktopCapturer::Result::ERROR_TEMPORARY) {
       result_ = result;
-      if (observer_) {
-        signaling_thread_->BlockingCall(
-            [&, this]() { observer_->OnPaused(this); });
-      }
+      PostEvent({Event::kPaused});
       return;
     }
 
     if (result == webrtc::DesktopCapturer::Result::SUCCESS) {
       result_ = result;
-      if (observer_) {
-        signaling_thread_->BlockingCall(
-            [&, this]() { observer_->OnStart(this); });
-      }
+      PostEvent({Event::kStart});
     }
   }
 
-  if (result == webrtc::DesktopCapturer::Result::ERROR_TEMPORARY) {
+  if (result != webrtc::DesktopCapturer::Result::SUCCESS || !frame) {
     return;
   }
 
-  int width = frame->size().width();
-  int height = frame->size().height();
+  int frame_width = frame->size().width();
+  int frame_height = frame->size().height();
 #ifdef WEBRTC_WIN
-  webrtc::DesktopRect rect_ = webrtc::DesktopRect::MakeWH(width, height);
-
   if (type_ != kScreen) {
-    webrtc::GetWindowRect(reinterpret_cast<HWND>(source_id_), &rect_);
+    webrtc::DesktopRect window_rect =
+        webrtc::DesktopRect::MakeWH(frame_width, frame_height);
+    if (webrtc::GetWindowRect(reinterpret_cast<HWND>(source_id_),
+                              &window_rect)) {
+      frame_width = std::min(frame_width, window_rect.width());
+      frame_height = std::min(frame_height, window_rect.height());
+    }
   }
 
   __try
 #endif
   {
-    width = w_ > 0 ? w_ : width;
-    height = h_ > 0 ? h_ : height;
-    if (!i420_buffer_ || !i420_buffer_.get() ||
-        i420_buffer_->width() * i420_buffer_->height() != width * height) {
-      i420_buffer_ = webrtc::I420Buffer::Create(width, height);
+    // Clamp the crop region to the captured frame.
+    int crop_x = std::min<int>(x_, frame_width);
+    int crop_y = std::min<int>(y_, frame_height);
+    int width = w_ > 0 ? std::min<int>(w_, frame_width - crop_x)
+                       : frame_width - crop_x;
+    int height = h_ > 0 ? std::min<int>(h_, frame_height - crop_y)
+                        : frame_height - crop_y;
+    if (width <= 0 || height <= 0) {
+      return;
     }
 
-    libyuv::ConvertToI420(frame->data(), 0, i420_buffer_->MutableDataY(),
-                          i420_buffer_->StrideY(), i420_buffer_->MutableDataU(),
-                          i420_buffer_->StrideU(), i420_buffer_->MutableDataV(),
-                          i420_buffer_->StrideV(), x_, y_,
-#ifdef WEBRTC_WIN
-                          rect_.width(), rect_.height(),
-#else
-                          width, height,
-#endif
-                          width, height, libyuv::kRotate0, libyuv::FOURCC_ARGB);
+    rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer =
+        buffer_pool_.CreateI420Buffer(width, height);
+    if (!i420_buffer) {
+      RTC_LOG(LS_WARNING) << "Desktop capturer buffer pool exhausted.";
+      return;
+    }
 
-    OnFrame(webrtc::VideoFrame(i420_buffer_, 0, rtc::TimeMillis(),
+    libyuv::ARGBToI420(
+        frame->GetFrameDataAtPos(webrtc::DesktopVector(crop_x, crop_y)),
+        frame->stride(), i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+        i420_buffer->MutableDataU(), i420_buffer->StrideU(),
+        i420_buffer->MutableDataV(), i420_buffer->StrideV(), width, height);
+
+    uint64_t output_size = output_size_.load();
+    int output_width = static_cast<int>(output_size >> 32);
+    int output_height = static_cast<int>(output_size & 0xffffffff);
+    if (output_width > 0 && output_height > 0 &&
+        (output_width != width || output_height != height)) {
+      rtc::scoped_refptr<webrtc::I420Buffer> scaled_buffer =
+          buffer_pool_.CreateI420Buffer(output_width, output_height);
+      if (!scaled_buffer) {
+        RTC_LOG(LS_WARNING) << "Desktop capturer buffer pool exhausted.";
+        return;
+      }
+      scaled_buffer->ScaleFrom(*i420_buffer);
+      i420_buffer = scaled_buffer;
+    }
+    crop_rect_ = webrtc::DesktopRect::MakeXYWH(crop_x, crop_y, width, height);
+    delivered_size_ = webrtc::DesktopSize(i420_buffer->width(),
+                                          i420_buffer->height());
+    // A position reported before the first frame, or one that the new
+    // geometry moves, is only known to the observer from here on.
+    if (raw_cursor_known_) {
+      ReportCursorPosition();
+    }
+
+    OnFrame(webrtc::VideoFrame(i420_buffer, 0, rtc::TimeMillis(),
                                webrtc::kVideoRotation_0));
   }
 #ifdef WEBRTC_WIN
@@ -210,13 +213,95 @@ void RTCDesktopCapturerImpl::OnCaptureResult(
 #endif
 }
 
-void RTCDesktopCapturerImpl::CaptureFrame() {
-  RTC_DCHECK_RUN_ON(thread_.get());
-  if (capture_state_ == CS_RUNNING) {
-    capturer_->CaptureFrame();
-    thread_->PostDelayedHighPrecisionTask(
-        [this]() { CaptureFrame(); },
-        webrtc::TimeDelta::Millis(capture_delay_));
+void RTCDesktopCapturerImpl::OnSharedCursorShape(
+    const webrtc::MouseCursor& cursor) {
+  if (capture_state_ != CS_RUNNING || !observer_) {
+    return;
+  }
+  const webrtc::DesktopFrame* image = cursor.image();
+  Event event{Event::kCursorShape};
+  DesktopCursorShape& shape = event.shape;
+  shape.width = image->size().width();
+  shape.height = image->size().height();
+  shape.hotspot_x = cursor.hotspot().x();
+  shape.hotspot_y = cursor.hotspot().y();
+  const int row_bytes = shape.width * webrtc::DesktopFrame::kBytesPerPixel;
+  std::vector<uint8_t> data(row_bytes * shape.height);
+  for (int row = 0; row < shape.height; ++row) {
+    memcpy(data.data() + row * row_bytes,
+           image->data() + row * image->stride(), row_bytes);
+  }
+  shape.data = data;
+  PostEvent(event);
+}
+
+void RTCDesktopCapturerImpl::OnSharedCursorPosition(
+    const webrtc::DesktopVector& position, bool inside_frame) {
+  raw_cursor_position_ = position;
+  raw_cursor_inside_ = inside_frame;
+  raw_cursor_known_ = true;
+  ReportCursorPosition();
+}
+
+void RTCDesktopCapturerImpl::ReportCursorPosition() {
+  if (capture_state_ != CS_RUNNING || !observer_ || crop_rect_.is_empty()) {
+    return;
+  }
+  // Map from captured frame coordinates to the cropped and scaled output.
+  const webrtc::DesktopVector& position = raw_cursor_position_;
+  bool visible = raw_cursor_inside_ && crop_rect_.Contains(position);
+  int x = (position.x() - crop_rect_.left()) * delivered_size_.width() /
+          crop_rect_.width();
+  int y = (position.y() - crop_rect_.top()) * delivered_size_.height() /
+          crop_rect_.height();
+  webrtc::DesktopVector mapped(x, y);
+  if (cursor_reported_ && mapped.equals(cursor_position_) &&
+      visible == cursor_visible_) {
+    return;
+  }
+  cursor_reported_ = true;
+  cursor_position_ = mapped;
+  cursor_visible_ = visible;
+  Event event{Event::kCursorPosition};
+  event.x = x;
+  event.y = y;
+  event.visible = visible;
+  PostEvent(event);
+}
+
+void RTCDesktopCapturerImpl::PostEvent(const Event& event) {
+  if (!observer_) {
+    return;
+  }
+  scoped_refptr<RTCDesktopCapturerImpl> self(this);
+  event_dispatcher_->Post([self, event]() { self->DeliverEvent(event); });
+}
+
+void RTCDesktopCapturerImpl::DeliverEvent(const Event& event) {
+  // Looked up at delivery so a deregistered observer is not called.
+  DesktopCapturerObserver* observer = observer_;
+  if (!observer) {
+    return;
+  }
+  switch (event.type) {
+    case Event::kStart:
+      observer->OnStart(this);
+      break;
+    case Event::kPaused:
+      observer->OnPaused(this);
+      break;
+    case Event::kStop:
+      observer->OnStop(this);
+      break;
+    case Event::kError:
+      observer->OnError(this);
+      break;
+    case Event::kCursorShape:
+      observer->OnCursorShapeChanged(this, event.shape);
+      break;
+    case Event::kCursorPosition:
+      observer->OnCursorPositionChanged(this, event.x, event.y, event.visible);
+      break;
   }
 }
 
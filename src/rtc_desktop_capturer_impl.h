@@ -17,27 +17,28 @@
 #ifndef LIBWEBRTC_RTC_DESKTOP_CAPTURER_IMPL_HXX
 #define LIBWEBRTC_RTC_DESKTOP_CAPTURER_IMPL_HXX
 
+#include <atomic>
+
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame.h"
+#include "common_video/include/video_frame_buffer_pool.h"
 #include "include/rtc_desktop_capturer.h"
 #include "include/rtc_types.h"
-#include "modules/desktop_capture/desktop_and_cursor_composer.h"
-#include "modules/desktop_capture/desktop_capture_options.h"
 #include "modules/desktop_capture/desktop_capturer.h"
 #include "modules/desktop_capture/desktop_frame.h"
-#include "rtc_base/thread.h"
+#include "src/internal/event_dispatcher.h"
+#include "src/internal/shared_desktop_capturer.h"
 #include "src/internal/vcm_capturer.h"
 #include "src/internal/video_capturer.h"
 
 namespace libwebrtc {
 
 class RTCDesktopCapturerImpl : public RTCDesktopCapturer,
-                               public webrtc::DesktopCapturer::Callback,
+                               public SharedDesktopCapturer::Consumer,
                                public webrtc::internal::VideoCapturer {
  public:
-  RTCDesktopCapturerImpl(DesktopType type,
-                         webrtc::DesktopCapturer::SourceId source_id,
-                         rtc::Thread* signaling_thread,
+  RTCDesktopCapturerImpl(std::shared_ptr<SharedDesktopCapturer> capturer,
+                         rtc::scoped_refptr<EventDispatcher> event_dispatcher,
                          scoped_refptr<MediaSource> source);
   ~RTCDesktopCapturerImpl();
 
@@ -52,6 +53,8 @@ class RTCDesktopCapturerImpl : public RTCDesktopCapturer,
   CaptureState Start(uint32_t fps, uint32_t x, uint32_t y, uint32_t w,
                      uint32_t h) override;
 
+  void SetOutputSize(uint32_t width, uint32_t height) override;
+
   void Stop() override;
 
   bool IsRunning() override;
@@ -59,29 +62,71 @@ class RTCDesktopCapturerImpl : public RTCDesktopCapturer,
   scoped_refptr<MediaSource> source() override { return source_; }
 
  protected:
-  virtual void OnCaptureResult(
-      webrtc::DesktopCapturer::Result result,
-      std::unique_ptr<webrtc::DesktopFrame> frame) override;
+  void OnSharedCaptureResult(webrtc::DesktopCapturer::Result result,
+                             const webrtc::DesktopFrame* frame) override;
+
+  void OnSharedCursorShape(const webrtc::MouseCursor& cursor) override;
+
+  void OnSharedCursorPosition(const webrtc::DesktopVector& position,
+                              bool inside_frame) override;
 
  private:
-  void CaptureFrame();
-  webrtc::DesktopCaptureOptions options_;
-  std::unique_ptr<webrtc::DesktopCapturer> capturer_;
-  std::unique_ptr<rtc::Thread> thread_;
-  rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer_;
+  // An observer callback queued on the event dispatcher.
+  struct Event {
+    enum Type {
+      kStart,
+      kPaused,
+      kStop,
+      kError,
+      kCursorShape,
+      kCursorPosition,
+    };
+    Type type;
+    int x = 0;
+    int y = 0;
+    bool visible = false;
+    DesktopCursorShape shape;
+  };
+
+  void PostEvent(const Event& event);
+
+  // Maps the last raw cursor position onto the delivered frame and reports
+  // it if it changed. Runs on the capture thread.
+  void ReportCursorPosition();
+
+  // Runs on the event executor or the signaling thread.
+  void DeliverEvent(const Event& event);
+
+  std::shared_ptr<SharedDesktopCapturer> capturer_;
+  webrtc::VideoFrameBufferPool buffer_pool_;
   CaptureState capture_state_ = CS_STOPPED;
   DesktopType type_;
   webrtc::DesktopCapturer::SourceId source_id_;
-  DesktopCapturerObserver* observer_ = nullptr;
+  std::atomic<DesktopCapturerObserver*> observer_{nullptr};
   uint32_t capture_delay_ = 1000;  // 1s
   webrtc::DesktopCapturer::Result result_ =
       webrtc::DesktopCapturer::Result::SUCCESS;
-  rtc::Thread* signaling_thread_ = nullptr;
+  rtc::scoped_refptr<EventDispatcher> event_dispatcher_;
   scoped_refptr<MediaSource> source_;
   uint32_t x_ = 0;
   uint32_t y_ = 0;
   uint32_t w_ = 0;
   uint32_t h_ = 0;
+  // Width in the high and height in the low 32 bits, so the capture thread
+  // never sees one dimension of a new size with the other of the old one.
+  std::atomic<uint64_t> output_size_{0};
+  // Geometry of the last delivered frame, used to map cursor positions.
+  // Only accessed on the capture thread.
+  webrtc::DesktopRect crop_rect_;
+  webrtc::DesktopSize delivered_size_;
+  webrtc::DesktopVector cursor_position_;
+  bool cursor_visible_ = false;
+  bool cursor_reported_ = false;
+  // The cursor in captured frame coordinates, kept until there is a frame
+  // to map it onto. Only accessed on the capture thread.
+  webrtc::DesktopVector raw_cursor_position_;
+  bool raw_cursor_inside_ = false;
+  bool raw_cursor_known_ = false;
 };
 
 }  // namespace libwebrtc
@@ -4,28 +4,58 @@
 #include "rtc_desktop_capturer.h"
 #include "rtc_desktop_media_list.h"
 #include "rtc_video_device_impl.h"
+#include "src/internal/desktop_capture_scheduler.h"
+#include "src/internal/shared_desktop_capturer.h"
 
 namespace libwebrtc {
 
-RTCDesktopDeviceImpl::RTCDesktopDeviceImpl(rtc::Thread* signaling_thread)
-    : signaling_thread_(signaling_thread) {}
+RTCDesktopDeviceImpl::RTCDesktopDeviceImpl(
+    rtc::scoped_refptr<EventDispatcher> event_dispatcher)
+    : event_dispatcher_(event_dispatcher) {}
 
 RTCDesktopDeviceImpl::~RTCDesktopDeviceImpl() {}
 
 scoped_refptr<RTCDesktopCapturer> RTCDesktopDeviceImpl::CreateDesktopCapturer(
     scoped_refptr<MediaSource> source) {
+  return CreateDesktopCapturer(source, true);
+}
+
+scoped_refptr<RTCDesktopCapturer> RTCDesktopDeviceImpl::CreateDesktopCapturer(
+    scoped_refptr<MediaSource> source, bool show_cursor) {
   MediaSourceImpl* source_impl = static_cast<MediaSourceImpl*>(source.get());
+  // Capturers of the same source and cursor mode share a single capture loop.
   return new RefCountedObject<RTCDesktopCapturerImpl>(
-      source_impl->type(), source_impl->source_id(), signaling_thread_, source);
+      SharedDesktopCapturer::GetOrCreate(source_impl->type(),
+                                         source_impl->source_id(), show_cursor),
+      event_dispatcher_, source);
 }
 
 scoped_refptr<RTCDesktopMediaList> RTCDesktopDeviceImpl::GetDesktopMediaList(
     DesktopType type) {
   if (desktop_media_lists_.find(type) == desktop_media_lists_.end()) {
     desktop_media_lists_[type] =
-        new RefCountedObject<RTCDesktopMediaListImpl>(type, signaling_thread_);
+        new RefCountedObject<RTCDesktopMediaListImpl>(type, event_dispatcher_);
   }
   return desktop_media_lists_[type];
 }
 
+void RTCDesktopDeviceImpl::SetCaptureThreadPoolSize(uint32_t threads) {
+  DesktopCaptureScheduler::Instance()->SetMaxThreads(threads);
+}
+
+vector<DesktopCaptureJobStats> RTCDesktopDeviceImpl::GetCaptureJobStats() {
+  std::vector<DesktopCaptureJobStats> result;
+  for (const auto& job : DesktopCaptureScheduler::Instance()->GetStats()) {
+    DesktopCaptureJobStats stats;
+    stats.name = job.name;
+    stats.runs = job.runs;
+    stats.total_run_time_us = job.total_run_time_us;
+    stats.max_run_time_us = job.max_run_time_us;
+    stats.total_delay_us = job.total_delay_us;
+    stats.max_delay_us = job.max_delay_us;
+    result.push_back(stats);
+  }
+  return result;
+}
+
 }  // namespace libwebrtc
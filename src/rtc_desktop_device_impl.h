@@ -11,22 +11,30 @@
 #include "rtc_base/thread.h"
 #include "rtc_desktop_device.h"
 #include "rtc_desktop_media_list_impl.h"
+#include "src/internal/event_dispatcher.h"
 
 namespace libwebrtc {
 
 class RTCDesktopDeviceImpl : public RTCDesktopDevice {
  public:
-  RTCDesktopDeviceImpl(rtc::Thread* signaling_thread);
+  RTCDesktopDeviceImpl(rtc::scoped_refptr<EventDispatcher> event_dispatcher);
   ~RTCDesktopDeviceImpl();
 
   scoped_refptr<RTCDesktopCapturer> CreateDesktopCapturer(
       scoped_refptr<MediaSource> source) override;
 
+  scoped_refptr<RTCDesktopCapturer> CreateDesktopCapturer(
+      scoped_refptr<MediaSource> source, bool show_cursor) override;
+
   scoped_refptr<RTCDesktopMediaList> GetDesktopMediaList(
       DesktopType type) override;
 
+  void SetCaptureThreadPoolSize(uint32_t threads) override;
+
+  vector<DesktopCaptureJobStats> GetCaptureJobStats() override;
+
  private:
-  rtc::Thread* signaling_thread_ = nullptr;
+  rtc::scoped_refptr<EventDispatcher> event_dispatcher_;
   std::map<DesktopType, scoped_refptr<RTCDesktopMediaListImpl>>
       desktop_media_lists_;
 };
@@ -16,8 +16,10 @@
 
 #include "rtc_desktop_media_list_impl.h"
 
+#include "api/sequence_checker.h"
 #include "internal/jpeg_util.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
 #include "third_party/libyuv/include/libyuv.h"
 
 #ifdef WEBRTC_WIN
@@ -26,16 +28,17 @@
 
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
 
 namespace libwebrtc {
 
-RTCDesktopMediaListImpl::RTCDesktopMediaListImpl(DesktopType type,
-                                                 rtc::Thread* signaling_thread)
-    : thread_(rtc::Thread::Create()),
+RTCDesktopMediaListImpl::RTCDesktopMediaListImpl(
+    DesktopType type, rtc::scoped_refptr<EventDispatcher> event_dispatcher)
+    : job_(DesktopCaptureScheduler::Instance()->CreateJob(
+          type == kScreen ? "screen_list" : "window_list")),
+      thread_(job_->thread()),
       type_(type),
-      signaling_thread_(signaling_thread) {
-  RTC_DCHECK(thread_);
-  thread_->Start();
+      event_dispatcher_(event_dispatcher) {
   options_ = webrtc::DesktopCaptureOptions::CreateDefault();
   options_.set_detect_updated_region(true);
 #ifdef WEBRTC_WIN
@@ -57,108 +60,173 @@ RTCDesktopMediaListImpl::RTCDesktopMediaListImpl(DesktopType type,
   });
 }
 
-RTCDesktopMediaListImpl::~RTCDesktopMediaListImpl() { thread_->Stop(); }
+RTCDesktopMediaListImpl::~RTCDesktopMediaListImpl() {
+  thread_->BlockingCall([this] {
+    monitor_task_.Stop();
+    capturer_.reset();
+  });
+  // Drops thumbnail requests that have not run yet.
+  job_.reset();
+}
 
 int32_t RTCDesktopMediaListImpl::UpdateSourceList(bool force_reload,
                                                   bool get_thumbnail) {
+  SourceChanges changes;
   if (force_reload) {
-    for (auto source : sources_) {
-      if (observer_) {
-        auto source_ptr = source.get();
-        signaling_thread_->BlockingCall(
-            [&, source_ptr]() { observer_->OnMediaSourceRemoved(source_ptr); });
-      }
-    }
-    sources_.clear();
+    webrtc::MutexLock lock(&mutex_);
+    changes.removed.swap(sources_);
   }
 
   webrtc::DesktopCapturer::SourceList new_sources;
   thread_->BlockingCall(
       [this, &new_sources] { capturer_->GetSourceList(&new_sources); });
 
-  typedef std::set<webrtc::DesktopCapturer::SourceId> SourceSet;
-  SourceSet new_source_set;
+  ReconcileSources(std::move(new_sources), &changes);
+
+  for (auto source : changes.added) {
+    GetThumbnail(source, true);
+  }
+
+  if (!changes.empty()) {
+    PostSourceChanges(changes);
+  }
+
+  std::vector<scoped_refptr<MediaSourceImpl>> sources;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    sources = sources_;
+  }
+  if (get_thumbnail) {
+    for (auto source : sources) {
+      GetThumbnail(source.get(), true);
+    }
+  }
+  return sources.size();
+}
+
+void RTCDesktopMediaListImpl::ReconcileSources(
+    webrtc::DesktopCapturer::SourceList new_sources, SourceChanges* changes) {
+  webrtc::MutexLock lock(&mutex_);
+  std::unordered_map<webrtc::DesktopCapturer::SourceId, size_t> old_index;
+  old_index.reserve(sources_.size());
+  for (size_t i = 0; i < sources_.size(); ++i) {
+    old_index[sources_[i]->source_id()] = i;
+  }
+
+  std::vector<bool> kept(sources_.size(), false);
+  std::vector<scoped_refptr<MediaSourceImpl>> updated;
+  updated.reserve(new_sources.size());
   for (size_t i = 0; i < new_sources.size(); ++i) {
     if (type_ == kScreen && new_sources[i].title.length() == 0) {
       new_sources[i].title = std::string("Screen " + std::to_string(i + 1));
     }
-    new_source_set.insert(new_sources[i].id);
+    auto it = old_index.find(new_sources[i].id);
+    if (it == old_index.end() || kept[it->second]) {
+      scoped_refptr<MediaSourceImpl> source =
+          new RefCountedObject<MediaSourceImpl>(this, new_sources[i], type_);
+      changes->added.push_back(source);
+      updated.push_back(source);
+      continue;
+    }
+    kept[it->second] = true;
+    scoped_refptr<MediaSourceImpl> source = sources_[it->second];
+    if (source->source.title != new_sources[i].title) {
+      source->source.title = new_sources[i].title;
+      changes->name_changed.push_back(source);
+    }
+    updated.push_back(source);
   }
-  // Iterate through the old sources to find the removed sources.
+
   for (size_t i = 0; i < sources_.size(); ++i) {
-    if (new_source_set.find(sources_[i]->source_id()) == new_source_set.end()) {
-      if (observer_) {
-        auto source = (*(sources_.begin() + i)).get();
-        signaling_thread_->BlockingCall(
-            [&, source]() { observer_->OnMediaSourceRemoved(source); });
-      }
-      sources_.erase(sources_.begin() + i);
-      --i;
-    }
+    if (!kept[i]) changes->removed.push_back(sources_[i]);
   }
-  // Iterate through the new sources to find the added sources.
-  if (new_sources.size() > sources_.size()) {
-    SourceSet old_source_set;
-    for (size_t i = 0; i < sources_.size(); ++i) {
-      old_source_set.insert(sources_[i]->source_id());
-    }
-    for (size_t i = 0; i < new_sources.size(); ++i) {
-      if (old_source_set.find(new_sources[i].id) == old_source_set.end()) {
-        auto source =
-            new RefCountedObject<MediaSourceImpl>(this, new_sources[i], type_);
-        sources_.insert(sources_.begin() + i, source);
-        GetThumbnail(source, true);
-        if (observer_) {
-          signaling_thread_->BlockingCall(
-              [&, source]() { observer_->OnMediaSourceAdded(source); });
-        }
-      }
-    }
+  sources_.swap(updated);
+}
+
+void RTCDesktopMediaListImpl::PostSourceChanges(SourceChanges changes) {
+  if (!observer_) return;
+  scoped_refptr<RTCDesktopMediaListImpl> self(this);
+  event_dispatcher_->Post([self, changes = std::move(changes)]() {
+    self->NotifySourceChanges(changes);
+  });
+}
+
+void RTCDesktopMediaListImpl::NotifySourceChanges(
+    const SourceChanges& changes) {
+  MediaListObserver* observer = observer_;
+  if (!observer) return;
+  for (auto source : changes.removed) {
+    observer->OnMediaSourceRemoved(source.get());
   }
+  for (auto source : changes.added) {
+    observer->OnMediaSourceAdded(source.get());
+  }
+  for (auto source : changes.name_changed) {
+    observer->OnMediaSourceNameChanged(source.get());
+  }
+  observer->OnMediaSourcesChanged(
+      std::vector<scoped_refptr<MediaSource>>(changes.added.begin(),
+                                              changes.added.end()),
+      std::vector<scoped_refptr<MediaSource>>(changes.removed.begin(),
+                                              changes.removed.end()),
+      std::vector<scoped_refptr<MediaSource>>(changes.name_changed.begin(),
+                                              changes.name_changed.end()));
+}
 
-  RTC_DCHECK_EQ(new_sources.size(), sources_.size());
-
-  // Find the moved/changed sources.
-  size_t pos = 0;
-  while (pos < sources_.size()) {
-    if (!(sources_[pos]->source_id() == new_sources[pos].id)) {
-      // Find the source that should be moved to |pos|, starting from |pos + 1|
-      // of |sources_|, because entries before |pos| should have been sorted.
-      size_t old_pos = pos + 1;
-      for (; old_pos < sources_.size(); ++old_pos) {
-        if (sources_[old_pos]->source_id() == new_sources[pos].id) break;
-      }
-      RTC_DCHECK(sources_[old_pos]->source_id() == new_sources[pos].id);
-
-      // Move the source from |old_pos| to |pos|.
-      auto temp = sources_[old_pos];
-      sources_.erase(sources_.begin() + old_pos);
-      sources_.insert(sources_.begin() + pos, temp);
-      // if(observer_) observer_->OnMediaSourceMoved:old_pos newIndex:pos];
+bool RTCDesktopMediaListImpl::StartMonitoring(uint32_t interval_ms,
+                                              bool get_thumbnail) {
+  if (interval_ms == 0) {
+    return false;
+  }
+  thread_->BlockingCall([this, interval_ms, get_thumbnail] {
+    monitor_interval_ms_ = interval_ms;
+    monitor_thumbnails_ = get_thumbnail;
+    if (monitor_task_.Running()) {
+      return;
     }
+    monitor_deadline_us_ = rtc::TimeMicros();
+    monitor_task_ = webrtc::RepeatingTaskHandle::Start(thread_, [this] {
+      const int64_t start_us = rtc::TimeMicros();
+      RefreshSources();
+      job_->RecordRun(monitor_deadline_us_, start_us, rtc::TimeMicros());
+      monitor_deadline_us_ = start_us + monitor_interval_ms_ * 1000;
+      return webrtc::TimeDelta::Millis(monitor_interval_ms_);
+    });
+  });
+  monitoring_ = true;
+  return true;
+}
 
-    if (sources_[pos]->source.title != new_sources[pos].title) {
-      sources_[pos]->source.title = new_sources[pos].title;
-      if (observer_) {
-        auto source = sources_[pos].get();
-        signaling_thread_->BlockingCall(
-            [&, source]() { observer_->OnMediaSourceNameChanged(source); });
-      }
-    }
-    ++pos;
+void RTCDesktopMediaListImpl::StopMonitoring() {
+  thread_->BlockingCall([this] { monitor_task_.Stop(); });
+  monitoring_ = false;
+}
+
+void RTCDesktopMediaListImpl::RefreshSources() {
+  RTC_DCHECK_RUN_ON(thread_);
+  webrtc::DesktopCapturer::SourceList new_sources;
+  if (!capturer_->GetSourceList(&new_sources)) {
+    return;
   }
 
-  if (get_thumbnail) {
-    for (auto source : sources_) {
-      GetThumbnail(source.get(), true);
+  SourceChanges changes;
+  ReconcileSources(std::move(new_sources), &changes);
+  if (changes.empty()) {
+    return;
+  }
+
+  if (monitor_thumbnails_) {
+    for (auto source : changes.added) {
+      GetThumbnail(source, true);
     }
   }
-  return sources_.size();
+
+  PostSourceChanges(std::move(changes));
 }
 
 bool RTCDesktopMediaListImpl::GetThumbnail(scoped_refptr<MediaSource> source,
                                            bool notify) {
-  thread_->PostTask([this, source, notify] {
+  job_->PostTask([this, source, notify] {
     MediaSourceImpl* source_impl = static_cast<MediaSourceImpl*>(source.get());
     if (capturer_->SelectSource(source_impl->source_id())) {
       callback_->SetCallback([&](webrtc::DesktopCapturer::Result result,
@@ -166,8 +234,12 @@ bool RTCDesktopMediaListImpl::GetThumbnail(scoped_refptr<MediaSource> source,
         auto old_thumbnail = source_impl->thumbnail();
         source_impl->SaveCaptureResult(result, std::move(frame));
         if (observer_ && notify) {
-          signaling_thread_->BlockingCall([&, source_impl]() {
-            observer_->OnMediaSourceThumbnailChanged(source_impl);
+          scoped_refptr<RTCDesktopMediaListImpl> self(this);
+          scoped_refptr<MediaSource> changed(source_impl);
+          event_dispatcher_->Post([self, changed]() {
+            if (MediaListObserver* observer = self->observer_) {
+              observer->OnMediaSourceThumbnailChanged(changed);
+            }
           });
         }
       });
@@ -177,9 +249,16 @@ bool RTCDesktopMediaListImpl::GetThumbnail(scoped_refptr<MediaSource> source,
   return true;
 }
 
-int RTCDesktopMediaListImpl::GetSourceCount() const { return sources_.size(); }
+int RTCDesktopMediaListImpl::GetSourceCount() const {
+  webrtc::MutexLock lock(&mutex_);
+  return sources_.size();
+}
 
 scoped_refptr<MediaSource> RTCDesktopMediaListImpl::GetSource(int index) {
+  webrtc::MutexLock lock(&mutex_);
+  if (index < 0 || static_cast<size_t>(index) >= sources_.size()) {
+    return nullptr;
+  }
   return sources_[index];
 }
 
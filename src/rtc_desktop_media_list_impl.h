@@ -17,14 +17,20 @@
 #ifndef LIBWEBRTC_RTC_DESKTOP_MEDIA_LIST_IMPL_HXX
 #define LIBWEBRTC_RTC_DESKTOP_MEDIA_LIST_IMPL_HXX
 
+#include <atomic>
+
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame.h"
 #include "modules/desktop_capture/desktop_capture_options.h"
 #include "modules/desktop_capture/desktop_capturer.h"
 #include "modules/desktop_capture/desktop_frame.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/task_utils/repeating_task.h"
 #include "rtc_base/thread.h"
 #include "rtc_desktop_capturer_impl.h"
 #include "rtc_desktop_media_list.h"
+#include "src/internal/desktop_capture_scheduler.h"
+#include "src/internal/event_dispatcher.h"
 
 namespace libwebrtc {
 
@@ -73,7 +79,8 @@ class RTCDesktopMediaListImpl : public RTCDesktopMediaList {
   enum CaptureState { CS_RUNNING, CS_STOPPED, CS_FAILED };
 
  public:
-  RTCDesktopMediaListImpl(DesktopType type, rtc::Thread* signaling_thread);
+  RTCDesktopMediaListImpl(DesktopType type,
+                          rtc::scoped_refptr<EventDispatcher> event_dispatcher);
 
   virtual ~RTCDesktopMediaListImpl();
 
@@ -95,7 +102,39 @@ class RTCDesktopMediaListImpl : public RTCDesktopMediaList {
   bool GetThumbnail(scoped_refptr<MediaSource> source,
                     bool notify = false) override;
 
+  bool StartMonitoring(uint32_t interval_ms,
+                       bool get_thumbnail = false) override;
+
+  void StopMonitoring() override;
+
+  bool IsMonitoring() const override { return monitoring_; }
+
  private:
+  struct SourceChanges {
+    std::vector<scoped_refptr<MediaSourceImpl>> added;
+    std::vector<scoped_refptr<MediaSourceImpl>> removed;
+    std::vector<scoped_refptr<MediaSourceImpl>> name_changed;
+
+    bool empty() const {
+      return added.empty() && removed.empty() && name_changed.empty();
+    }
+  };
+
+  // Diffs |new_sources| against |sources_| by id and replaces |sources_| with
+  // the new ordering. Runs in O(n) regardless of how the list was shuffled.
+  void ReconcileSources(webrtc::DesktopCapturer::SourceList new_sources,
+                        SourceChanges* changes);
+
+  // Queues |changes| for the observer on the event dispatcher.
+  void PostSourceChanges(SourceChanges changes);
+
+  // Delivers |changes| to the observer. Runs on the event executor or the
+  // signaling thread.
+  void NotifySourceChanges(const SourceChanges& changes);
+
+  // Monitor tick, runs on the job's capture thread.
+  void RefreshSources();
+
   class CallbackProxy : public webrtc::DesktopCapturer::Callback {
    public:
     CallbackProxy() {}
@@ -120,11 +159,18 @@ class RTCDesktopMediaListImpl : public RTCDesktopMediaList {
   std::unique_ptr<CallbackProxy> callback_;
   webrtc::DesktopCaptureOptions options_;
   std::unique_ptr<webrtc::DesktopCapturer> capturer_;
-  std::unique_ptr<rtc::Thread> thread_;
+  std::unique_ptr<DesktopCaptureScheduler::Job> job_;
+  rtc::Thread* thread_;
+  mutable webrtc::Mutex mutex_;
   std::vector<scoped_refptr<MediaSourceImpl>> sources_;
-  MediaListObserver* observer_ = nullptr;
+  webrtc::RepeatingTaskHandle monitor_task_;
+  std::atomic<bool> monitoring_{false};
+  uint32_t monitor_interval_ms_ = 1000;
+  int64_t monitor_deadline_us_ = 0;
+  bool monitor_thumbnails_ = false;
+  std::atomic<MediaListObserver*> observer_{nullptr};
   DesktopType type_;
-  rtc::Thread* signaling_thread_ = nullptr;
+  rtc::scoped_refptr<EventDispatcher> event_dispatcher_;
 };
 
 }  // namespace libwebrtc
@@ -0,0 +1,36 @@
+#include "rtc_encoded_video_source_impl.h"
+
+#include "base/refcountedobject.h"
+#include "rtc_base/logging.h"
+
+namespace libwebrtc {
+
+RTCEncodedVideoSourceImpl::RTCEncodedVideoSourceImpl(
+    RTCVideoCodecType codec,
+    rtc::scoped_refptr<EncodedVideoTrackSource> source)
+    : codec_(codec),
+      source_(source),
+      video_source_(new RefCountedObject<RTCVideoSourceImpl>(
+          rtc::scoped_refptr<webrtc::VideoTrackSourceInterface>(source))) {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+RTCEncodedVideoSourceImpl::~RTCEncodedVideoSourceImpl() {
+  source_->SetObserver(nullptr);
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool RTCEncodedVideoSourceImpl::PushFrame(const uint8_t* data, size_t size,
+                                          bool key_frame, int width,
+                                          int height,
+                                          int64_t capture_time_us) {
+  return source_->PushFrame(data, size, key_frame, width, height,
+                            capture_time_us);
+}
+
+void RTCEncodedVideoSourceImpl::SetObserver(
+    RTCEncodedVideoSourceObserver* observer) {
+  source_->SetObserver(observer);
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,37 @@
+#ifndef LIB_WEBRTC_ENCODED_VIDEO_SOURCE_IMPL_HXX
+#define LIB_WEBRTC_ENCODED_VIDEO_SOURCE_IMPL_HXX
+
+#include "rtc_encoded_video_source.h"
+#include "rtc_video_source_impl.h"
+#include "src/internal/encoded_video_track_source.h"
+
+namespace libwebrtc {
+
+class RTCEncodedVideoSourceImpl : public RTCEncodedVideoSource {
+ public:
+  RTCEncodedVideoSourceImpl(RTCVideoCodecType codec,
+                            rtc::scoped_refptr<EncodedVideoTrackSource> source);
+
+  scoped_refptr<RTCVideoSource> video_source() override {
+    return video_source_;
+  }
+
+  RTCVideoCodecType codec() const override { return codec_; }
+
+  bool PushFrame(const uint8_t* data, size_t size, bool key_frame, int width,
+                 int height, int64_t capture_time_us) override;
+
+  void SetObserver(RTCEncodedVideoSourceObserver* observer) override;
+
+ protected:
+  ~RTCEncodedVideoSourceImpl() override;
+
+ private:
+  const RTCVideoCodecType codec_;
+  const rtc::scoped_refptr<EncodedVideoTrackSource> source_;
+  const scoped_refptr<RTCVideoSourceImpl> video_source_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_ENCODED_VIDEO_SOURCE_IMPL_HXX
@@ -9,13 +9,14 @@
 namespace libwebrtc {
 
 MediaStreamImpl::MediaStreamImpl(
-    rtc::scoped_refptr<webrtc::MediaStreamInterface> rtc_media_stream)
-    : rtc_media_stream_(rtc_media_stream) {
+    rtc::scoped_refptr<webrtc::MediaStreamInterface> rtc_media_stream,
+    rtc::scoped_refptr<EventDispatcher> dispatcher)
+    : rtc_media_stream_(rtc_media_stream), dispatcher_(dispatcher) {
   rtc_media_stream_->RegisterObserver(this);
 
   for (auto track : rtc_media_stream->GetAudioTracks()) {
     scoped_refptr<AudioTrackImpl> audio_track = scoped_refptr<AudioTrackImpl>(
-        new RefCountedObject<AudioTrackImpl>(track));
+        new RefCountedObject<AudioTrackImpl>(track, dispatcher_));
     audio_tracks_.push_back(audio_track);
   }
 
@@ -115,7 +116,7 @@ void MediaStreamImpl::OnChanged() {
   std::vector<scoped_refptr<RTCAudioTrack>> audio_tracks;
   for (auto track : rtc_media_stream_->GetAudioTracks()) {
     scoped_refptr<AudioTrackImpl> audio_track = scoped_refptr<AudioTrackImpl>(
-        new RefCountedObject<AudioTrackImpl>(track));
+        new RefCountedObject<AudioTrackImpl>(track, dispatcher_));
     audio_tracks.push_back(audio_track);
   }
 
@@ -6,6 +6,7 @@
 
 #include "rtc_media_stream.h"
 #include "rtc_peerconnection.h"
+#include "src/internal/event_dispatcher.h"
 
 
 
@@ -185,8 +186,10 @@ class MediaRTCStatsImpl : public MediaRTCStats {
 class MediaStreamImpl : public RTCMediaStream,
                         public webrtc::ObserverInterface {
  public:
+  // |dispatcher| is passed on to the audio track wrappers.
   MediaStreamImpl(
-      rtc::scoped_refptr<webrtc::MediaStreamInterface> rtc_media_stream);
+      rtc::scoped_refptr<webrtc::MediaStreamInterface> rtc_media_stream,
+      rtc::scoped_refptr<EventDispatcher> dispatcher = nullptr);
 
   ~MediaStreamImpl();
 
@@ -227,6 +230,7 @@ class MediaStreamImpl : public RTCMediaStream,
 
  private:
   rtc::scoped_refptr<webrtc::MediaStreamInterface> rtc_media_stream_;
+  rtc::scoped_refptr<EventDispatcher> dispatcher_;
   rtc::scoped_refptr<webrtc::PeerConnectionInterface> rtc_peerconnection_;
   std::vector<scoped_refptr<RTCAudioTrack>> audio_tracks_;
   std::vector<scoped_refptr<RTCVideoTrack>> video_tracks_;
@@ -3,17 +3,30 @@
 #include "api/audio_codecs/builtin_audio_decoder_factory.h"
 #include "api/audio_codecs/builtin_audio_encoder_factory.h"
 #include "api/create_peerconnection_factory.h"
+#include "api/enable_media.h"
 #include "api/media_stream_interface.h"
+#include "api/rtc_event_log/rtc_event_log_factory.h"
 #include "api/video_codecs/builtin_video_decoder_factory.h"
 #include "api/video_codecs/builtin_video_encoder_factory.h"
 #include "modules/audio_device/audio_device_impl.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_active_speaker_detector_impl.h"
+#include "rtc_audio_mixer_impl.h"
 #include "rtc_audio_source_impl.h"
+#include "rtc_encoded_video_source_impl.h"
 #include "rtc_media_stream_impl.h"
 #include "rtc_mediaconstraints_impl.h"
 #include "rtc_peerconnection_impl.h"
 #include "rtc_rtp_capabilities_impl.h"
+#include "rtc_rtp_receiver_impl.h"
 #include "rtc_video_device_impl.h"
+#include "rtc_video_relay_impl.h"
 #include "rtc_video_source_impl.h"
+#include "src/internal/external_video_codec.h"
+#include "src/internal/opus_tuning.h"
+#include "src/internal/passthrough_video_encoder.h"
+#include "src/internal/virtual_audio_device_module.h"
+#include "src/internal/wav_file_audio_source.h"
 #if defined(USE_INTEL_MEDIA_SDK)
 #include "src/win/mediacapabilities.h"
 #include "src/win/msdkvideodecoderfactory.h"
@@ -44,7 +57,15 @@ std::unique_ptr<webrtc::VideoDecoderFactory> CreateIntelVideoDecoderFactory() {
 
 RTCPeerConnectionFactoryImpl::RTCPeerConnectionFactoryImpl() {}
 
-RTCPeerConnectionFactoryImpl::~RTCPeerConnectionFactoryImpl() {}
+RTCPeerConnectionFactoryImpl::RTCPeerConnectionFactoryImpl(
+    const RTCPeerConnectionFactoryOptions& options)
+    : options_(options) {}
+
+RTCPeerConnectionFactoryImpl::~RTCPeerConnectionFactoryImpl() {
+  if (event_dispatcher_) {
+    event_dispatcher_->Stop();
+  }
+}
 
 bool RTCPeerConnectionFactoryImpl::Initialize() {
   worker_thread_ = rtc::Thread::Create();
@@ -54,6 +75,8 @@ bool RTCPeerConnectionFactoryImpl::Initialize() {
   signaling_thread_ = rtc::Thread::Create();
   signaling_thread_->SetName("signaling_thread", nullptr);
   RTC_CHECK(signaling_thread_->Start()) << "Failed to start thread";
+  event_dispatcher_ = rtc::scoped_refptr<EventDispatcher>(
+      new EventDispatcher(signaling_thread_.get()));
 
   network_thread_ = rtc::Thread::CreateWithSocketServer();
   network_thread_->SetName("network_thread", nullptr);
@@ -64,17 +87,30 @@ bool RTCPeerConnectionFactoryImpl::Initialize() {
   }
 
   if (!rtc_peerconnection_factory_) {
-    rtc_peerconnection_factory_ = webrtc::CreatePeerConnectionFactory(
-        network_thread_.get(), worker_thread_.get(), signaling_thread_.get(),
-        audio_device_module_, webrtc::CreateBuiltinAudioEncoderFactory(),
-        webrtc::CreateBuiltinAudioDecoderFactory(),
-#if defined(USE_INTEL_MEDIA_SDK)
-        CreateIntelVideoEncoderFactory(), CreateIntelVideoDecoderFactory(),
-#else
-        webrtc::CreateBuiltinVideoEncoderFactory(),
-        webrtc::CreateBuiltinVideoDecoderFactory(),
-#endif
-        nullptr, nullptr);
+    // Built by hand rather than with webrtc::CreatePeerConnectionFactory(),
+    // which always creates an APM.
+    webrtc::PeerConnectionFactoryDependencies dependencies;
+    dependencies.network_thread = network_thread_.get();
+    dependencies.worker_thread = worker_thread_.get();
+    dependencies.signaling_thread = signaling_thread_.get();
+    dependencies.socket_factory = network_thread_->socketserver();
+    dependencies.task_queue_factory = webrtc::CreateDefaultTaskQueueFactory();
+    dependencies.event_log_factory =
+        std::make_unique<webrtc::RtcEventLogFactory>();
+    dependencies.adm = audio_device_module_;
+    dependencies.audio_encoder_factory =
+        rtc::make_ref_counted<OpusTuningEncoderFactory>(
+            webrtc::CreateBuiltinAudioEncoderFactory());
+    dependencies.audio_decoder_factory =
+        webrtc::CreateBuiltinAudioDecoderFactory();
+    dependencies.audio_processing = CreateAudioProcessing();
+    dependencies.video_encoder_factory =
+        std::make_unique<PassthroughVideoEncoderFactory>(
+            CreateVideoEncoderFactory(), options_.video_encoder_cpu);
+    dependencies.video_decoder_factory = CreateVideoDecoderFactory();
+    webrtc::EnableMedia(dependencies);
+    rtc_peerconnection_factory_ =
+        webrtc::CreateModularPeerConnectionFactory(std::move(dependencies));
   }
 
   if (!rtc_peerconnection_factory_.get()) {
@@ -86,6 +122,9 @@ bool RTCPeerConnectionFactoryImpl::Initialize() {
 }
 
 bool RTCPeerConnectionFactoryImpl::Terminate() {
+  if (event_dispatcher_) {
+    event_dispatcher_->Stop();
+  }
   worker_thread_->BlockingCall([&] {
     audio_device_impl_ = nullptr;
     video_device_impl_ = nullptr;
@@ -98,11 +137,64 @@ bool RTCPeerConnectionFactoryImpl::Terminate() {
   return true;
 }
 
+void RTCPeerConnectionFactoryImpl::SetEventExecutor(
+    RTCEventExecutor* executor) {
+  event_dispatcher_->SetExecutor(executor);
+}
+
 void RTCPeerConnectionFactoryImpl::CreateAudioDeviceModule_w() {
-  if (!audio_device_module_)
+  if (audio_device_module_) return;
+  if (options_.audio_device == RTCAudioDeviceType::kVirtual) {
+    audio_device_module_ = rtc::make_ref_counted<VirtualAudioDeviceModule>(
+        task_queue_factory_.get(), options_.playout_sink,
+        options_.playout_sample_rate_hz, options_.playout_channels,
+        options_.virtual_record_silence);
+  } else {
     audio_device_module_ = webrtc::AudioDeviceModule::Create(
         webrtc::AudioDeviceModule::kPlatformDefaultAudio,
         task_queue_factory_.get());
+  }
+}
+
+std::unique_ptr<webrtc::VideoEncoderFactory>
+RTCPeerConnectionFactoryImpl::CreateVideoEncoderFactory() {
+  if (options_.video_encoder_factory) {
+    return std::make_unique<ExternalVideoEncoderFactory>(
+        options_.video_encoder_factory);
+  }
+#if defined(USE_INTEL_MEDIA_SDK)
+  return CreateIntelVideoEncoderFactory();
+#else
+  return webrtc::CreateBuiltinVideoEncoderFactory();
+#endif
+}
+
+std::unique_ptr<webrtc::VideoDecoderFactory>
+RTCPeerConnectionFactoryImpl::CreateVideoDecoderFactory() {
+  if (options_.video_decoder_factory) {
+    return std::make_unique<ExternalVideoDecoderFactory>(
+        options_.video_decoder_factory);
+  }
+#if defined(USE_INTEL_MEDIA_SDK)
+  return CreateIntelVideoDecoderFactory();
+#else
+  return webrtc::CreateBuiltinVideoDecoderFactory();
+#endif
+}
+
+rtc::scoped_refptr<webrtc::AudioProcessing>
+RTCPeerConnectionFactoryImpl::CreateAudioProcessing() {
+  const RTCAudioProcessingConfig& config = options_.audio_processing;
+  if (!config.enabled) {
+    RTC_LOG(LS_INFO) << "Audio processing disabled.";
+    return nullptr;
+  }
+  webrtc::AudioProcessing::Config apm_config;
+  apm_config.echo_canceller.enabled = config.echo_cancellation;
+  apm_config.noise_suppression.enabled = config.noise_suppression;
+  apm_config.gain_controller1.enabled = config.auto_gain_control;
+  apm_config.high_pass_filter.enabled = config.high_pass_filter;
+  return webrtc::AudioProcessingBuilder().SetConfig(apm_config).Create();
 }
 
 void RTCPeerConnectionFactoryImpl::DestroyAudioDeviceModule_w() {
@@ -115,7 +207,8 @@ scoped_refptr<RTCPeerConnection> RTCPeerConnectionFactoryImpl::Create(
   scoped_refptr<RTCPeerConnection> peerconnection =
       scoped_refptr<RTCPeerConnectionImpl>(
           new RefCountedObject<RTCPeerConnectionImpl>(
-              configuration, constraints, rtc_peerconnection_factory_));
+              configuration, constraints, rtc_peerconnection_factory_,
+              event_dispatcher_));
   peerconnections_.push_back(peerconnection);
   return peerconnection;
 }
@@ -154,20 +247,112 @@ scoped_refptr<RTCVideoDevice> RTCPeerConnectionFactoryImpl::GetVideoDevice() {
 
 scoped_refptr<RTCAudioSource> RTCPeerConnectionFactoryImpl::CreateAudioSource(
     const string audio_source_label) {
+  return CreateAudioSource(audio_source_label, options_.audio_processing);
+}
+
+scoped_refptr<RTCAudioSource> RTCPeerConnectionFactoryImpl::CreateAudioSource(
+    const string audio_source_label, const RTCAudioProcessingConfig& config) {
+  // The voice engine applies these to the shared APM when a send stream
+  // starts, so they are set explicitly rather than left to engine defaults.
+  cricket::AudioOptions options;
+  options.echo_cancellation = config.enabled && config.echo_cancellation;
+  options.noise_suppression = config.enabled && config.noise_suppression;
+  options.auto_gain_control = config.enabled && config.auto_gain_control;
+  options.highpass_filter = config.enabled && config.high_pass_filter;
   rtc::scoped_refptr<webrtc::AudioSourceInterface> rtc_source_track =
-      rtc_peerconnection_factory_->CreateAudioSource(cricket::AudioOptions());
+      rtc_peerconnection_factory_->CreateAudioSource(options);
 
   scoped_refptr<RTCAudioSourceImpl> source = scoped_refptr<RTCAudioSourceImpl>(
       new RefCountedObject<RTCAudioSourceImpl>(rtc_source_track));
   return source;
 }
 
+scoped_refptr<RTCAudioSource>
+RTCPeerConnectionFactoryImpl::CreateCustomAudioSource(
+    const string audio_source_label) {
+  rtc::scoped_refptr<CustomAudioSource> rtc_source =
+      rtc::make_ref_counted<CustomAudioSource>();
+
+  scoped_refptr<RTCAudioSourceImpl> source = scoped_refptr<RTCAudioSourceImpl>(
+      new RefCountedObject<RTCAudioSourceImpl>(rtc_source));
+  return source;
+}
+
+scoped_refptr<RTCAudioSource>
+RTCPeerConnectionFactoryImpl::CreateWavFileAudioSource(
+    const string audio_source_label, const string wav_path, bool loop) {
+  rtc::scoped_refptr<WavFileAudioSource> rtc_source =
+      WavFileAudioSource::Create(task_queue_factory_.get(),
+                                 wav_path.std_string(), loop);
+  if (!rtc_source) {
+    return nullptr;
+  }
+
+  scoped_refptr<RTCAudioSourceImpl> source = scoped_refptr<RTCAudioSourceImpl>(
+      new RefCountedObject<RTCAudioSourceImpl>(
+          rtc::scoped_refptr<CustomAudioSource>(rtc_source)));
+  return source;
+}
+
+scoped_refptr<RTCEncodedVideoSource>
+RTCPeerConnectionFactoryImpl::CreateEncodedVideoSource(
+    RTCVideoCodecType codec, const string video_source_label) {
+  rtc::scoped_refptr<EncodedVideoTrackSource> rtc_source =
+      EncodedVideoTrackSource::Create(ToWebrtcCodecType(codec));
+  if (!rtc_source) {
+    return nullptr;
+  }
+  scoped_refptr<RTCEncodedVideoSourceImpl> source =
+      scoped_refptr<RTCEncodedVideoSourceImpl>(
+          new RefCountedObject<RTCEncodedVideoSourceImpl>(codec, rtc_source));
+  return source;
+}
+
+scoped_refptr<RTCVideoRelay> RTCPeerConnectionFactoryImpl::CreateVideoRelay(
+    scoped_refptr<RTCRtpReceiver> receiver, RTCVideoCodecType codec,
+    int min_key_frame_request_interval_ms) {
+  rtc::scoped_refptr<webrtc::MediaStreamTrackInterface> track =
+      static_cast<RTCRtpReceiverImpl*>(receiver.get())->rtp_receiver()->track();
+  if (!track ||
+      track->kind() != webrtc::MediaStreamTrackInterface::kVideoKind) {
+    return nullptr;
+  }
+  rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> upstream(
+      static_cast<webrtc::VideoTrackInterface*>(track.get())->GetSource());
+  scoped_refptr<RTCVideoRelayImpl> relay = scoped_refptr<RTCVideoRelayImpl>(
+      new RefCountedObject<RTCVideoRelayImpl>(
+          rtc_peerconnection_factory_, signaling_thread_.get(), upstream,
+          ToWebrtcCodecType(codec), min_key_frame_request_interval_ms));
+  return relay;
+}
+
+scoped_refptr<RTCAudioMixer> RTCPeerConnectionFactoryImpl::CreateAudioMixer(
+    RTCAudioTrackSink* output, int sample_rate_hz, size_t num_channels,
+    size_t max_mixed_sources) {
+  scoped_refptr<RTCAudioMixerImpl> mixer = scoped_refptr<RTCAudioMixerImpl>(
+      new RefCountedObject<RTCAudioMixerImpl>(task_queue_factory_.get(),
+                                              output, sample_rate_hz,
+                                              num_channels, max_mixed_sources));
+  return mixer;
+}
+
+scoped_refptr<RTCActiveSpeakerDetector>
+RTCPeerConnectionFactoryImpl::CreateActiveSpeakerDetector(
+    RTCActiveSpeakerObserver* observer, size_t max_speakers, int interval_ms) {
+  scoped_refptr<RTCActiveSpeakerDetectorImpl> detector =
+      scoped_refptr<RTCActiveSpeakerDetectorImpl>(
+          new RefCountedObject<RTCActiveSpeakerDetectorImpl>(
+              task_queue_factory_.get(), event_dispatcher_, observer,
+              max_speakers, interval_ms));
+  return detector;
+}
+
 #ifdef RTC_DESKTOP_DEVICE
 scoped_refptr<RTCDesktopDevice>
 RTCPeerConnectionFactoryImpl::GetDesktopDevice() {
   if (!desktop_device_impl_) {
     desktop_device_impl_ = scoped_refptr<RTCDesktopDeviceImpl>(
-        new RefCountedObject<RTCDesktopDeviceImpl>(signaling_thread_.get()));
+        new RefCountedObject<RTCDesktopDeviceImpl>(event_dispatcher_));
   }
   return desktop_device_impl_;
 }
@@ -244,7 +429,7 @@ scoped_refptr<RTCMediaStream> RTCPeerConnectionFactoryImpl::CreateStream(
           to_std_string(stream_id));
 
   scoped_refptr<MediaStreamImpl> stream = scoped_refptr<MediaStreamImpl>(
-      new RefCountedObject<MediaStreamImpl>(rtc_stream));
+      new RefCountedObject<MediaStreamImpl>(rtc_stream, event_dispatcher_));
 
   return stream;
 }
@@ -282,7 +467,7 @@ scoped_refptr<RTCAudioTrack> RTCPeerConnectionFactoryImpl::CreateAudioTrack(
           to_std_string(track_id), source_impl->rtc_audio_source().get()));
 
   scoped_refptr<AudioTrackImpl> track = scoped_refptr<AudioTrackImpl>(
-      new RefCountedObject<AudioTrackImpl>(audio_track));
+      new RefCountedObject<AudioTrackImpl>(audio_track, event_dispatcher_));
   return track;
 }
 
@@ -6,11 +6,13 @@
 #include "api/media_stream_interface.h"
 #include "api/peer_connection_interface.h"
 #include "api/task_queue/task_queue_factory.h"
+#include "modules/audio_processing/include/audio_processing.h"
 #include "rtc_audio_device_impl.h"
 #include "rtc_base/thread.h"
 #include "rtc_peerconnection.h"
 #include "rtc_peerconnection_factory.h"
 #include "rtc_video_device_impl.h"
+#include "src/internal/event_dispatcher.h"
 
 #ifdef RTC_DESKTOP_DEVICE
 #include "rtc_desktop_capturer_impl.h"
@@ -24,12 +26,17 @@ class RTCPeerConnectionFactoryImpl : public RTCPeerConnectionFactory {
  public:
   RTCPeerConnectionFactoryImpl();
 
+  explicit RTCPeerConnectionFactoryImpl(
+      const RTCPeerConnectionFactoryOptions& options);
+
   virtual ~RTCPeerConnectionFactoryImpl();
 
   bool Initialize() override;
 
   bool Terminate() override;
 
+  void SetEventExecutor(RTCEventExecutor* executor) override;
+
   scoped_refptr<RTCPeerConnection> Create(
       const RTCConfiguration& configuration,
       scoped_refptr<RTCMediaConstraints> constraints) override;
@@ -43,9 +50,35 @@ class RTCPeerConnectionFactoryImpl : public RTCPeerConnectionFactory {
   virtual scoped_refptr<RTCAudioSource> CreateAudioSource(
       const string audio_source_label) override;
 
+  virtual scoped_refptr<RTCAudioSource> CreateAudioSource(
+      const string audio_source_label,
+      const RTCAudioProcessingConfig& config) override;
+
+  virtual scoped_refptr<RTCAudioSource> CreateCustomAudioSource(
+      const string audio_source_label) override;
+
+  virtual scoped_refptr<RTCAudioSource> CreateWavFileAudioSource(
+      const string audio_source_label, const string wav_path,
+      bool loop) override;
+
   virtual scoped_refptr<RTCVideoSource> CreateVideoSource(
       scoped_refptr<RTCVideoCapturer> capturer, const string video_source_label,
       scoped_refptr<RTCMediaConstraints> constraints) override;
+
+  virtual scoped_refptr<RTCEncodedVideoSource> CreateEncodedVideoSource(
+      RTCVideoCodecType codec, const string video_source_label) override;
+
+  virtual scoped_refptr<RTCVideoRelay> CreateVideoRelay(
+      scoped_refptr<RTCRtpReceiver> receiver, RTCVideoCodecType codec,
+      int min_key_frame_request_interval_ms) override;
+
+  virtual scoped_refptr<RTCAudioMixer> CreateAudioMixer(
+      RTCAudioTrackSink* output, int sample_rate_hz, size_t num_channels,
+      size_t max_mixed_sources) override;
+
+  virtual scoped_refptr<RTCActiveSpeakerDetector> CreateActiveSpeakerDetector(
+      RTCActiveSpeakerObserver* observer, size_t max_speakers,
+      int interval_ms) override;
 #ifdef RTC_DESKTOP_DEVICE
   virtual scoped_refptr<RTCDesktopDevice> GetDesktopDevice() override;
   virtual scoped_refptr<RTCVideoSource> CreateDesktopSource(
@@ -80,6 +113,14 @@ class RTCPeerConnectionFactoryImpl : public RTCPeerConnectionFactory {
 
   void DestroyAudioDeviceModule_w();
 
+  // The application's codec factories from |options_|, else the built-in
+  // (or Intel Media SDK) codecs.
+  std::unique_ptr<webrtc::VideoEncoderFactory> CreateVideoEncoderFactory();
+  std::unique_ptr<webrtc::VideoDecoderFactory> CreateVideoDecoderFactory();
+
+  // Returns null when |options_| disable audio processing.
+  rtc::scoped_refptr<webrtc::AudioProcessing> CreateAudioProcessing();
+
   scoped_refptr<RTCVideoSource> CreateVideoSource_s(
       scoped_refptr<RTCVideoCapturer> capturer, const char* video_source_label,
       scoped_refptr<RTCMediaConstraints> constraints);
@@ -90,9 +131,11 @@ class RTCPeerConnectionFactoryImpl : public RTCPeerConnectionFactory {
       scoped_refptr<RTCMediaConstraints> constraints);
 #endif
  private:
+  const RTCPeerConnectionFactoryOptions options_;
   std::unique_ptr<rtc::Thread> worker_thread_;
   std::unique_ptr<rtc::Thread> signaling_thread_;
   std::unique_ptr<rtc::Thread> network_thread_;
+  rtc::scoped_refptr<EventDispatcher> event_dispatcher_;
   rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface>
       rtc_peerconnection_factory_;
   rtc::scoped_refptr<webrtc::AudioDeviceModule> audio_device_module_;
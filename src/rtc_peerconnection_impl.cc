@@ -1,5 +1,6 @@
 #include "rtc_peerconnection_impl.h"
 
+#include <algorithm>
 #include <functional>
 #include <utility>
 #include <vector>
@@ -14,6 +15,9 @@
 #include "rtc_rtp_receiver_impl.h"
 #include "rtc_rtp_sender_impl.h"
 #include "rtc_rtp_transceiver_impl.h"
+#include "src/internal/opus_tuning.h"
+#include "src/internal/video_adaptation_monitor.h"
+#include "src/internal/video_encoder_tuning.h"
 
 using rtc::Thread;
 
@@ -186,8 +190,11 @@ RTCPeerConnectionImpl::RTCPeerConnectionImpl(
     const RTCConfiguration& configuration,
     scoped_refptr<RTCMediaConstraints> constraints,
     rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface>
-        peer_connection_factory)
+        peer_connection_factory,
+    rtc::scoped_refptr<EventDispatcher> event_dispatcher)
     : rtc_peerconnection_factory_(peer_connection_factory),
+      event_dispatcher_(event_dispatcher),
+      rtp_state_(rtc::make_ref_counted<RtpStateStore>(event_dispatcher)),
       configuration_(configuration),
       constraints_(constraints),
       callback_crt_sec_(new webrtc::Mutex()) {
@@ -207,10 +214,11 @@ void RTCPeerConnectionImpl::OnAddTrack(
   if (nullptr != observer_) {
     std::vector<scoped_refptr<RTCMediaStream>> out_streams;
     for (auto item : streams) {
-      out_streams.push_back(new RefCountedObject<MediaStreamImpl>(item));
+      out_streams.push_back(
+          new RefCountedObject<MediaStreamImpl>(item, event_dispatcher_));
     }
     scoped_refptr<RTCRtpReceiver> rtc_receiver =
-        new RefCountedObject<RTCRtpReceiverImpl>(receiver);
+        new RefCountedObject<RTCRtpReceiverImpl>(receiver, rtp_state_);
     observer_->OnAddTrack(out_streams, rtc_receiver);
   }
 }
@@ -219,7 +227,7 @@ void RTCPeerConnectionImpl::OnTrack(
     rtc::scoped_refptr<webrtc::RtpTransceiverInterface> transceiver) {
   if (nullptr != observer_) {
     observer_->OnTrack(
-        new RefCountedObject<RTCRtpTransceiverImpl>(transceiver));
+        new RefCountedObject<RTCRtpTransceiverImpl>(transceiver, rtp_state_));
   }
 }
 
@@ -227,7 +235,7 @@ void RTCPeerConnectionImpl::OnRemoveTrack(
     rtc::scoped_refptr<webrtc::RtpReceiverInterface> receiver) {
   if (nullptr != observer_) {
     observer_->OnRemoveTrack(
-        new RefCountedObject<RTCRtpReceiverImpl>(receiver));
+        new RefCountedObject<RTCRtpReceiverImpl>(receiver, rtp_state_));
   }
 }
 
@@ -237,7 +245,7 @@ void RTCPeerConnectionImpl::OnAddStream(
   RTC_LOG(LS_INFO) << __FUNCTION__ << " " << stream->id();
 
   scoped_refptr<MediaStreamImpl> remote_stream = scoped_refptr<MediaStreamImpl>(
-      new RefCountedObject<MediaStreamImpl>(stream));
+      new RefCountedObject<MediaStreamImpl>(stream, event_dispatcher_));
 
   remote_stream->RegisterRTCPeerConnectionObserver(observer_);
 
@@ -306,6 +314,29 @@ void RTCPeerConnectionImpl::OnIceConnectionChange(
 void RTCPeerConnectionImpl::OnSignalingChange(
     webrtc::PeerConnectionInterface::SignalingState new_state) {
   if (observer_) observer_->OnSignalingState(signaling_state_map[new_state]);
+  if (new_state == webrtc::PeerConnectionInterface::kStable &&
+      rtc_peerconnection_.get()) {
+    // Stopped transceivers are removed while an answer is applied, which is
+    // still running; prune once it is done.
+    rtc::scoped_refptr<RtpStateStore> store = rtp_state_;
+    rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection =
+        rtc_peerconnection_;
+    event_dispatcher_->signaling_thread()->PostTask(
+        [store, peer_connection] { PruneRtpState(store, peer_connection); });
+  }
+}
+
+void RTCPeerConnectionImpl::PruneRtpState(
+    rtc::scoped_refptr<RtpStateStore> store,
+    rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection) {
+  std::vector<const void*> live;
+  for (const auto& sender : peer_connection->GetSenders()) {
+    live.push_back(sender.get());
+  }
+  for (const auto& receiver : peer_connection->GetReceivers()) {
+    live.push_back(receiver.get());
+  }
+  store->Prune(live);
 }
 
 void RTCPeerConnectionImpl::AddCandidate(const string mid, int mid_mline_index,
@@ -407,6 +438,13 @@ bool RTCPeerConnectionImpl::Initialize() {
   if (configuration_.screencast_min_bitrate > 0)
     config.screencast_min_bitrate = configuration_.screencast_min_bitrate;
 
+  const RTCAudioLatencyProfile& latency = configuration_.audio_latency;
+  if (latency.max_packets > 0) {
+    config.audio_jitter_buffer_max_packets = latency.max_packets;
+  }
+  config.audio_jitter_buffer_fast_accelerate = latency.fast_accelerate;
+  config.audio_jitter_buffer_min_delay_ms = std::max(0, latency.min_delay_ms);
+
   RTCMediaConstraintsImpl* media_constraints =
       static_cast<RTCMediaConstraintsImpl*>(constraints_.get());
   webrtc::MediaConstraints rtc_constraints(media_constraints->GetMandatory(),
@@ -430,9 +468,26 @@ bool RTCPeerConnectionImpl::Initialize() {
   }
 
   rtc_peerconnection_ = result.MoveValue();
+
+  if (configuration_.cpu_overuse.high_threshold_percent > 0) {
+    cpu_usage_sampler_ =
+        std::make_unique<CpuUsageSampler>(configuration_.cpu_overuse);
+    rtc_peerconnection_->AddAdaptationResource(
+        cpu_usage_sampler_->resource());
+  }
   return true;
 }
 
+void RTCPeerConnectionImpl::SetVideoAdaptationObserver(
+    RTCVideoAdaptationObserver* observer, int interval_ms) {
+  adaptation_monitor_ = nullptr;
+  if (observer && rtc_peerconnection_.get()) {
+    adaptation_monitor_ = std::make_unique<VideoAdaptationMonitor>(
+        rtc_peerconnection_, event_dispatcher_, rtp_state_, observer,
+        interval_ms);
+  }
+}
+
 scoped_refptr<RTCDataChannel> RTCPeerConnectionImpl::CreateDataChannel(
     const string label, RTCDataChannelInit* dataChannelDict) {
   webrtc::DataChannelInit init;
@@ -509,6 +564,8 @@ void RTCPeerConnectionImpl::SetRemoteDescription(const string sdp,
     media_content_desc->set_bandwidth(configuration_.local_video_bandwidth *
                                       1000);
 
+  ApplySenderSettings(session_description->description());
+
   rtc_peerconnection_->SetRemoteDescription(
       SetSessionDescriptionObserverProxy::Create(success, failure),
       session_description);
@@ -516,6 +573,51 @@ void RTCPeerConnectionImpl::SetRemoteDescription(const string sdp,
   return;
 }
 
+void RTCPeerConnectionImpl::ApplySenderSettings(
+    cricket::SessionDescription* description) {
+  auto transceivers = rtc_peerconnection_->GetTransceivers();
+  // Sections whose mid is not known yet go to unassociated transceivers of
+  // the same kind in order, the way webrtc pairs them.
+  std::set<webrtc::RtpTransceiverInterface*> used;
+  for (cricket::ContentInfo& content : description->contents()) {
+    cricket::MediaContentDescription* media = content.media_description();
+    if (!media || (media->type() != cricket::MEDIA_TYPE_AUDIO &&
+                   media->type() != cricket::MEDIA_TYPE_VIDEO)) {
+      continue;
+    }
+    webrtc::RtpTransceiverInterface* match = nullptr;
+    for (const auto& transceiver : transceivers) {
+      if (transceiver->mid() == content.name) {
+        match = transceiver.get();
+        break;
+      }
+    }
+    if (!match) {
+      for (const auto& transceiver : transceivers) {
+        if (!transceiver->mid() && !used.count(transceiver.get()) &&
+            transceiver->media_type() == media->type()) {
+          match = transceiver.get();
+          break;
+        }
+      }
+    }
+    if (!match) {
+      continue;
+    }
+    used.insert(match);
+    SenderSettings settings =
+        rtp_state_->GetSenderSettings(match->sender().get());
+    if (settings.has_opus_settings &&
+        media->type() == cricket::MEDIA_TYPE_AUDIO) {
+      ApplyOpusSettings(settings.opus, media);
+    }
+    if (settings.has_video_encoder_cpu_settings &&
+        media->type() == cricket::MEDIA_TYPE_VIDEO) {
+      ApplyVideoEncoderCpuSettings(settings.video_encoder_cpu, media);
+    }
+  }
+}
+
 void RTCPeerConnectionImpl::GetLocalDescription(OnGetSdpSuccess success,
                                                 OnGetSdpFailure failure) {
   auto local_description = rtc_peerconnection_->local_description();
@@ -606,6 +708,9 @@ void RTCPeerConnectionImpl::RestartIce() {
 
 void RTCPeerConnectionImpl::Close() {
   RTC_LOG(LS_INFO) << __FUNCTION__;
+  adaptation_monitor_ = nullptr;
+  cpu_usage_sampler_ = nullptr;
+  rtp_state_->Clear();
   if (rtc_peerconnection_.get()) {
     rtc_peerconnection_ = nullptr;
     data_channel_ = nullptr;
@@ -670,7 +775,8 @@ scoped_refptr<RTCMediaStream> RTCPeerConnectionImpl::CreateLocalMediaStream(
   }
   auto stream =
       rtc_peerconnection_factory_->CreateLocalMediaStream(stream_id.c_string());
-  auto rtc_stream = new RefCountedObject<MediaStreamImpl>(stream);
+  auto rtc_stream =
+      new RefCountedObject<MediaStreamImpl>(stream, event_dispatcher_);
   local_streams_.push_back(rtc_stream);
   return rtc_stream;
 }
@@ -737,7 +843,8 @@ scoped_refptr<RTCRtpTransceiver> RTCPeerConnectionImpl::AddTransceiver(
   }
 
   if (errorOr.ok()) {
-    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value());
+    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value(),
+                                                     rtp_state_);
   }
 
   return scoped_refptr<RTCRtpTransceiver>();
@@ -757,7 +864,8 @@ scoped_refptr<RTCRtpTransceiver> RTCPeerConnectionImpl::AddTransceiver(
   }
 
   if (errorOr.ok()) {
-    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value());
+    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value(),
+                                                     rtp_state_);
   }
   // onAdd(scoped_refptr<RTCRtpTransceiver>(), errorOr.error().message());
   return scoped_refptr<RTCRtpTransceiver>();
@@ -775,7 +883,8 @@ scoped_refptr<RTCRtpTransceiver> RTCPeerConnectionImpl::AddTransceiver(
         cricket::MediaType::MEDIA_TYPE_VIDEO);
   }
   if (errorOr.ok()) {
-    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value());
+    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value(),
+                                                     rtp_state_);
   }
   // onAdd(scoped_refptr<RTCRtpTransceiver>(), errorOr.error().message());
   return scoped_refptr<RTCRtpTransceiver>();
@@ -795,7 +904,8 @@ scoped_refptr<RTCRtpTransceiver> RTCPeerConnectionImpl::AddTransceiver(
         cricket::MediaType::MEDIA_TYPE_VIDEO, initImpl->rtp_transceiver_init());
   }
   if (errorOr.ok()) {
-    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value());
+    return new RefCountedObject<RTCRtpTransceiverImpl>(errorOr.value(),
+                                                     rtp_state_);
   }
   // onAdd(scoped_refptr<RTCRtpTransceiver>(), errorOr.error().message());
   return scoped_refptr<RTCRtpTransceiver>();
@@ -819,7 +929,7 @@ scoped_refptr<RTCRtpSender> RTCPeerConnectionImpl::AddTrack(
   }
 
   if (errorOr.ok()) {
-    return new RefCountedObject<RTCRtpSenderImpl>(errorOr.value());
+    return new RefCountedObject<RTCRtpSenderImpl>(errorOr.value(), rtp_state_);
   }
 
   // onAdd(scoped_refptr<RTCRtpSender>(), errorOr.error().message());
@@ -831,6 +941,8 @@ bool RTCPeerConnectionImpl::RemoveTrack(scoped_refptr<RTCRtpSender> render) {
   webrtc::RTCError err =
       rtc_peerconnection_->RemoveTrackOrError(impl->rtc_rtp_sender());
   if (err.ok()) {
+    // With Plan B the sender is gone now.
+    PruneRtpState(rtp_state_, rtc_peerconnection_);
     return true;
   }
   return false;
@@ -839,7 +951,7 @@ bool RTCPeerConnectionImpl::RemoveTrack(scoped_refptr<RTCRtpSender> render) {
 vector<scoped_refptr<RTCRtpSender>> RTCPeerConnectionImpl::senders() {
   std::vector<scoped_refptr<RTCRtpSender>> vec;
   for (auto item : rtc_peerconnection_->GetSenders()) {
-    vec.push_back(new RefCountedObject<RTCRtpSenderImpl>(item));
+    vec.push_back(new RefCountedObject<RTCRtpSenderImpl>(item, rtp_state_));
   }
   return vec;
 }
@@ -847,7 +959,8 @@ vector<scoped_refptr<RTCRtpSender>> RTCPeerConnectionImpl::senders() {
 vector<scoped_refptr<RTCRtpTransceiver>> RTCPeerConnectionImpl::transceivers() {
   std::vector<scoped_refptr<RTCRtpTransceiver>> vec;
   for (auto item : rtc_peerconnection_->GetTransceivers()) {
-    vec.push_back(new RefCountedObject<RTCRtpTransceiverImpl>(item));
+    vec.push_back(
+        new RefCountedObject<RTCRtpTransceiverImpl>(item, rtp_state_));
   }
   return vec;
 }
@@ -855,7 +968,7 @@ vector<scoped_refptr<RTCRtpTransceiver>> RTCPeerConnectionImpl::transceivers() {
 vector<scoped_refptr<RTCRtpReceiver>> RTCPeerConnectionImpl::receivers() {
   std::vector<scoped_refptr<RTCRtpReceiver>> vec;
   for (auto item : rtc_peerconnection_->GetReceivers()) {
-    vec.push_back(new RefCountedObject<RTCRtpReceiverImpl>(item));
+    vec.push_back(new RefCountedObject<RTCRtpReceiverImpl>(item, rtp_state_));
   }
   return vec;
 }
@@ -3,6 +3,7 @@
 
 #include <deque>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -19,6 +20,10 @@
 #include "rtc_video_source.h"
 #include "rtc_video_source_impl.h"
 #include "rtc_video_track_impl.h"
+#include "src/internal/cpu_usage_resource.h"
+#include "src/internal/event_dispatcher.h"
+#include "src/internal/rtp_state_store.h"
+#include "src/internal/video_adaptation_monitor.h"
 #include "src/internal/video_capturer.h"
 
 namespace webrtc {
@@ -135,16 +140,30 @@ class RTCPeerConnectionImpl : public RTCPeerConnection,
   virtual void GetStats(OnStatsCollectorSuccess success,
                         OnStatsCollectorFailure failure) override;
 
+  virtual void SetVideoAdaptationObserver(RTCVideoAdaptationObserver* observer,
+                                          int interval_ms) override;
+
  public:
   RTCPeerConnectionImpl(
       const RTCConfiguration& configuration,
       scoped_refptr<RTCMediaConstraints> constraints,
       rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface>
-          peer_connection_factory);
+          peer_connection_factory,
+      rtc::scoped_refptr<EventDispatcher> event_dispatcher);
 
  protected:
   ~RTCPeerConnectionImpl();
 
+  // Applies per-sender settings (Opus tuning) to the matching sections of a
+  // remote description before it is set.
+  void ApplySenderSettings(cricket::SessionDescription* description);
+
+  // Drops the state of senders and receivers |peer_connection| no longer
+  // has.
+  static void PruneRtpState(
+      rtc::scoped_refptr<RtpStateStore> store,
+      rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection);
+
   virtual void OnAddTrack(
       rtc::scoped_refptr<webrtc::RtpReceiverInterface> receiver,
       const std::vector<rtc::scoped_refptr<webrtc::MediaStreamInterface>>&
@@ -185,6 +204,9 @@ class RTCPeerConnectionImpl : public RTCPeerConnection,
  protected:
   rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface>
       rtc_peerconnection_factory_;
+  rtc::scoped_refptr<EventDispatcher> event_dispatcher_;
+  // Shared with the sender and receiver wrappers created here.
+  rtc::scoped_refptr<RtpStateStore> rtp_state_;
   rtc::scoped_refptr<webrtc::PeerConnectionInterface> rtc_peerconnection_;
   const RTCConfiguration& configuration_;
   scoped_refptr<RTCMediaConstraints> constraints_;
@@ -195,6 +217,8 @@ class RTCPeerConnectionImpl : public RTCPeerConnection,
   std::vector<scoped_refptr<RTCMediaStream>> local_streams_;
   std::vector<scoped_refptr<RTCMediaStream>> remote_streams_;
   scoped_refptr<RTCDataChannel> data_channel_;
+  std::unique_ptr<VideoAdaptationMonitor> adaptation_monitor_;
+  std::unique_ptr<CpuUsageSampler> cpu_usage_sampler_;
 };
 
 }  // namespace libwebrtc
@@ -1,14 +1,118 @@
 #include "rtc_rtp_parameters_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/refcountedobject.h"
 
 namespace libwebrtc {
 
+namespace {
+
+const int kMaxLayers = 3;
+
+// Layers used for a source whose short side is |size|.
+int LayerCount(int size) {
+  if (size >= 720) return 3;
+  if (size >= 360) return 2;
+  return 1;
+}
+
+// The per-resolution max bitrates of webrtc's simulcast table
+// (media/engine/simulcast.cc), keyed by the short side of the layer.
+int LayerMaxBitrateBps(int size) {
+  if (size >= 1080) return 5000000;
+  if (size >= 720) return 2500000;
+  if (size >= 540) return 1200000;
+  if (size >= 360) return 700000;
+  if (size >= 270) return 450000;
+  return 200000;
+}
+
+// Max bitrates of |layers| layers, lowest resolution first, each half the
+// size of the next.
+std::vector<int> LayerBitrates(int size, int layers) {
+  std::vector<int> bitrates;
+  for (int i = layers - 1; i >= 0; --i) {
+    bitrates.push_back(LayerMaxBitrateBps(size >> i));
+  }
+  return bitrates;
+}
+
+int Sum(const std::vector<int>& values) {
+  int sum = 0;
+  for (int value : values) sum += value;
+  return sum;
+}
+
+// Drops top layers until the rest fit |max_bitrate_bps|, keeping one.
+void FitBitrates(std::vector<int>* bitrates, int max_bitrate_bps) {
+  if (max_bitrate_bps <= 0) return;
+  while (bitrates->size() > 1 && Sum(*bitrates) > max_bitrate_bps) {
+    bitrates->pop_back();
+  }
+  if (bitrates->size() == 1) {
+    (*bitrates)[0] = std::min((*bitrates)[0], max_bitrate_bps);
+  }
+}
+
+scoped_refptr<RTCRtpEncodingParameters> CreateEncoding(
+    const char* scalability_mode, int max_bitrate_bps) {
+  scoped_refptr<RTCRtpEncodingParameters> encoding =
+      RTCRtpEncodingParameters::Create();
+  encoding->set_scalability_mode(scalability_mode);
+  encoding->set_max_bitrate_bps(max_bitrate_bps);
+  return encoding;
+}
+
+}  // namespace
+
 LIB_WEBRTC_API scoped_refptr<RTCRtpEncodingParameters>
 RTCRtpEncodingParameters::Create() {
   return new RefCountedObject<RTCRtpEncodingParametersImpl>();
 }
 
+LIB_WEBRTC_API vector<scoped_refptr<RTCRtpEncodingParameters>>
+RTCRtpEncodingParameters::CreatePreset(RTCVideoLayerPreset preset, int width,
+                                       int height, int max_bitrate_bps) {
+  const int size = std::min(width, height);
+  std::vector<scoped_refptr<RTCRtpEncodingParameters>> encodings;
+  switch (preset) {
+    case RTCVideoLayerPreset::kSingleLayer: {
+      std::vector<int> bitrates = LayerBitrates(size, 1);
+      FitBitrates(&bitrates, max_bitrate_bps);
+      encodings.push_back(CreateEncoding("L1T3", bitrates[0]));
+      break;
+    }
+    case RTCVideoLayerPreset::kSimulcastL1T3: {
+      static const char* const kRids[kMaxLayers] = {"q", "h", "f"};
+      const int layers = LayerCount(size);
+      const std::vector<int> all = LayerBitrates(size, layers);
+      std::vector<int> fitted = all;
+      FitBitrates(&fitted, max_bitrate_bps);
+      for (int i = 0; i < layers; ++i) {
+        const bool active = i < static_cast<int>(fitted.size());
+        scoped_refptr<RTCRtpEncodingParameters> encoding =
+            CreateEncoding("L1T3", active ? fitted[i] : all[i]);
+        encoding->set_rid(kRids[kMaxLayers - layers + i]);
+        encoding->set_scale_resolution_down_by(1 << (layers - 1 - i));
+        encoding->set_active(active);
+        encodings.push_back(encoding);
+      }
+      break;
+    }
+    case RTCVideoLayerPreset::kSvcL3T3: {
+      static const char* const kModes[kMaxLayers] = {"L1T3", "L2T3", "L3T3"};
+      std::vector<int> bitrates = LayerBitrates(size, LayerCount(size));
+      FitBitrates(&bitrates, max_bitrate_bps);
+      encodings.push_back(
+          CreateEncoding(kModes[bitrates.size() - 1], Sum(bitrates)));
+      break;
+    }
+  }
+  return encodings;
+}
+
 RTCRtpEncodingParametersImpl::RTCRtpEncodingParametersImpl() {}
 
 RTCRtpEncodingParametersImpl::RTCRtpEncodingParametersImpl(
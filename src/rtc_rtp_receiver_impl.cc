@@ -1,16 +1,20 @@
 #include "rtc_rtp_receiver_impl.h"
 
+#include <algorithm>
+
 #include "base/refcountedobject.h"
 #include "rtc_audio_track_impl.h"
 #include "rtc_dtls_transport_impl.h"
 #include "rtc_media_stream_impl.h"
 #include "rtc_rtp_parameters_impl.h"
 #include "rtc_video_track_impl.h"
+#include "src/internal/frame_transformer_adapter.h"
 
 namespace libwebrtc {
 RTCRtpReceiverImpl::RTCRtpReceiverImpl(
-    rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtp_receiver)
-    : rtp_receiver_(rtp_receiver), observer_(nullptr) {}
+    rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtp_receiver,
+    rtc::scoped_refptr<RtpStateStore> store)
+    : rtp_receiver_(rtp_receiver), store_(store), observer_(nullptr) {}
 
 rtc::scoped_refptr<webrtc::RtpReceiverInterface>
 RTCRtpReceiverImpl::rtp_receiver() {
@@ -36,7 +40,8 @@ scoped_refptr<RTCMediaTrack> RTCRtpReceiverImpl::track() const {
   } else if (track->kind() == webrtc::MediaStreamTrackInterface::kAudioKind) {
     return scoped_refptr<RTCMediaTrack>(new RefCountedObject<AudioTrackImpl>(
         rtc::scoped_refptr<webrtc::AudioTrackInterface>(
-            static_cast<webrtc::AudioTrackInterface*>(track.get()))));
+            static_cast<webrtc::AudioTrackInterface*>(track.get())),
+        store_ ? store_->dispatcher() : nullptr));
   }
   return scoped_refptr<RTCMediaTrack>();
 }
@@ -60,7 +65,8 @@ const vector<string> RTCRtpReceiverImpl::stream_ids() const {
 vector<scoped_refptr<RTCMediaStream>> RTCRtpReceiverImpl::streams() const {
   std::vector<scoped_refptr<RTCMediaStream>> streams;
   for (auto item : rtp_receiver_->streams()) {
-    streams.push_back(new RefCountedObject<MediaStreamImpl>(item));
+    streams.push_back(new RefCountedObject<MediaStreamImpl>(
+        item, store_ ? store_->dispatcher() : nullptr));
   }
   return streams;
 }
@@ -92,4 +98,82 @@ void RTCRtpReceiverImpl::SetJitterBufferMinimumDelay(double delay_seconds) {
   rtp_receiver_->SetJitterBufferMinimumDelay(delay_seconds);
 }
 
+bool RTCRtpReceiverImpl::SetAudioLatencyProfile(
+    const RTCAudioLatencyProfile& profile) {
+  if (rtp_receiver_->media_type() != cricket::MEDIA_TYPE_AUDIO) {
+    return false;
+  }
+  const int min_delay_ms = std::max(0, profile.min_delay_ms);
+  rtp_receiver_->SetJitterBufferMinimumDelay(min_delay_ms / 1000.0);
+  return true;
+}
+
+void RTCRtpReceiverImpl::SetFrameTransformer(
+    scoped_refptr<RTCFrameTransformer> transformer) {
+  rtp_receiver_->SetDepacketizerToDecoderFrameTransformer(
+      rtc::make_ref_counted<FrameTransformerAdapter>(transformer,
+                                                     media_type()));
+}
+
+bool RTCRtpReceiverImpl::RequestKeyFrame() {
+  if (rtp_receiver_->media_type() != cricket::MEDIA_TYPE_VIDEO) {
+    return false;
+  }
+  rtc::scoped_refptr<webrtc::MediaStreamTrackInterface> track =
+      rtp_receiver_->track();
+  if (!track ||
+      (store_ && !store_->KeyFrameRequestDue(rtp_receiver_.get()))) {
+    return false;
+  }
+  // The receiver's track source sends the PLI on the worker thread.
+  static_cast<webrtc::VideoTrackInterface*>(track.get())
+      ->GetSource()
+      ->GenerateKeyFrame();
+  if (store_) {
+    store_->OnKeyFrameRequestSent(rtp_receiver_);
+  }
+  return true;
+}
+
+void RTCRtpReceiverImpl::set_min_key_frame_request_interval_ms(
+    int interval_ms) {
+  if (store_) {
+    store_->SetMinKeyFrameRequestInterval(rtp_receiver_, interval_ms);
+  }
+}
+
+int RTCRtpReceiverImpl::min_key_frame_request_interval_ms() const {
+  return store_ ? store_->GetMinKeyFrameRequestInterval(rtp_receiver_.get())
+                : kDefaultMinKeyFrameRequestIntervalMs;
+}
+
+uint64_t RTCRtpReceiverImpl::key_frame_requests() const {
+  return store_ ? store_->GetKeyFrameRequests(rtp_receiver_.get()) : 0;
+}
+
+int RTCRtpReceiverImpl::audio_level() const {
+  return AudioLevelOf(rtp_receiver_.get(), nullptr);
+}
+
+int RTCRtpReceiverImpl::AudioLevelOf(
+    const webrtc::RtpReceiverInterface* receiver, uint32_t* rtp_timestamp) {
+  if (receiver->media_type() != cricket::MEDIA_TYPE_AUDIO) {
+    return -1;
+  }
+  // Sources are ordered newest first.
+  for (const webrtc::RtpSource& source : receiver->GetSources()) {
+    if (source.source_type() != webrtc::RtpSourceType::SSRC) {
+      continue;
+    }
+    if (!source.audio_level()) {
+      return -1;
+    }
+    if (rtp_timestamp) {
+      *rtp_timestamp = source.rtp_timestamp();
+    }
+    return *source.audio_level();
+  }
+  return -1;
+}
+
 }  // namespace libwebrtc
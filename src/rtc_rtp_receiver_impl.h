@@ -3,13 +3,18 @@
 
 #include "api/rtp_receiver_interface.h"
 #include "rtc_rtp_receiver.h"
+#include "src/internal/rtp_state_store.h"
 
 namespace libwebrtc {
 class RTCRtpReceiverImpl : public RTCRtpReceiver,
                            webrtc::RtpReceiverObserverInterface {
  public:
+  // |store| is the state store of the peer connection that owns
+  // |rtp_receiver|. Without one, key frame requests are neither rate limited
+  // nor counted.
   RTCRtpReceiverImpl(
-      rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtp_receiver);
+      rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtp_receiver,
+      rtc::scoped_refptr<RtpStateStore> store = nullptr);
 
   virtual scoped_refptr<RTCMediaTrack> track() const override;
   virtual scoped_refptr<RTCDtlsTransport> dtls_transport() const override;
@@ -22,10 +27,27 @@ class RTCRtpReceiverImpl : public RTCRtpReceiver,
       scoped_refptr<RTCRtpParameters> parameters) override;
   virtual void SetObserver(RTCRtpReceiverObserver* observer) override;
   virtual void SetJitterBufferMinimumDelay(double delay_seconds) override;
+  virtual bool SetAudioLatencyProfile(
+      const RTCAudioLatencyProfile& profile) override;
+  virtual int audio_level() const override;
+  virtual void SetFrameTransformer(
+      scoped_refptr<RTCFrameTransformer> transformer) override;
+  virtual bool RequestKeyFrame() override;
+  virtual void set_min_key_frame_request_interval_ms(int interval_ms) override;
+  virtual int min_key_frame_request_interval_ms() const override;
+  virtual uint64_t key_frame_requests() const override;
   rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtp_receiver();
+  rtc::scoped_refptr<RtpStateStore> store() const { return store_; }
+
+  // Returns the RFC 6464 level of the newest SSRC source of |receiver|, or -1.
+  // |rtp_timestamp|, if given, receives the RTP timestamp it was sent with.
+  // webrtc fills the sources at play-out, after the audio is decoded.
+  static int AudioLevelOf(const webrtc::RtpReceiverInterface* receiver,
+                          uint32_t* rtp_timestamp);
 
  private:
   rtc::scoped_refptr<webrtc::RtpReceiverInterface> rtp_receiver_;
+  rtc::scoped_refptr<RtpStateStore> store_;
   RTCRtpReceiverObserver* observer_;
 
   virtual void OnFirstPacketReceived(cricket::MediaType media_type) override;
@@ -6,10 +6,13 @@
 #include <src/rtc_rtp_parameters_impl.h>
 #include <src/rtc_video_track_impl.h>
 
+#include "src/internal/frame_transformer_adapter.h"
+
 namespace libwebrtc {
 RTCRtpSenderImpl::RTCRtpSenderImpl(
-    rtc::scoped_refptr<webrtc::RtpSenderInterface> rtp_sender)
-    : rtp_sender_(rtp_sender) {}
+    rtc::scoped_refptr<webrtc::RtpSenderInterface> rtp_sender,
+    rtc::scoped_refptr<RtpStateStore> store)
+    : rtp_sender_(rtp_sender), store_(store) {}
 
 bool RTCRtpSenderImpl::set_track(scoped_refptr<RTCMediaTrack> track) {
   if (track == nullptr) {
@@ -43,7 +46,8 @@ scoped_refptr<RTCMediaTrack> RTCRtpSenderImpl::track() const {
     return scoped_refptr<RTCMediaTrack>(new RefCountedObject<AudioTrackImpl>(
         rtc::scoped_refptr<webrtc::AudioTrackInterface>(
             rtc::scoped_refptr<webrtc::AudioTrackInterface>(
-                static_cast<webrtc::AudioTrackInterface*>(track.get())))));
+                static_cast<webrtc::AudioTrackInterface*>(track.get()))),
+        store_ ? store_->dispatcher() : nullptr));
   }
   return scoped_refptr<RTCMediaTrack>();
 }
@@ -109,4 +113,90 @@ scoped_refptr<RTCDtmfSender> RTCRtpSenderImpl::dtmf_sender() const {
   return new RefCountedObject<RTCDtmfSenderImpl>(rtp_sender_->GetDtmfSender());
 }
 
+bool RTCRtpSenderImpl::set_degradation_preference(
+    RTCDegradationPreference preference) {
+  scoped_refptr<RTCRtpParameters> rtp_parameters = parameters();
+  rtp_parameters->SetDegradationPreference(preference);
+  return set_parameters(rtp_parameters);
+}
+
+RTCDegradationPreference RTCRtpSenderImpl::degradation_preference() const {
+  return parameters()->GetDegradationPreference();
+}
+
+bool RTCRtpSenderImpl::set_opus_settings(const RTCOpusSettings& settings) {
+  if (!store_ || rtp_sender_->media_type() != cricket::MEDIA_TYPE_AUDIO) {
+    return false;
+  }
+  SenderSettings sender_settings =
+      store_->GetSenderSettings(rtp_sender_.get());
+  sender_settings.has_opus_settings = true;
+  sender_settings.opus = settings;
+  store_->SetSenderSettings(rtp_sender_, sender_settings);
+  return true;
+}
+
+RTCOpusSettings RTCRtpSenderImpl::opus_settings() const {
+  return store_ ? store_->GetSenderSettings(rtp_sender_.get()).opus
+                : RTCOpusSettings();
+}
+
+bool RTCRtpSenderImpl::set_video_encoder_cpu_settings(
+    const RTCVideoEncoderCpuSettings& settings) {
+  if (!store_ || rtp_sender_->media_type() != cricket::MEDIA_TYPE_VIDEO) {
+    return false;
+  }
+  SenderSettings sender_settings =
+      store_->GetSenderSettings(rtp_sender_.get());
+  sender_settings.has_video_encoder_cpu_settings = true;
+  sender_settings.video_encoder_cpu = settings;
+  store_->SetSenderSettings(rtp_sender_, sender_settings);
+  return true;
+}
+
+RTCVideoEncoderCpuSettings RTCRtpSenderImpl::video_encoder_cpu_settings()
+    const {
+  return store_
+             ? store_->GetSenderSettings(rtp_sender_.get()).video_encoder_cpu
+             : RTCVideoEncoderCpuSettings();
+}
+
+bool RTCRtpSenderImpl::RequestKeyFrame() {
+  if (rtp_sender_->media_type() != cricket::MEDIA_TYPE_VIDEO ||
+      (store_ && !store_->KeyFrameRequestDue(rtp_sender_.get()))) {
+    return false;
+  }
+  // No rids: all layers. Fails, and is not counted, while not sending.
+  if (!rtp_sender_->GenerateKeyFrame(std::vector<std::string>()).ok()) {
+    return false;
+  }
+  if (store_) {
+    store_->OnKeyFrameRequestSent(rtp_sender_);
+  }
+  return true;
+}
+
+void RTCRtpSenderImpl::set_min_key_frame_request_interval_ms(
+    int interval_ms) {
+  if (store_) {
+    store_->SetMinKeyFrameRequestInterval(rtp_sender_, interval_ms);
+  }
+}
+
+int RTCRtpSenderImpl::min_key_frame_request_interval_ms() const {
+  return store_ ? store_->GetMinKeyFrameRequestInterval(rtp_sender_.get())
+                : kDefaultMinKeyFrameRequestIntervalMs;
+}
+
+uint64_t RTCRtpSenderImpl::key_frame_requests() const {
+  return store_ ? store_->GetKeyFrameRequests(rtp_sender_.get()) : 0;
+}
+
+void RTCRtpSenderImpl::SetFrameTransformer(
+    scoped_refptr<RTCFrameTransformer> transformer) {
+  rtp_sender_->SetEncoderToPacketizerFrameTransformer(
+      rtc::make_ref_counted<FrameTransformerAdapter>(transformer,
+                                                     media_type()));
+}
+
 }  // namespace libwebrtc
@@ -4,12 +4,17 @@
 #include "api/rtp_sender_interface.h"
 #include "api/scoped_refptr.h"
 #include "rtc_rtp_sender.h"
+#include "src/internal/rtp_state_store.h"
 
 namespace libwebrtc {
 
 class RTCRtpSenderImpl : public RTCRtpSender {
  public:
-  RTCRtpSenderImpl(rtc::scoped_refptr<webrtc::RtpSenderInterface> rtp_sender);
+  // |store| is the state store of the peer connection that owns
+  // |rtp_sender|. Without one, settings read as defaults and cannot be set,
+  // and key frame requests are neither rate limited nor counted.
+  RTCRtpSenderImpl(rtc::scoped_refptr<webrtc::RtpSenderInterface> rtp_sender,
+                   rtc::scoped_refptr<RtpStateStore> store = nullptr);
 
   virtual bool set_track(scoped_refptr<RTCMediaTrack> track) override;
   virtual scoped_refptr<RTCMediaTrack> track() const override;
@@ -25,6 +30,21 @@ class RTCRtpSenderImpl : public RTCRtpSender {
   virtual bool set_parameters(
       const scoped_refptr<RTCRtpParameters> parameters) override;
   virtual scoped_refptr<RTCDtmfSender> dtmf_sender() const override;
+  virtual bool set_degradation_preference(
+      RTCDegradationPreference preference) override;
+  virtual RTCDegradationPreference degradation_preference() const override;
+  virtual bool set_opus_settings(const RTCOpusSettings& settings) override;
+  virtual RTCOpusSettings opus_settings() const override;
+  virtual bool set_video_encoder_cpu_settings(
+      const RTCVideoEncoderCpuSettings& settings) override;
+  virtual RTCVideoEncoderCpuSettings video_encoder_cpu_settings()
+      const override;
+  virtual bool RequestKeyFrame() override;
+  virtual void set_min_key_frame_request_interval_ms(int interval_ms) override;
+  virtual int min_key_frame_request_interval_ms() const override;
+  virtual uint64_t key_frame_requests() const override;
+  virtual void SetFrameTransformer(
+      scoped_refptr<RTCFrameTransformer> transformer) override;
 
   rtc::scoped_refptr<webrtc::RtpSenderInterface> rtc_rtp_sender() {
     return rtp_sender_;
@@ -32,6 +52,7 @@ class RTCRtpSenderImpl : public RTCRtpSender {
 
  private:
   rtc::scoped_refptr<webrtc::RtpSenderInterface> rtp_sender_;
+  rtc::scoped_refptr<RtpStateStore> store_;
 };
 }  // namespace libwebrtc
 
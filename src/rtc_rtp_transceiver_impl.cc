@@ -69,8 +69,9 @@ void RTCRtpTransceiverInitImpl::set_send_encodings(
 }
 
 RTCRtpTransceiverImpl::RTCRtpTransceiverImpl(
-    rtc::scoped_refptr<webrtc::RtpTransceiverInterface> rtp_transceiver)
-    : rtp_transceiver_(rtp_transceiver) {}
+    rtc::scoped_refptr<webrtc::RtpTransceiverInterface> rtp_transceiver,
+    rtc::scoped_refptr<RtpStateStore> store)
+    : rtp_transceiver_(rtp_transceiver), store_(store) {}
 
 rtc::scoped_refptr<webrtc::RtpTransceiverInterface>
 libwebrtc::RTCRtpTransceiverImpl::rtp_transceiver() {
@@ -81,14 +82,16 @@ scoped_refptr<RTCRtpSender> RTCRtpTransceiverImpl::sender() const {
   if (nullptr == rtp_transceiver_->sender().get()) {
     return scoped_refptr<RTCRtpSender>();
   }
-  return new RefCountedObject<RTCRtpSenderImpl>(rtp_transceiver_->sender());
+  return new RefCountedObject<RTCRtpSenderImpl>(rtp_transceiver_->sender(),
+                                                store_);
 }
 
 scoped_refptr<RTCRtpReceiver> RTCRtpTransceiverImpl::receiver() const {
   if (nullptr == rtp_transceiver_->receiver().get()) {
     return scoped_refptr<RTCRtpReceiver>();
   }
-  return new RefCountedObject<RTCRtpReceiverImpl>(rtp_transceiver_->receiver());
+  return new RefCountedObject<RTCRtpReceiverImpl>(rtp_transceiver_->receiver(),
+                                                  store_);
 }
 
 bool RTCRtpTransceiverImpl::Stopped() const {
@@ -4,6 +4,7 @@
 #include "api/rtp_transceiver_interface.h"
 #include "api/scoped_refptr.h"
 #include "rtc_rtp_transceiver.h"
+#include "src/internal/rtp_state_store.h"
 
 namespace libwebrtc {
 class RTCRtpTransceiverInitImpl : public RTCRtpTransceiverInit {
@@ -30,8 +31,10 @@ class RTCRtpTransceiverInitImpl : public RTCRtpTransceiverInit {
 
 class RTCRtpTransceiverImpl : public RTCRtpTransceiver {
  public:
+  // |store| is passed on to the sender and receiver wrappers.
   RTCRtpTransceiverImpl(
-      rtc::scoped_refptr<webrtc::RtpTransceiverInterface> rtp_transceiver);
+      rtc::scoped_refptr<webrtc::RtpTransceiverInterface> rtp_transceiver,
+      rtc::scoped_refptr<RtpStateStore> store = nullptr);
 
   virtual RTCMediaType media_type() const override;
   virtual const string mid() const override;
@@ -53,6 +56,7 @@ class RTCRtpTransceiverImpl : public RTCRtpTransceiver {
 
  private:
   rtc::scoped_refptr<webrtc::RtpTransceiverInterface> rtp_transceiver_;
+  rtc::scoped_refptr<RtpStateStore> store_;
 };
 
 }  // namespace libwebrtc
@@ -0,0 +1,162 @@
+#include "rtc_video_codec_impl.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "rtc_base/logging.h"
+#include "rtc_video_frame_impl.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// A VP8 key frame starts with a 3 byte frame tag, a 3 byte start code and
+// the 14 bit width and height (RFC 6386, section 9.1).
+const size_t kVp8KeyFrameHeaderSize = 10;
+const uint8_t kVp8StartCode[] = {0x9d, 0x01, 0x2a};
+// Frame tag with show_frame set; bit 0 clear marks a key frame.
+const uint8_t kVp8KeyFrameTag = 0x10;
+const uint8_t kVp8DeltaFrameTag = 0x11;
+
+}  // namespace
+
+scoped_refptr<RTCVideoEncoderFactory> RTCVideoEncoderFactory::CreateNull() {
+  return scoped_refptr<RTCVideoEncoderFactory>(
+      new RefCountedObject<NullVideoEncoderFactory>());
+}
+
+scoped_refptr<RTCVideoDecoderFactory> RTCVideoDecoderFactory::CreateNull() {
+  return scoped_refptr<RTCVideoDecoderFactory>(
+      new RefCountedObject<NullVideoDecoderFactory>());
+}
+
+NullVideoEncoder::NullVideoEncoder() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+NullVideoEncoder::~NullVideoEncoder() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool NullVideoEncoder::InitEncode(const RTCVideoEncoderSettings& settings,
+                                  RTCVideoEncoderCallback* callback) {
+  if (settings.codec != RTCVideoCodecType::kVP8) {
+    return false;
+  }
+  callback_ = callback;
+  bitrate_bps_ = settings.start_bitrate_kbps * 1000;
+  framerate_ = settings.max_framerate;
+  key_frame_pending_ = true;
+  return true;
+}
+
+bool NullVideoEncoder::Encode(scoped_refptr<RTCVideoFrame> frame,
+                              bool key_frame, uint32_t timestamp) {
+  if (!callback_ || bitrate_bps_ == 0) {
+    return true;
+  }
+  key_frame = key_frame || key_frame_pending_;
+  key_frame_pending_ = false;
+  const size_t size = std::max(
+      kVp8KeyFrameHeaderSize,
+      static_cast<size_t>(bitrate_bps_ / 8 / std::max(framerate_, 1.0)));
+  payload_.assign(size, 0);
+  if (key_frame) {
+    const int width = frame->width();
+    const int height = frame->height();
+    payload_[0] = kVp8KeyFrameTag;
+    std::copy(std::begin(kVp8StartCode), std::end(kVp8StartCode),
+              payload_.begin() + 3);
+    payload_[6] = width & 0xff;
+    payload_[7] = (width >> 8) & 0x3f;
+    payload_[8] = height & 0xff;
+    payload_[9] = (height >> 8) & 0x3f;
+  } else {
+    payload_[0] = kVp8DeltaFrameTag;
+  }
+  callback_->OnEncodedFrame(payload_.data(), payload_.size(), key_frame,
+                            frame->width(), frame->height(), timestamp);
+  return true;
+}
+
+void NullVideoEncoder::SetRates(uint32_t bitrate_bps, double framerate) {
+  bitrate_bps_ = bitrate_bps;
+  if (framerate > 0) {
+    framerate_ = framerate;
+  }
+}
+
+void NullVideoEncoder::Release() {
+  callback_ = nullptr;
+}
+
+NullVideoDecoder::NullVideoDecoder() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+NullVideoDecoder::~NullVideoDecoder() {
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool NullVideoDecoder::Configure(RTCVideoCodecType codec, int number_of_cores,
+                                 RTCVideoDecoderCallback* callback) {
+  callback_ = callback;
+  return codec == RTCVideoCodecType::kVP8;
+}
+
+bool NullVideoDecoder::Decode(const uint8_t* data, size_t size,
+                              bool key_frame, uint32_t timestamp) {
+  if (key_frame && size >= kVp8KeyFrameHeaderSize &&
+      std::equal(std::begin(kVp8StartCode), std::end(kVp8StartCode),
+                 data + 3)) {
+    width_ = (data[6] | (data[7] << 8)) & 0x3fff;
+    height_ = (data[8] | (data[9] << 8)) & 0x3fff;
+  }
+  if (width_ == 0 || height_ == 0) {
+    // Nothing to size the frame with before a key frame.
+    return false;
+  }
+  if (!black_ || black_->width() != width_ || black_->height() != height_) {
+    black_ = webrtc::I420Buffer::Create(width_, height_);
+    webrtc::I420Buffer::SetBlack(black_.get());
+  }
+  if (callback_) {
+    callback_->OnDecodedFrame(
+        scoped_refptr<RTCVideoFrame>(
+            new RefCountedObject<VideoFrameBufferImpl>(black_)),
+        timestamp);
+  }
+  return true;
+}
+
+void NullVideoDecoder::Release() {
+  callback_ = nullptr;
+}
+
+vector<RTCVideoCodecType> NullVideoEncoderFactory::supported_codecs() const {
+  return std::vector<RTCVideoCodecType>{RTCVideoCodecType::kVP8};
+}
+
+scoped_refptr<RTCVideoEncoder> NullVideoEncoderFactory::Create(
+    RTCVideoCodecType codec) {
+  if (codec != RTCVideoCodecType::kVP8) {
+    return nullptr;
+  }
+  return scoped_refptr<RTCVideoEncoder>(
+      new RefCountedObject<NullVideoEncoder>());
+}
+
+vector<RTCVideoCodecType> NullVideoDecoderFactory::supported_codecs() const {
+  return std::vector<RTCVideoCodecType>{RTCVideoCodecType::kVP8};
+}
+
+scoped_refptr<RTCVideoDecoder> NullVideoDecoderFactory::Create(
+    RTCVideoCodecType codec) {
+  if (codec != RTCVideoCodecType::kVP8) {
+    return nullptr;
+  }
+  return scoped_refptr<RTCVideoDecoder>(
+      new RefCountedObject<NullVideoDecoder>());
+}
+
+}  // namespace libwebrtc
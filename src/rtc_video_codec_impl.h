@@ -0,0 +1,72 @@
+#ifndef LIB_WEBRTC_VIDEO_CODEC_IMPL_HXX
+#define LIB_WEBRTC_VIDEO_CODEC_IMPL_HXX
+
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "rtc_video_codec.h"
+
+namespace libwebrtc {
+
+// Emits VP8-framed filler frames sized to the target bitrate. The frame
+// header is real, so packetizers and depacketizers treat the frames as VP8.
+class NullVideoEncoder : public RTCVideoEncoder {
+ public:
+  NullVideoEncoder();
+  ~NullVideoEncoder() override;
+
+  bool InitEncode(const RTCVideoEncoderSettings& settings,
+                  RTCVideoEncoderCallback* callback) override;
+  bool Encode(scoped_refptr<RTCVideoFrame> frame, bool key_frame,
+              uint32_t timestamp) override;
+  void SetRates(uint32_t bitrate_bps, double framerate) override;
+  void Release() override;
+  const string implementation_name() const override { return "Null"; }
+
+ private:
+  RTCVideoEncoderCallback* callback_ = nullptr;
+  uint32_t bitrate_bps_ = 0;
+  double framerate_ = 30;
+  bool key_frame_pending_ = true;
+  std::vector<uint8_t> payload_;
+};
+
+// Outputs a black frame of the size in the last VP8 key frame header for
+// every frame.
+class NullVideoDecoder : public RTCVideoDecoder {
+ public:
+  NullVideoDecoder();
+  ~NullVideoDecoder() override;
+
+  bool Configure(RTCVideoCodecType codec, int number_of_cores,
+                 RTCVideoDecoderCallback* callback) override;
+  bool Decode(const uint8_t* data, size_t size, bool key_frame,
+              uint32_t timestamp) override;
+  void Release() override;
+  const string implementation_name() const override { return "Null"; }
+
+ private:
+  RTCVideoDecoderCallback* callback_ = nullptr;
+  int width_ = 0;
+  int height_ = 0;
+  // Shared by all output frames; it is never written after SetBlack().
+  rtc::scoped_refptr<webrtc::I420Buffer> black_;
+};
+
+class NullVideoEncoderFactory : public RTCVideoEncoderFactory {
+ public:
+  vector<RTCVideoCodecType> supported_codecs() const override;
+
+  scoped_refptr<RTCVideoEncoder> Create(RTCVideoCodecType codec) override;
+};
+
+class NullVideoDecoderFactory : public RTCVideoDecoderFactory {
+ public:
+  vector<RTCVideoCodecType> supported_codecs() const override;
+
+  scoped_refptr<RTCVideoDecoder> Create(RTCVideoCodecType codec) override;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_VIDEO_CODEC_IMPL_HXX
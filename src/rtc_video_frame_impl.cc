@@ -56,13 +56,16 @@ int VideoFrameBufferImpl::StrideV() const {
 int VideoFrameBufferImpl::ConvertToARGB(Type type, uint8_t* dst_buffer,
                                         int dst_stride, int dest_width,
                                         int dest_height) {
-  rtc::scoped_refptr<webrtc::I420Buffer> i420 =
-      webrtc::I420Buffer::Rotate(*buffer_.get(), rotation_);
+  // Scale before rotating: the smaller image is cheaper to rotate, and
+  // captured frames serve the scale from their shared downscale pyramid.
+  const bool transposed = rotation_ == webrtc::kVideoRotation_90 ||
+                          rotation_ == webrtc::kVideoRotation_270;
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled =
+      buffer_->Scale(transposed ? dest_height : dest_width,
+                     transposed ? dest_width : dest_height);
 
   rtc::scoped_refptr<webrtc::I420Buffer> dest =
-      webrtc::I420Buffer::Create(dest_width, dest_height);
-
-  dest->ScaleFrom(*i420.get());
+      webrtc::I420Buffer::Rotate(*scaled.get(), rotation_);
   int buf_size = dest->width() * dest->height() * (32 >> 3);
   switch (type) {
     case libwebrtc::RTCVideoFrame::Type::kARGB:
@@ -0,0 +1,291 @@
+#include "rtc_video_recorder_impl.h"
+
+#include "rtc_base/logging.h"
+#include "rtc_base/system/file_wrapper.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_rtp_receiver_impl.h"
+#include "src/internal/external_video_codec.h"
+
+namespace libwebrtc {
+
+namespace {
+
+// Sizes of the IVF file and frame headers.
+const uint64_t kIvfFileHeaderSize = 32;
+const uint64_t kIvfFrameHeaderSize = 12;
+
+// rec.ivf -> rec.<index>.ivf
+std::string RotatedPath(const std::string& path, int index) {
+  size_t dot = path.rfind('.');
+  const size_t separator = path.find_last_of("/\\");
+  if (dot == std::string::npos ||
+      (separator != std::string::npos && dot < separator)) {
+    dot = path.size();
+  }
+  return path.substr(0, dot) + "." + std::to_string(index) + path.substr(dot);
+}
+
+}  // namespace
+
+// Copies the frames a sender hands to its packetizer into the recorder.
+// The sender keeps the tap for as long as it has no other transformer, so
+// the recorder detaches from it when closed.
+class RTCVideoRecorderImpl::SenderTap : public RTCFrameTransformer {
+ public:
+  explicit SenderTap(RTCVideoRecorderImpl* recorder) : recorder_(recorder) {}
+
+  bool OnFrame(scoped_refptr<RTCEncodedFrame> frame) override {
+    webrtc::MutexLock lock(&mutex_);
+    // Frames in a codec the recorder cannot name are passed on unrecorded.
+    if (recorder_ && frame->has_video_codec() && frame->data() &&
+        frame->size()) {
+      recorder_->Enqueue(
+          webrtc::EncodedImageBuffer::Create(frame->data(), frame->size()),
+          ToWebrtcCodecType(frame->video_codec()), frame->is_key_frame(),
+          frame->width(), frame->height(), rtc::TimeMillis());
+    }
+    return true;
+  }
+
+  void Detach() {
+    webrtc::MutexLock lock(&mutex_);
+    recorder_ = nullptr;
+  }
+
+ private:
+  webrtc::Mutex mutex_;
+  RTCVideoRecorderImpl* recorder_ RTC_GUARDED_BY(mutex_);
+};
+
+scoped_refptr<RTCVideoRecorder> RTCVideoRecorder::Create(
+    scoped_refptr<RTCRtpReceiver> receiver, const string path,
+    const RTCVideoRecorderOptions& options) {
+  rtc::scoped_refptr<webrtc::MediaStreamTrackInterface> track =
+      static_cast<RTCRtpReceiverImpl*>(receiver.get())->rtp_receiver()->track();
+  if (!track ||
+      track->kind() != webrtc::MediaStreamTrackInterface::kVideoKind) {
+    return nullptr;
+  }
+  scoped_refptr<RTCVideoRecorderImpl> recorder =
+      RTCVideoRecorderImpl::Open(path.std_string(), options);
+  if (recorder) {
+    recorder->AttachReceiver(
+        rtc::scoped_refptr<webrtc::VideoTrackSourceInterface>(
+            static_cast<webrtc::VideoTrackInterface*>(track.get())
+                ->GetSource()));
+  }
+  return recorder;
+}
+
+scoped_refptr<RTCVideoRecorder> RTCVideoRecorder::Create(
+    scoped_refptr<RTCRtpSender> sender, const string path,
+    const RTCVideoRecorderOptions& options) {
+  if (sender->media_type() != RTCMediaType::VIDEO) {
+    return nullptr;
+  }
+  scoped_refptr<RTCVideoRecorderImpl> recorder =
+      RTCVideoRecorderImpl::Open(path.std_string(), options);
+  if (recorder) {
+    recorder->AttachSender(sender);
+  }
+  return recorder;
+}
+
+scoped_refptr<RTCVideoRecorderImpl> RTCVideoRecorderImpl::Open(
+    const std::string& path, const RTCVideoRecorderOptions& options) {
+  webrtc::FileWrapper file = webrtc::FileWrapper::OpenWriteOnly(path);
+  if (!file.is_open()) {
+    RTC_LOG(LS_ERROR) << "Cannot create " << path;
+    return nullptr;
+  }
+  return scoped_refptr<RTCVideoRecorderImpl>(
+      new RefCountedObject<RTCVideoRecorderImpl>(
+          webrtc::IvfFileWriter::Wrap(std::move(file), /*byte_limit=*/0),
+          path, options));
+}
+
+RTCVideoRecorderImpl::RTCVideoRecorderImpl(
+    std::unique_ptr<webrtc::IvfFileWriter> writer, const std::string& path,
+    const RTCVideoRecorderOptions& options)
+    : path_(path),
+      options_(options),
+      writer_(std::move(writer)),
+      file_bytes_(kIvfFileHeaderSize) {
+  thread_ = rtc::PlatformThread::SpawnJoinable([this] { WriteLoop(); },
+                                               "ivf_file_writer");
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+RTCVideoRecorderImpl::~RTCVideoRecorderImpl() {
+  Close();
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+void RTCVideoRecorderImpl::AttachReceiver(
+    rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source) {
+  receiver_source_ = source;
+  if (!receiver_source_->SupportsEncodedOutput()) {
+    RTC_LOG(LS_ERROR) << "The receiver's track has no encoded output.";
+  }
+  // Also makes the receiver request a key frame.
+  receiver_source_->AddEncodedSink(this);
+}
+
+void RTCVideoRecorderImpl::AttachSender(scoped_refptr<RTCRtpSender> sender) {
+  sender_tap_ = scoped_refptr<SenderTap>(new RefCountedObject<SenderTap>(this));
+  sender->SetFrameTransformer(sender_tap_);
+}
+
+void RTCVideoRecorderImpl::OnFrame(
+    const webrtc::RecordableEncodedFrame& frame) {
+  const webrtc::RecordableEncodedFrame::EncodedResolution resolution =
+      frame.resolution();
+  if (resolution.width > 0 && resolution.height > 0) {
+    width_ = resolution.width;
+    height_ = resolution.height;
+  }
+  const int64_t render_time_ms = frame.render_time().ms();
+  // The buffer is only read from here on.
+  Enqueue(rtc::scoped_refptr<webrtc::EncodedImageBufferInterface>(
+              const_cast<webrtc::EncodedImageBufferInterface*>(
+                  frame.encoded_buffer().get())),
+          frame.codec(), frame.is_key_frame(), width_, height_,
+          render_time_ms > 0 ? render_time_ms : rtc::TimeMillis());
+}
+
+void RTCVideoRecorderImpl::Enqueue(
+    rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data,
+    webrtc::VideoCodecType codec, bool key_frame, int width, int height,
+    int64_t time_ms) {
+  const size_t size = data ? data->size() : 0;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (closing_ || size == 0 || (waiting_for_key_frame_ && !key_frame)) {
+      ++frames_dropped_;
+      return;
+    }
+    if (buffered_bytes_ + size > options_.max_buffered_bytes) {
+      ++frames_dropped_;
+      waiting_for_key_frame_ = true;
+      return;
+    }
+    waiting_for_key_frame_ = false;
+    buffered_bytes_ += size;
+    queue_.push_back({data, codec, key_frame, width, height, time_ms});
+  }
+  wake_.Set();
+}
+
+void RTCVideoRecorderImpl::Close() {
+  if (receiver_source_) {
+    receiver_source_->RemoveEncodedSink(this);
+    receiver_source_ = nullptr;
+  }
+  if (sender_tap_) {
+    sender_tap_->Detach();
+  }
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (closing_) {
+      return;
+    }
+    closing_ = true;
+  }
+  wake_.Set();
+  thread_.Finalize();
+  if (writer_) {
+    writer_->Close();
+    writer_.reset();
+  }
+}
+
+void RTCVideoRecorderImpl::WriteLoop() {
+  std::deque<QueuedFrame> batch;
+  while (true) {
+    wake_.Wait(rtc::Event::kForever);
+    bool closing;
+    {
+      webrtc::MutexLock lock(&mutex_);
+      batch.swap(queue_);
+      closing = closing_;
+    }
+    size_t batch_bytes = 0;
+    for (const QueuedFrame& frame : batch) {
+      batch_bytes += frame.data->size();
+      WriteFrame(frame);
+    }
+    batch.clear();
+    {
+      webrtc::MutexLock lock(&mutex_);
+      buffered_bytes_ -= batch_bytes;
+    }
+    if (closing) {
+      // Frames queued after |closing_| was set are refused, so |batch| held
+      // the last of them.
+      return;
+    }
+  }
+}
+
+void RTCVideoRecorderImpl::WriteFrame(const QueuedFrame& frame) {
+  if (frame.key_frame && (!writer_ || FileFull(frame))) {
+    OpenNextFile();
+  }
+  if (writer_ && file_frames_ == 0) {
+    file_codec_ = frame.codec;
+    file_start_ms_ = frame.time_ms;
+  }
+  // A codec change waits for the key frame that starts the next file.
+  if (!writer_ || frame.codec != file_codec_) {
+    ++frames_dropped_;
+    return;
+  }
+
+  webrtc::EncodedImage image;
+  image.SetEncodedData(frame.data);
+  image._encodedWidth = frame.width;
+  image._encodedHeight = frame.height;
+  image._frameType = frame.key_frame ? webrtc::VideoFrameType::kVideoFrameKey
+                                     : webrtc::VideoFrameType::kVideoFrameDelta;
+  // Without an RTP timestamp the writer uses capture_time_ms_ at 1 kHz.
+  image.SetRtpTimestamp(0);
+  image.capture_time_ms_ = frame.time_ms;
+  if (!writer_->WriteFrame(image, frame.codec)) {
+    ++frames_dropped_;
+    return;
+  }
+  ++file_frames_;
+  file_bytes_ += kIvfFrameHeaderSize + frame.data->size();
+  ++frames_written_;
+}
+
+bool RTCVideoRecorderImpl::FileFull(const QueuedFrame& frame) const {
+  if (file_frames_ == 0) {
+    return false;
+  }
+  return frame.codec != file_codec_ ||
+         (options_.max_file_bytes > 0 &&
+          file_bytes_ >= options_.max_file_bytes) ||
+         (options_.max_file_duration_ms > 0 &&
+          frame.time_ms - file_start_ms_ >= options_.max_file_duration_ms);
+}
+
+void RTCVideoRecorderImpl::OpenNextFile() {
+  if (writer_) {
+    writer_->Close();
+    writer_.reset();
+  }
+  const std::string path = RotatedPath(path_, ++file_index_);
+  webrtc::FileWrapper file = webrtc::FileWrapper::OpenWriteOnly(path);
+  if (!file.is_open()) {
+    // Retried at the next key frame.
+    RTC_LOG(LS_ERROR) << "Cannot create " << path;
+    return;
+  }
+  writer_ = webrtc::IvfFileWriter::Wrap(std::move(file), /*byte_limit=*/0);
+  file_frames_ = 0;
+  file_bytes_ = kIvfFileHeaderSize;
+  ++files_written_;
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,113 @@
+#ifndef LIB_WEBRTC_VIDEO_RECORDER_IMPL_HXX
+#define LIB_WEBRTC_VIDEO_RECORDER_IMPL_HXX
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "api/media_stream_interface.h"
+#include "api/video/encoded_image.h"
+#include "api/video/recordable_encoded_frame.h"
+#include "api/video_codecs/video_codec.h"
+#include "modules/video_coding/utility/ivf_file_writer.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_video_recorder.h"
+
+namespace libwebrtc {
+
+class RTCVideoRecorderImpl
+    : public RTCVideoRecorder,
+      public rtc::VideoSinkInterface<webrtc::RecordableEncodedFrame> {
+ public:
+  // Creates |path| and starts the writer thread; null if the file cannot be
+  // created. Attach a receiver or sender next.
+  static scoped_refptr<RTCVideoRecorderImpl> Open(
+      const std::string& path, const RTCVideoRecorderOptions& options);
+
+  RTCVideoRecorderImpl(std::unique_ptr<webrtc::IvfFileWriter> writer,
+                       const std::string& path,
+                       const RTCVideoRecorderOptions& options);
+
+  // Records the encoded output of a remote video track source.
+  void AttachReceiver(
+      rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source);
+
+  // Records the encoder output of |sender| through its frame transformer.
+  void AttachSender(scoped_refptr<RTCRtpSender> sender);
+
+  // Queues a frame for the writer thread. Called on media threads.
+  void Enqueue(rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data,
+               webrtc::VideoCodecType codec, bool key_frame, int width,
+               int height, int64_t time_ms);
+
+  // rtc::VideoSinkInterface<webrtc::RecordableEncodedFrame>
+  void OnFrame(const webrtc::RecordableEncodedFrame& frame) override;
+
+  void Close() override;
+
+  uint64_t frames_written() const override { return frames_written_; }
+
+  uint64_t frames_dropped() const override { return frames_dropped_; }
+
+  int files_written() const override { return files_written_; }
+
+ protected:
+  ~RTCVideoRecorderImpl() override;
+
+ private:
+  class SenderTap;
+
+  struct QueuedFrame {
+    rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> data;
+    webrtc::VideoCodecType codec;
+    bool key_frame;
+    int width;
+    int height;
+    int64_t time_ms;
+  };
+
+  // Body of the writer thread and its helpers.
+  void WriteLoop();
+  void WriteFrame(const QueuedFrame& frame);
+  bool FileFull(const QueuedFrame& frame) const;
+  void OpenNextFile();
+
+  const std::string path_;
+  const RTCVideoRecorderOptions options_;
+
+  // Used by the writer thread only.
+  std::unique_ptr<webrtc::IvfFileWriter> writer_;
+  int file_index_ = 0;
+  uint64_t file_frames_ = 0;
+  uint64_t file_bytes_ = 0;
+  int64_t file_start_ms_ = 0;
+  webrtc::VideoCodecType file_codec_ = webrtc::kVideoCodecGeneric;
+
+  rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> receiver_source_;
+  scoped_refptr<SenderTap> sender_tap_;
+  // Last known resolution of the received stream; delta frames carry none.
+  int width_ = 0;
+  int height_ = 0;
+
+  webrtc::Mutex mutex_;
+  std::deque<QueuedFrame> queue_ RTC_GUARDED_BY(mutex_);
+  // Bytes queued or being written.
+  size_t buffered_bytes_ RTC_GUARDED_BY(mutex_) = 0;
+  // Frames are refused until a key frame, at the start and after a drop,
+  // so every file decodes without gaps.
+  bool waiting_for_key_frame_ RTC_GUARDED_BY(mutex_) = true;
+  bool closing_ RTC_GUARDED_BY(mutex_) = false;
+  rtc::Event wake_;
+
+  std::atomic<uint64_t> frames_written_{0};
+  std::atomic<uint64_t> frames_dropped_{0};
+  std::atomic<int> files_written_{1};
+  rtc::PlatformThread thread_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_VIDEO_RECORDER_IMPL_HXX
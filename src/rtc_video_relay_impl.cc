@@ -0,0 +1,200 @@
+#include "rtc_video_relay_impl.h"
+
+#include <algorithm>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_rtp_sender_impl.h"
+
+namespace libwebrtc {
+
+RTCVideoRelayImpl::RTCVideoRelayImpl(
+    rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory,
+    rtc::Thread* signaling_thread,
+    rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> upstream,
+    webrtc::VideoCodecType codec, int min_key_frame_request_interval_ms)
+    : factory_(factory),
+      signaling_thread_(signaling_thread),
+      upstream_(upstream),
+      codec_(codec),
+      min_key_frame_request_interval_ms_(
+          std::max(min_key_frame_request_interval_ms, 0)) {
+  if (!upstream_->SupportsEncodedOutput()) {
+    RTC_LOG(LS_ERROR) << "The receiver's track has no encoded output.";
+  }
+  upstream_->AddEncodedSink(this);
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+RTCVideoRelayImpl::~RTCVideoRelayImpl() {
+  upstream_->RemoveEncodedSink(this);
+  std::vector<Output> outputs;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    outputs.swap(outputs_);
+  }
+  for (const Output& output : outputs) {
+    output.source->SetObserver(nullptr);
+    output.sender->SetTrack(nullptr);
+  }
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+bool RTCVideoRelayImpl::AddSender(scoped_refptr<RTCRtpSender> sender) {
+  rtc::scoped_refptr<webrtc::RtpSenderInterface> rtc_sender =
+      static_cast<RTCRtpSenderImpl*>(sender.get())->rtc_rtp_sender();
+  if (rtc_sender->media_type() != cricket::MEDIA_TYPE_VIDEO) {
+    return false;
+  }
+  {
+    webrtc::MutexLock lock(&mutex_);
+    for (const Output& output : outputs_) {
+      if (output.sender == rtc_sender) {
+        return false;
+      }
+    }
+  }
+
+  Output output;
+  output.sender = rtc_sender;
+  output.source = EncodedVideoTrackSource::Create(codec_);
+  if (!output.source) {
+    return false;
+  }
+  output.source->SetObserver(this);
+  rtc::scoped_refptr<webrtc::VideoTrackInterface> track =
+      factory_->CreateVideoTrack(output.source, "relay_" + rtc_sender->id());
+  if (!rtc_sender->SetTrack(track.get())) {
+    output.source->SetObserver(nullptr);
+    return false;
+  }
+
+  {
+    webrtc::MutexLock delivery_lock(&delivery_mutex_);
+    rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> key_frame;
+    int width, height;
+    {
+      webrtc::MutexLock lock(&mutex_);
+      outputs_.push_back(output);
+      key_frame = key_frame_;
+      width = key_frame_width_;
+      height = key_frame_height_;
+    }
+    // Start the new sender with the cached key frame rather than a blank
+    // picture for up to a key frame interval. The output keeps waiting for
+    // a fresh key frame before it gets deltas.
+    if (key_frame) {
+      output.source->PushBuffer(key_frame, true, width, height, 0);
+    }
+  }
+  RequestUpstreamKeyFrame();
+  return true;
+}
+
+void RTCVideoRelayImpl::RemoveSender(scoped_refptr<RTCRtpSender> sender) {
+  webrtc::RtpSenderInterface* rtc_sender =
+      static_cast<RTCRtpSenderImpl*>(sender.get())->rtc_rtp_sender().get();
+  Output removed;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    auto it = std::find_if(outputs_.begin(), outputs_.end(),
+                           [rtc_sender](const Output& output) {
+                             return output.sender.get() == rtc_sender;
+                           });
+    if (it == outputs_.end()) {
+      return;
+    }
+    removed = *it;
+    outputs_.erase(it);
+  }
+  removed.source->SetObserver(nullptr);
+  removed.sender->SetTrack(nullptr);
+}
+
+size_t RTCVideoRelayImpl::num_senders() const {
+  webrtc::MutexLock lock(&mutex_);
+  return outputs_.size();
+}
+
+void RTCVideoRelayImpl::OnFrame(const webrtc::RecordableEncodedFrame& frame) {
+  ++frames_received_;
+  if (frame.codec() != codec_) {
+    if (!codec_mismatch_logged_) {
+      codec_mismatch_logged_ = true;
+      RTC_LOG(LS_WARNING) << "Received "
+                          << webrtc::CodecTypeToPayloadString(frame.codec())
+                          << " instead of the relay's "
+                          << webrtc::CodecTypeToPayloadString(codec_)
+                          << ", not relaying.";
+    }
+    return;
+  }
+  const webrtc::RecordableEncodedFrame::EncodedResolution resolution =
+      frame.resolution();
+  if (resolution.width > 0 && resolution.height > 0) {
+    width_ = resolution.width;
+    height_ = resolution.height;
+  }
+  if (width_ == 0 || height_ == 0) {
+    // Nothing to size the frames with before the first key frame.
+    RequestUpstreamKeyFrame();
+    return;
+  }
+
+  // The buffer is only read from here on, by the packetizers of all senders.
+  rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> buffer(
+      const_cast<webrtc::EncodedImageBufferInterface*>(
+          frame.encoded_buffer().get()));
+  const bool key_frame = frame.is_key_frame();
+  webrtc::MutexLock delivery_lock(&delivery_mutex_);
+  std::vector<rtc::scoped_refptr<EncodedVideoTrackSource>> sources;
+  bool waiting = false;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (key_frame) {
+      key_frame_ = buffer;
+      key_frame_width_ = width_;
+      key_frame_height_ = height_;
+    }
+    sources.reserve(outputs_.size());
+    for (Output& output : outputs_) {
+      if (key_frame) {
+        output.waiting_for_key_frame = false;
+      } else if (output.waiting_for_key_frame) {
+        waiting = true;
+        continue;
+      }
+      sources.push_back(output.source);
+    }
+  }
+  if (waiting) {
+    // The request made when the output was added may have been folded into
+    // an earlier one whose key frame it missed.
+    RequestUpstreamKeyFrame();
+  }
+  for (const auto& source : sources) {
+    source->PushBuffer(buffer, key_frame, width_, height_, 0);
+  }
+}
+
+void RTCVideoRelayImpl::OnKeyFrameRequested() {
+  RequestUpstreamKeyFrame();
+}
+
+void RTCVideoRelayImpl::RequestUpstreamKeyFrame() {
+  const int64_t now_ms = rtc::TimeMillis();
+  int64_t last_ms = last_key_frame_request_ms_;
+  if (last_ms >= 0 && now_ms - last_ms < min_key_frame_request_interval_ms_) {
+    return;
+  }
+  if (!last_key_frame_request_ms_.compare_exchange_strong(last_ms, now_ms)) {
+    return;
+  }
+  ++key_frame_requests_;
+  // Sends a PLI. Posted, since the proxy blocks on the worker thread and
+  // this may run on a media thread.
+  rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> upstream = upstream_;
+  signaling_thread_->PostTask([upstream] { upstream->GenerateKeyFrame(); });
+}
+
+}  // namespace libwebrtc
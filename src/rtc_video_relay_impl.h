@@ -0,0 +1,88 @@
+#ifndef LIB_WEBRTC_VIDEO_RELAY_IMPL_HXX
+#define LIB_WEBRTC_VIDEO_RELAY_IMPL_HXX
+
+#include <atomic>
+#include <vector>
+
+#include "api/peer_connection_interface.h"
+#include "api/video/recordable_encoded_frame.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread.h"
+#include "rtc_video_relay.h"
+#include "src/internal/encoded_video_track_source.h"
+
+namespace libwebrtc {
+
+class RTCVideoRelayImpl
+    : public RTCVideoRelay,
+      public rtc::VideoSinkInterface<webrtc::RecordableEncodedFrame>,
+      public RTCEncodedVideoSourceObserver {
+ public:
+  RTCVideoRelayImpl(
+      rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory,
+      rtc::Thread* signaling_thread,
+      rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> upstream,
+      webrtc::VideoCodecType codec, int min_key_frame_request_interval_ms);
+
+  bool AddSender(scoped_refptr<RTCRtpSender> sender) override;
+
+  void RemoveSender(scoped_refptr<RTCRtpSender> sender) override;
+
+  size_t num_senders() const override;
+
+  uint64_t frames_received() const override { return frames_received_; }
+
+  uint64_t key_frame_requests() const override { return key_frame_requests_; }
+
+  // rtc::VideoSinkInterface, called by the receive stream.
+  void OnFrame(const webrtc::RecordableEncodedFrame& frame) override;
+
+  // RTCEncodedVideoSourceObserver, called by the senders' encoders.
+  void OnKeyFrameRequested() override;
+
+ protected:
+  ~RTCVideoRelayImpl() override;
+
+ private:
+  struct Output {
+    rtc::scoped_refptr<webrtc::RtpSenderInterface> sender;
+    rtc::scoped_refptr<EncodedVideoTrackSource> source;
+    // Set until the first key frame after the cached one; the deltas before
+    // it cannot be decoded by the output's receivers.
+    bool waiting_for_key_frame = true;
+  };
+
+  // Asks the upstream peer for a key frame unless that was done less than
+  // |min_key_frame_request_interval_ms_| ago.
+  void RequestUpstreamKeyFrame();
+
+  const rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory_;
+  rtc::Thread* const signaling_thread_;
+  const rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> upstream_;
+  const webrtc::VideoCodecType codec_;
+  const int min_key_frame_request_interval_ms_;
+
+  // Serializes deliveries to the outputs, so that a new output gets the
+  // cached key frame before any live frame. Taken before |mutex_|.
+  webrtc::Mutex delivery_mutex_;
+  mutable webrtc::Mutex mutex_;
+  std::vector<Output> outputs_ RTC_GUARDED_BY(mutex_);
+  rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> key_frame_
+      RTC_GUARDED_BY(mutex_);
+  int key_frame_width_ RTC_GUARDED_BY(mutex_) = 0;
+  int key_frame_height_ RTC_GUARDED_BY(mutex_) = 0;
+
+  // Only accessed by the receive stream. Delta frames may not carry their
+  // resolution.
+  int width_ = 0;
+  int height_ = 0;
+  bool codec_mismatch_logged_ = false;
+
+  std::atomic<uint64_t> frames_received_{0};
+  std::atomic<uint64_t> key_frame_requests_{0};
+  std::atomic<int64_t> last_key_frame_request_ms_{-1};
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_VIDEO_RELAY_IMPL_HXX
@@ -34,6 +34,15 @@ class VideoTrackImpl : public RTCVideoTrack {
     return rtc_track_->set_enabled(enable);
   }
 
+  virtual void set_content_hint(RTCVideoContentHint hint) override {
+    rtc_track_->set_content_hint(
+        static_cast<webrtc::VideoTrackInterface::ContentHint>(hint));
+  }
+
+  virtual RTCVideoContentHint content_hint() const override {
+    return static_cast<RTCVideoContentHint>(rtc_track_->content_hint());
+  }
+
   virtual rtc::scoped_refptr<webrtc::VideoTrackInterface> rtc_track() {
     return rtc_track_;
   }
@@ -0,0 +1,116 @@
+#include "rtc_wav_file_sink_impl.h"
+
+#include <algorithm>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/system/file_wrapper.h"
+
+namespace libwebrtc {
+
+scoped_refptr<RTCWavFileSink> RTCWavFileSink::Create(const string path,
+                                                     int sample_rate_hz,
+                                                     size_t num_channels,
+                                                     int max_buffered_ms) {
+  if (sample_rate_hz <= 0 || sample_rate_hz % 100 != 0 || num_channels == 0 ||
+      num_channels > 2) {
+    RTC_LOG(LS_ERROR) << "Unsupported WAV sink format " << sample_rate_hz
+                      << " Hz, " << num_channels << " ch.";
+    return nullptr;
+  }
+  webrtc::FileWrapper file = webrtc::FileWrapper::OpenWriteOnly(
+      path.std_string());
+  if (!file.is_open()) {
+    RTC_LOG(LS_ERROR) << "Cannot create " << path.std_string();
+    return nullptr;
+  }
+  std::unique_ptr<webrtc::WavWriter> writer(
+      new webrtc::WavWriter(std::move(file), sample_rate_hz, num_channels));
+  size_t max_queued_frames =
+      static_cast<size_t>(std::max(max_buffered_ms, 10) / 10);
+  return scoped_refptr<RTCWavFileSink>(new RefCountedObject<RTCWavFileSinkImpl>(
+      std::move(writer), sample_rate_hz, num_channels, max_queued_frames));
+}
+
+RTCWavFileSinkImpl::RTCWavFileSinkImpl(
+    std::unique_ptr<webrtc::WavWriter> writer, int sample_rate_hz,
+    size_t num_channels, size_t max_queued_frames)
+    : sample_rate_hz_(sample_rate_hz),
+      num_channels_(num_channels),
+      max_queued_frames_(max_queued_frames),
+      writer_(std::move(writer)) {
+  thread_ = rtc::PlatformThread::SpawnJoinable([this] { WriteLoop(); },
+                                               "wav_file_writer");
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": ctor ";
+}
+
+RTCWavFileSinkImpl::~RTCWavFileSinkImpl() {
+  Close();
+  RTC_LOG(LS_INFO) << __FUNCTION__ << ": dtor ";
+}
+
+void RTCWavFileSinkImpl::OnData(scoped_refptr<RTCAudioFrame> frame) {
+  if (frame->sample_rate_hz() != sample_rate_hz_ ||
+      frame->num_channels() != num_channels_) {
+    ++frames_dropped_;
+    return;
+  }
+  const size_t length = frame->samples_per_channel() * num_channels_;
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (closing_ || queue_.size() >= max_queued_frames_) {
+      ++frames_dropped_;
+      return;
+    }
+    std::vector<int16_t> buffer;
+    if (!free_buffers_.empty()) {
+      buffer = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+    }
+    buffer.assign(frame->data(), frame->data() + length);
+    queue_.push_back(std::move(buffer));
+  }
+  wake_.Set();
+}
+
+void RTCWavFileSinkImpl::Close() {
+  {
+    webrtc::MutexLock lock(&mutex_);
+    if (closing_) {
+      return;
+    }
+    closing_ = true;
+  }
+  wake_.Set();
+  thread_.Finalize();
+  // Patches the header with the final sizes.
+  writer_.reset();
+}
+
+void RTCWavFileSinkImpl::WriteLoop() {
+  std::deque<std::vector<int16_t>> batch;
+  while (true) {
+    wake_.Wait(rtc::Event::kForever);
+    bool closing;
+    {
+      webrtc::MutexLock lock(&mutex_);
+      // Hand written buffers back for reuse.
+      for (auto& buffer : batch) {
+        free_buffers_.push_back(std::move(buffer));
+      }
+      batch.clear();
+      batch.swap(queue_);
+      closing = closing_;
+    }
+    for (const auto& buffer : batch) {
+      writer_->WriteSamples(buffer.data(), buffer.size());
+    }
+    frames_written_ += batch.size();
+    if (closing) {
+      // Frames queued after |closing_| was set are refused, so |batch| held
+      // the last of them.
+      return;
+    }
+  }
+}
+
+}  // namespace libwebrtc
@@ -0,0 +1,62 @@
+#ifndef LIB_WEBRTC_WAV_FILE_SINK_IMPL_HXX
+#define LIB_WEBRTC_WAV_FILE_SINK_IMPL_HXX
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "common_audio/wav_file.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_wav_file_sink.h"
+
+namespace libwebrtc {
+
+class RTCWavFileSinkImpl : public RTCWavFileSink {
+ public:
+  RTCWavFileSinkImpl(std::unique_ptr<webrtc::WavWriter> writer,
+                     int sample_rate_hz, size_t num_channels,
+                     size_t max_queued_frames);
+
+  void OnData(scoped_refptr<RTCAudioFrame> frame) override;
+
+  void Close() override;
+
+  int sample_rate_hz() const override { return sample_rate_hz_; }
+
+  size_t num_channels() const override { return num_channels_; }
+
+  uint64_t frames_written() const override { return frames_written_; }
+
+  uint64_t frames_dropped() const override { return frames_dropped_; }
+
+ protected:
+  ~RTCWavFileSinkImpl() override;
+
+ private:
+  // Body of the writer thread.
+  void WriteLoop();
+
+  const int sample_rate_hz_;
+  const size_t num_channels_;
+  const size_t max_queued_frames_;
+  std::unique_ptr<webrtc::WavWriter> writer_;
+
+  webrtc::Mutex mutex_;
+  std::deque<std::vector<int16_t>> queue_ RTC_GUARDED_BY(mutex_);
+  // Buffers returned by the writer, reused so the audio thread does not
+  // allocate.
+  std::vector<std::vector<int16_t>> free_buffers_ RTC_GUARDED_BY(mutex_);
+  bool closing_ RTC_GUARDED_BY(mutex_) = false;
+  rtc::Event wake_;
+
+  std::atomic<uint64_t> frames_written_{0};
+  std::atomic<uint64_t> frames_dropped_{0};
+  rtc::PlatformThread thread_;
+};
+
+}  // namespace libwebrtc
+
+#endif  // LIB_WEBRTC_WAV_FILE_SINK_IMPL_HXX
@@ -0,0 +1,425 @@
+// Loopback test of RTCVideoRelay: one publisher sends encoded VP8 to a relay
+// connection, whose relay fans it out to 1 to 50 subscriber connections in
+// the same process. Checks that every subscriber gets the stream and that
+// each one, including a late joiner, starts with a key frame.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/refcountedobject.h"
+#include "libwebrtc.h"
+#include "rtc_frame_transformer.h"
+#include "rtc_peerconnection.h"
+#include "rtc_peerconnection_factory.h"
+#include "rtc_rtp_receiver.h"
+#include "rtc_rtp_transceiver.h"
+#include "rtc_video_relay.h"
+
+using namespace libwebrtc;
+
+namespace {
+
+const int kTimeoutMs = 10000;
+const int kWidth = 320;
+const int kHeight = 240;
+const int kFrameIntervalMs = 33;
+const size_t kFrameSize = 1000;
+
+int g_failures = 0;
+
+#define EXPECT(condition)                                              \
+  do {                                                                 \
+    if (!(condition)) {                                                \
+      std::fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, \
+                   #condition);                                        \
+      ++g_failures;                                                    \
+    }                                                                  \
+  } while (0)
+
+class Event {
+ public:
+  void Set() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_ = true;
+    cv_.notify_all();
+  }
+
+  bool Wait(int timeout_ms = kTimeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                        [this] { return set_; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool set_ = false;
+};
+
+// Polls |condition| until it holds or |timeout_ms| passed.
+template <typename Condition>
+bool WaitFor(Condition condition, int timeout_ms = kTimeoutMs) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+// Minimal VP8 framing (RFC 6386, section 9.1), enough for the packetizer,
+// the depacketizer and the null decoder.
+std::vector<uint8_t> MakeVp8Frame(bool key_frame) {
+  std::vector<uint8_t> frame(kFrameSize, 0);
+  if (key_frame) {
+    // Frame tag with show_frame set, start code, 14 bit width and height.
+    const uint8_t header[] = {0x10, 0x00, 0x00, 0x9d, 0x01, 0x2a,
+                              kWidth & 0xff, (kWidth >> 8) & 0x3f,
+                              kHeight & 0xff, (kHeight >> 8) & 0x3f};
+    std::copy(std::begin(header), std::end(header), frame.begin());
+  } else {
+    frame[0] = 0x11;
+  }
+  return frame;
+}
+
+// Records the frames a subscriber receives before they are decoded.
+class FrameCounter : public RTCFrameTransformer {
+ public:
+  bool OnFrame(scoped_refptr<RTCEncodedFrame> frame) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frames_ == 0) {
+      first_is_key_frame_ = frame->is_key_frame();
+    }
+    ++frames_;
+    return true;
+  }
+
+  int frames() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_;
+  }
+
+  bool first_is_key_frame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return first_is_key_frame_;
+  }
+
+ private:
+  std::mutex mutex_;
+  int frames_ = 0;
+  bool first_is_key_frame_ = false;
+};
+
+class Peer : public RTCPeerConnectionObserver {
+ public:
+  explicit Peer(scoped_refptr<RTCPeerConnectionFactory> factory)
+      : factory_(factory) {
+    RTCConfiguration config;
+    config.offer_to_receive_audio = false;
+    config.offer_to_receive_video = false;
+    pc_ = factory_->Create(config, RTCMediaConstraints::Create());
+    pc_->RegisterRTCPeerConnectionObserver(this);
+  }
+
+  ~Peer() {
+    pc_->DeRegisterRTCPeerConnectionObserver();
+    pc_->Close();
+    factory_->Delete(pc_);
+  }
+
+  scoped_refptr<RTCPeerConnection> pc() { return pc_; }
+
+  // Creates and applies the local offer or answer, waits for ICE gathering
+  // and returns the description with all candidates.
+  bool CreateLocalDescription(bool offer, std::string* sdp,
+                              std::string* type) {
+    Event created;
+    bool ok = false;
+    std::string created_sdp;
+    std::string created_type;
+    auto success = [&](const string sdp, const string type) {
+      created_sdp = sdp.std_string();
+      created_type = type.std_string();
+      ok = true;
+      created.Set();
+    };
+    auto failure = [&](const char* error) {
+      std::fprintf(stderr, "create description: %s\n", error);
+      created.Set();
+    };
+    if (offer) {
+      pc_->CreateOffer(success, failure, RTCMediaConstraints::Create());
+    } else {
+      pc_->CreateAnswer(success, failure, RTCMediaConstraints::Create());
+    }
+    if (!created.Wait() || !ok || !Apply(true, created_sdp, created_type) ||
+        !gathered_.Wait()) {
+      return false;
+    }
+    Event got;
+    ok = false;
+    pc_->GetLocalDescription(
+        [&](const char* sdp_out, const char* type_out) {
+          *sdp = sdp_out;
+          *type = type_out;
+          ok = true;
+          got.Set();
+        },
+        [&](const char* error) { got.Set(); });
+    return got.Wait() && ok;
+  }
+
+  bool Apply(bool local, const std::string& sdp, const std::string& type) {
+    Event applied;
+    bool ok = false;
+    auto success = [&] {
+      ok = true;
+      applied.Set();
+    };
+    auto failure = [&](const char* error) {
+      std::fprintf(stderr, "set description: %s\n", error);
+      applied.Set();
+    };
+    if (local) {
+      pc_->SetLocalDescription(sdp, type, success, failure);
+    } else {
+      pc_->SetRemoteDescription(sdp, type, success, failure);
+    }
+    return applied.Wait() && ok;
+  }
+
+  bool WaitConnected() { return connected_.Wait(); }
+
+  void OnSignalingState(RTCSignalingState state) override {}
+
+  void OnPeerConnectionState(RTCPeerConnectionState state) override {
+    if (state == RTCPeerConnectionStateConnected) {
+      connected_.Set();
+    }
+  }
+
+  void OnIceGatheringState(RTCIceGatheringState state) override {
+    if (state == RTCIceGatheringStateComplete) {
+      gathered_.Set();
+    }
+  }
+
+  void OnIceConnectionState(RTCIceConnectionState state) override {}
+
+  void OnIceCandidate(scoped_refptr<RTCIceCandidate> candidate) override {}
+
+  void OnAddStream(scoped_refptr<RTCMediaStream> stream) override {}
+
+  void OnRemoveStream(scoped_refptr<RTCMediaStream> stream) override {}
+
+  void OnDataChannel(scoped_refptr<RTCDataChannel> data_channel) override {}
+
+  void OnRenegotiationNeeded() override {}
+
+  void OnTrack(scoped_refptr<RTCRtpTransceiver> transceiver) override {}
+
+  void OnAddTrack(vector<scoped_refptr<RTCMediaStream>> streams,
+                  scoped_refptr<RTCRtpReceiver> receiver) override {}
+
+  void OnRemoveTrack(scoped_refptr<RTCRtpReceiver> receiver) override {}
+
+ private:
+  scoped_refptr<RTCPeerConnectionFactory> factory_;
+  scoped_refptr<RTCPeerConnection> pc_;
+  Event gathered_;
+  Event connected_;
+};
+
+// Non-trickle offer/answer between two peers. |on_offer| runs on the
+// answerer once the offer is applied, before the answer is created.
+template <typename OnOffer>
+bool Connect(Peer* offerer, Peer* answerer, OnOffer on_offer) {
+  std::string sdp;
+  std::string type;
+  if (!offerer->CreateLocalDescription(true, &sdp, &type) ||
+      !answerer->Apply(false, sdp, type)) {
+    return false;
+  }
+  on_offer();
+  return answerer->CreateLocalDescription(false, &sdp, &type) &&
+         offerer->Apply(false, sdp, type) && offerer->WaitConnected() &&
+         answerer->WaitConnected();
+}
+
+// Pushes VP8 in real time, with a key frame first and whenever one is
+// requested.
+class Publisher : public RTCEncodedVideoSourceObserver {
+ public:
+  explicit Publisher(scoped_refptr<RTCEncodedVideoSource> source)
+      : source_(source) {
+    source_->SetObserver(this);
+    thread_ = std::thread([this] {
+      while (running_) {
+        const bool key_frame = key_frame_requested_.exchange(false);
+        std::vector<uint8_t> frame = MakeVp8Frame(key_frame);
+        source_->PushFrame(frame.data(), frame.size(), key_frame, kWidth,
+                           kHeight);
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kFrameIntervalMs));
+      }
+    });
+  }
+
+  ~Publisher() {
+    running_ = false;
+    thread_.join();
+    source_->SetObserver(nullptr);
+  }
+
+  void OnKeyFrameRequested() override { key_frame_requested_ = true; }
+
+ private:
+  scoped_refptr<RTCEncodedVideoSource> source_;
+  std::atomic<bool> running_{true};
+  std::atomic<bool> key_frame_requested_{true};
+  std::thread thread_;
+};
+
+struct Subscriber {
+  std::unique_ptr<Peer> sender_side;
+  std::unique_ptr<Peer> receiver_side;
+  scoped_refptr<RTCRtpSender> sender;
+  scoped_refptr<FrameCounter> counter;
+};
+
+std::unique_ptr<Subscriber> AddSubscriber(
+    scoped_refptr<RTCPeerConnectionFactory> factory,
+    scoped_refptr<RTCVideoRelay> relay) {
+  std::unique_ptr<Subscriber> subscriber(new Subscriber());
+  subscriber->sender_side.reset(new Peer(factory));
+  subscriber->receiver_side.reset(new Peer(factory));
+  subscriber->counter = new RefCountedObject<FrameCounter>();
+  scoped_refptr<RTCRtpTransceiver> transceiver =
+      subscriber->sender_side->pc()->AddTransceiver(
+          RTCMediaType::VIDEO,
+          RTCRtpTransceiverInit::Create(RTCRtpTransceiverDirection::kSendOnly,
+                                        vector<string>(),
+                                        vector<scoped_refptr<
+                                            RTCRtpEncodingParameters>>()));
+  subscriber->sender = transceiver->sender();
+  EXPECT(relay->AddSender(subscriber->sender));
+  Peer* receiver_side = subscriber->receiver_side.get();
+  scoped_refptr<FrameCounter> counter = subscriber->counter;
+  EXPECT(Connect(subscriber->sender_side.get(), receiver_side, [&] {
+    std::vector<scoped_refptr<RTCRtpReceiver>> receivers =
+        receiver_side->pc()->receivers().std_vector();
+    EXPECT(receivers.size() == 1);
+    if (!receivers.empty()) {
+      receivers[0]->SetFrameTransformer(counter);
+    }
+  }));
+  return subscriber;
+}
+
+void TestFanOut(scoped_refptr<RTCPeerConnectionFactory> factory,
+                size_t num_subscribers) {
+  std::printf("fan-out to %zu subscribers\n", num_subscribers);
+
+  scoped_refptr<RTCEncodedVideoSource> source =
+      factory->CreateEncodedVideoSource(RTCVideoCodecType::kVP8, "publisher");
+  EXPECT(source.get() != nullptr);
+  if (!source) {
+    return;
+  }
+  Peer upstream(factory);
+  Peer relay_side(factory);
+  upstream.pc()->AddTransceiver(
+      factory->CreateVideoTrack(source->video_source(), "video"),
+      RTCRtpTransceiverInit::Create(
+          RTCRtpTransceiverDirection::kSendOnly, vector<string>(),
+          vector<scoped_refptr<RTCRtpEncodingParameters>>()));
+  std::unique_ptr<Publisher> publisher(new Publisher(source));
+  EXPECT(Connect(&upstream, &relay_side, [] {}));
+
+  std::vector<scoped_refptr<RTCRtpReceiver>> receivers =
+      relay_side.pc()->receivers().std_vector();
+  EXPECT(receivers.size() == 1);
+  if (receivers.empty()) {
+    return;
+  }
+  // Every request goes upstream, so that each join can be seen below.
+  scoped_refptr<RTCVideoRelay> relay = factory->CreateVideoRelay(
+      receivers[0], RTCVideoCodecType::kVP8,
+      /*min_key_frame_request_interval_ms=*/0);
+  EXPECT(relay.get() != nullptr);
+  if (!relay) {
+    return;
+  }
+  EXPECT(WaitFor([&] { return relay->frames_received() > 0; }));
+
+  std::vector<std::unique_ptr<Subscriber>> subscribers;
+  for (size_t i = 0; i < num_subscribers; ++i) {
+    subscribers.push_back(AddSubscriber(factory, relay));
+  }
+  EXPECT(relay->num_senders() == num_subscribers);
+
+  // Fan-out: every subscriber receives the stream, from a key frame on.
+  for (const auto& subscriber : subscribers) {
+    FrameCounter* counter = subscriber->counter.get();
+    EXPECT(WaitFor([counter] { return counter->frames() > 10; }));
+    EXPECT(counter->first_is_key_frame());
+  }
+
+  // Key frame join: a subscriber added mid-stream also starts with a key
+  // frame, the relay asks upstream for a fresh one, and the deltas that
+  // follow it are forwarded.
+  const uint64_t requests = relay->key_frame_requests();
+  subscribers.push_back(AddSubscriber(factory, relay));
+  EXPECT(relay->key_frame_requests() > requests);
+  EXPECT(relay->num_senders() == num_subscribers + 1);
+  FrameCounter* late = subscribers.back()->counter.get();
+  EXPECT(WaitFor([late] { return late->frames() > 10; }));
+  EXPECT(late->first_is_key_frame());
+
+  for (const auto& subscriber : subscribers) {
+    relay->RemoveSender(subscriber->sender);
+  }
+  EXPECT(relay->num_senders() == 0);
+  subscribers.clear();
+  publisher.reset();
+}
+
+}  // namespace
+
+int main() {
+  LibWebRTC::Initialize();
+  {
+    RTCPeerConnectionFactoryOptions options;
+    options.audio_device = RTCAudioDeviceType::kVirtual;
+    options.video_decoder_factory = RTCVideoDecoderFactory::CreateNull();
+    scoped_refptr<RTCPeerConnectionFactory> factory =
+        LibWebRTC::CreateRTCPeerConnectionFactory(options);
+
+    for (size_t num_subscribers : {1, 2, 10, 50}) {
+      TestFanOut(factory, num_subscribers);
+    }
+
+    factory->Terminate();
+  }
+  LibWebRTC::Terminate();
+
+  if (g_failures) {
+    std::fprintf(stderr, "%d expectation(s) failed\n", g_failures);
+    return 1;
+  }
+  std::printf("passed\n");
+  return 0;
+}